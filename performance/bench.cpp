@@ -0,0 +1,527 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <main.h>
+#include <FS.h>
+#include <Task.h>
+#include <Timer.h>
+#include <text.h>
+
+// Runs a matrix of commands against synthetic data of several sizes, with the
+// task binary under test, and prints each command's "Perf" line with its peak
+// RSS appended, in the form compare_runs.py reads.
+//
+// Usage: bench [--task <binary>] [--dir <directory>] [size ...]
+//
+// Sizes are task counts, and may be written as 1k or 1M.  The data for a size
+// is the same on every run, apart from dates, which are relative to the day
+// the benchmark is run.
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// A fixed seed makes the data reproducible, and the first tasks of a larger
+// data set the same as those of a smaller one.
+static uint64_t randomState;
+
+static unsigned int pick (unsigned int range)
+{
+  // xorshift64*
+  randomState ^= randomState >> 12;
+  randomState ^= randomState << 25;
+  randomState ^= randomState >> 27;
+  return (unsigned int) ((randomState * 2685821657736338717ULL) >> 33) % range;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string randomUUID ()
+{
+  char id[64];
+  snprintf (id, sizeof (id), "%08x-%04x-4%03x-%04x-%04x%08x",
+            pick (0xFFFFFFFF), pick (0x10000), pick (0x1000),
+            0x8000 | pick (0x4000), pick (0x10000), pick (0xFFFFFFFF));
+  return id;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static const std::vector <std::string> words =
+{
+  "alpha", "review", "draft", "call", "email", "fix", "plan", "order",
+  "release", "meeting", "report", "budget", "garden", "invoice", "backup",
+  "renew", "schedule", "update", "clean", "repair", "write", "read", "book",
+  "ticket", "design", "test", "deploy", "migrate", "refactor", "document"
+};
+
+static std::string randomText (unsigned int minimum, unsigned int maximum)
+{
+  std::string text;
+  unsigned int count = minimum + pick (maximum - minimum + 1);
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (i)
+      text += ' ';
+    text += words[pick (words.size ())];
+  }
+
+  return text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string epoch (time_t t)
+{
+  return format ((int) t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The attributes every kind of task has.
+static Task randomTask (time_t today)
+{
+  Task task;
+  task.set ("uuid", randomUUID ());
+  task.set ("description", randomText (2, 8));
+
+  time_t entry = today - 86400 * (1 + pick (730)) + pick (86400);
+  task.set ("entry", epoch (entry));
+  task.set ("modified", epoch (entry));
+
+  unsigned int project = pick (40);
+  if (project < 30)
+    task.set ("project", "Project" + format ((int) project) +
+                         (pick (3) == 0 ? ".Sub" + format ((int) pick (5)) : ""));
+
+  std::string tags;
+  for (unsigned int i = pick (4); i > 0; --i)
+    tags += (tags == "" ? "" : ",") + std::string ("tag") + format ((int) pick (20));
+  if (tags != "")
+    task.set ("tags", tags);
+
+  unsigned int priority = pick (6);
+  if (priority < 3)
+    task.set ("priority", std::string (1, "HML"[priority]));
+
+  if (pick (10) < 4)
+    task.set ("due", epoch (today + 86400 * ((int) pick (90) - 30)));
+
+  if (pick (10) < 3)
+    task.set ("estimate", format ((int) (1 + pick (40))));
+
+  if (pick (10) < 2)
+    task.set ("client", "Client" + format ((int) pick (12)));
+
+  if (pick (10) < 2)
+  {
+    std::map <std::string, std::string> annotations;
+    for (unsigned int i = 1 + pick (2); i > 0; --i)
+      annotations["annotation_" + epoch (entry + 3600 * i)] = randomText (3, 10);
+    task.setAnnotations (annotations);
+  }
+
+  return task;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes pending.data, completed.data, undo.data and backlog.data for 'count'
+// tasks, and two files to import: new tasks, and a sync-like merge of changed
+// and new tasks.
+static void generate (const std::string& dir, unsigned int count, time_t today)
+{
+  randomState = 88172645463325252ULL;
+
+  std::vector <Task> pending;
+  std::vector <Task> completed;
+
+  unsigned int i = 0;
+  while (i < count)
+  {
+    // One recurring weekly task, with four instances, in every 500.
+    if (i % 500 == 499 && i + 5 <= count)
+    {
+      Task parent = randomTask (today);
+      parent.setStatus (Task::recurring);
+      parent.set ("recur", "weekly");
+      parent.set ("due", epoch (today - 21 * 86400));
+      parent.set ("mask", "----");
+      pending.push_back (parent);
+
+      for (unsigned int instance = 0; instance < 4; ++instance)
+      {
+        Task child (parent);
+        child.setStatus (Task::pending);
+        child.set ("uuid", randomUUID ());
+        child.set ("parent", parent.get ("uuid"));
+        child.set ("imask", format ((int) instance));
+        child.set ("due", epoch (today + (instance * 7 - 21) * 86400));
+        child.remove ("mask");
+        pending.push_back (child);
+      }
+
+      i += 5;
+      continue;
+    }
+
+    Task task = randomTask (today);
+    unsigned int kind = i % 20;
+    if (kind < 6)
+    {
+      task.setStatus (Task::pending);
+
+      if (kind == 5)
+      {
+        task.setStatus (Task::waiting);
+        task.set ("wait", epoch (today + 86400 * (1 + pick (30))));
+      }
+      else if (pick (30) == 0)
+        task.set ("start", epoch (today - pick (86400)));
+      else if (pick (20) == 0)
+        task.set ("scheduled", epoch (today + 86400 * pick (14)));
+
+      // Dependencies on earlier pending tasks.
+      if (pending.size () > 10 && pick (10) == 0)
+      {
+        std::string depends = pending[pick (pending.size ())].get ("uuid");
+        if (pick (2))
+          depends += "," + pending[pick (pending.size ())].get ("uuid");
+        task.set ("depends", depends);
+      }
+
+      pending.push_back (task);
+    }
+    else
+    {
+      task.setStatus (kind == 19 ? Task::deleted : Task::completed);
+      time_t end = task.get_date ("entry") + pick (30 * 86400);
+      task.set ("end", epoch (std::min (end, today)));
+      task.set ("modified", task.get ("end"));
+      completed.push_back (task);
+    }
+
+    ++i;
+  }
+
+  std::ofstream out ((dir + "/pending.data").c_str ());
+  for (auto& task : pending)
+    out << task.composeF4 () << "\n";
+  out.close ();
+
+  out.open ((dir + "/completed.data").c_str ());
+  for (auto& task : completed)
+    out << task.composeF4 () << "\n";
+  out.close ();
+
+  // The most recent additions, which 'undo' can revert.
+  std::ofstream undo ((dir + "/undo.data").c_str ());
+  std::ofstream backlog ((dir + "/backlog.data").c_str ());
+  unsigned int recent = std::min ((unsigned int) pending.size (), 100u);
+  for (unsigned int r = pending.size () - recent; r < pending.size (); ++r)
+  {
+    undo << "time " << pending[r].get ("entry") << "\n"
+         << "new " << pending[r].composeF4 () << "\n"
+         << "---\n";
+    backlog << pending[r].composeJSON () << "\n";
+  }
+  undo.close ();
+  backlog.close ();
+
+  out.open ((dir + "/import.json").c_str ());
+  for (unsigned int n = 0; n < 1000; ++n)
+  {
+    Task task = randomTask (today);
+    task.setStatus (Task::pending);
+    out << task.composeJSON () << "\n";
+  }
+  out.close ();
+
+  // Half of the merge changes existing tasks, as a sync download would.
+  out.open ((dir + "/merge.json").c_str ());
+  for (unsigned int n = 0; n < 1000; ++n)
+  {
+    Task task = randomTask (today);
+    task.setStatus (Task::pending);
+    if (n % 2 == 0 && pending.size ())
+    {
+      auto& existing = pending[pick (pending.size ())];
+      if (existing.getStatus () == Task::pending && ! existing.has ("parent"))
+      {
+        task = existing;
+        task.set ("description", existing.get ("description") + " " + randomText (1, 3));
+        task.set ("modified", epoch (today));
+      }
+    }
+    out << task.composeJSON () << "\n";
+  }
+  out.close ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void copyData (const std::string& from, const std::string& to)
+{
+  for (auto& name : {"pending.data", "completed.data", "undo.data", "backlog.data"})
+  {
+    std::ifstream in ((from + "/" + name).c_str (), std::ios::binary);
+    std::ofstream out ((to + "/" + name).c_str (), std::ios::binary | std::ios::trunc);
+    out << in.rdbuf ();
+  }
+
+  // Recurrence leaves a watermark, and perhaps its temporary files, which would
+  // let the measured run skip the scan that the warm-up run made.
+  for (auto& path : Directory (to).list ())
+    if (Path (path).name ().compare (0, 15, "recurrence.data") == 0)
+      File::remove (path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Runs the task binary with stdout discarded, and returns its "Perf" line and
+// peak RSS in KiB.
+static bool run (
+  const std::string& task,
+  const std::vector <std::string>& args,
+  std::string& perf,
+  long& rss)
+{
+  int channel[2];
+  if (pipe (channel) == -1)
+    return false;
+
+  pid_t pid = fork ();
+  if (pid == -1)
+    return false;
+
+  if (pid == 0)
+  {
+    int null = open ("/dev/null", O_RDWR);
+    dup2 (null, 0);
+    dup2 (null, 1);
+    dup2 (channel[1], 2);
+    close (channel[0]);
+
+    std::vector <char*> argv;
+    argv.push_back ((char*) task.c_str ());
+    for (auto& arg : args)
+      argv.push_back ((char*) arg.c_str ());
+    argv.push_back (NULL);
+
+    execv (task.c_str (), &argv[0]);
+    _exit (127);
+  }
+
+  close (channel[1]);
+  std::string output;
+  char buffer[16384];
+  ssize_t got;
+  while ((got = read (channel[0], buffer, sizeof (buffer))) > 0)
+    output.append (buffer, got);
+  close (channel[0]);
+
+  int status;
+  struct rusage usage;
+  if (wait4 (pid, &status, 0, &usage) == -1)
+    return false;
+
+#ifdef DARWIN
+  rss = usage.ru_maxrss / 1024;
+#else
+  rss = usage.ru_maxrss;
+#endif
+
+  std::stringstream lines (output);
+  std::string line;
+  while (std::getline (lines, line))
+    if (line.compare (0, 10, "Perf task ") == 0)
+      perf = line;
+
+  return perf != "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+struct Benchmark
+{
+  std::string              name;
+  std::vector <std::string> args;
+};
+
+static std::vector <Benchmark> matrix (const std::string& dir)
+{
+  return
+  {
+    // Reports.
+    {"next",              {"next"}},
+    {"list",              {"list"}},
+    {"all",               {"all"}},
+    {"summary",           {"summary"}},
+    {"projects",          {"projects"}},
+    {"tags",              {"tags"}},
+    {"burndown",          {"burndown.weekly"}},
+    {"count",             {"count"}},
+
+    // Filters, counted so that rendering is not measured.
+    {"filter.project",    {"project:Project7", "count"}},
+    {"filter.tag",        {"+tag3", "-tag4", "count"}},
+    {"filter.due",        {"due.before:eow", "count"}},
+    {"filter.search",     {"/release/", "count"}},
+    {"filter.expression", {"(", "priority:H", "or", "urgency", ">", "5", ")", "count"}},
+    {"filter.id",         {"1-100", "count"}},
+
+    // Changes.
+    {"add",               {"add", "Benchmark", "task", "project:Bench", "+bench", "due:tomorrow"}},
+    {"modify",            {"1", "modify", "priority:H", "+bench"}},
+    {"done",              {"2", "done"}},
+    {"undo",              {"undo"}},
+
+    // Interchange.
+    {"export",            {"export"}},
+    {"import",            {"import", dir + "/import.json"}},
+    {"merge",             {"import", dir + "/merge.json"}}
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static unsigned int parseSize (const std::string& arg)
+{
+  unsigned int size = strtoul (arg.c_str (), NULL, 10);
+  char unit = arg.back ();
+  if (unit == 'k' || unit == 'K')
+    size *= 1000;
+  else if (unit == 'm' || unit == 'M')
+    size *= 1000000;
+
+  return size;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  std::string task = "../src/task";
+  std::string base = "bench.data";
+  std::vector <unsigned int> sizes;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string arg = argv[i];
+    if (arg == "--task" && i + 1 < argc)
+      task = argv[++i];
+    else if (arg == "--dir" && i + 1 < argc)
+      base = argv[++i];
+    else if (parseSize (arg))
+      sizes.push_back (parseSize (arg));
+    else
+    {
+      std::cerr << "Usage: bench [--task <binary>] [--dir <directory>] [size ...]\n";
+      return 1;
+    }
+  }
+
+  if (! sizes.size ())
+    sizes = {1000, 10000, 100000};
+
+  if (! File (task).exists ())
+  {
+    std::cerr << "Cannot find the task binary '" << task << "'.\n";
+    return 1;
+  }
+
+  // As Context registers them, for composeF4 and composeJSON.
+  for (auto& date : {"due", "end", "entry", "modified", "scheduled", "start", "until", "wait"})
+    Task::attributes[date] = "date";
+  Task::attributes["estimate"] = "numeric";
+
+  // Midnight UTC of the day the benchmark is run.
+  time_t today = time (NULL);
+  today -= today % 86400;
+
+  Directory (base).create ();
+  base = Path (base)._data;
+
+  for (auto size : sizes)
+  {
+    std::string dir  = base + "/" + format ((int) size);
+    std::string data = dir + "/data";
+    std::string rc   = dir + "/bench.rc";
+    Directory (dir).remove ();
+    Directory (dir).create ();
+    Directory (data).create ();
+
+    std::cout << "Performance: setup " << size << " tasks\n";
+    unsigned long start = Timer::now ();
+    generate (dir, size, today);
+    std::cout << "  - generated in " << (Timer::now () - start) / 1000 << " ms\n";
+
+    File::write (rc, "data.location=" + data + "\n"
+                     "color=on\n"
+                     "_forcecolor=on\n"
+                     "verbose=label\n"
+                     "hooks=off\n"
+                     "confirmation=off\n"
+                     "bulk=0\n"
+                     "color.debug=\n"
+                     "uda.estimate.type=numeric\n"
+                     "uda.estimate.label=Est\n"
+                     "uda.client.type=string\n"
+                     "uda.client.label=Client\n");
+
+    std::cout << "Performance: benchmarks\n";
+    for (auto& benchmark : matrix (dir))
+    {
+      std::vector <std::string> args {"rc:" + rc, "rc.debug:1"};
+      args.insert (args.end (), benchmark.args.begin (), benchmark.args.end ());
+
+      // Once to warm the caches, then again from the same data to measure.
+      std::string perf;
+      long rss = 0;
+      copyData (dir, data);
+      run (task, args, perf, rss);
+
+      perf = "";
+      copyData (dir, data);
+      std::cout << "  - task " << benchmark.name << "@" << size << "...\n";
+      if (run (task, args, perf, rss))
+        std::cout << perf << " rss:" << rss << "\n";
+      else
+        std::cout << "  - failed\n";
+    }
+  }
+
+  std::cout << "End\n";
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <unistd.h>
+#include <main.h>
+#include <CLI2.h>
+#include <Timer.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// A filter of the kind generated report definitions carry: alternatives over
+// projects and tags, attribute modifiers, dates, IDs and a pattern, repeated
+// until it has the requested number of terms.
+static std::vector <std::string> filter (int terms)
+{
+  static const std::vector <std::string> pieces =
+  {
+    "project:Work.Planning",
+    "+review",
+    "due.before:eow",
+    "priority:H",
+    "description.contains:report",
+    "-WAITING",
+    "scheduled.after:now-2wks",
+    "tags.hasnt:someday",
+    "urgency.over:4.5",
+    "/budget/",
+    "status:pending",
+    "entry.after:2016-01-01"
+  };
+
+  std::vector <std::string> words {"task", "("};
+  for (int i = 0; i < terms; ++i)
+  {
+    if (i)
+      words.push_back (i % 5 ? "or" : "and");
+
+    words.push_back (pieces[i % pieces.size ()]);
+  }
+
+  words.push_back (")");
+  words.push_back ("1-3,5");
+  words.push_back ("list");
+  return words;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Analysis and filter preparation, as Context and Filter run them for every
+// command.
+static unsigned long measure (const std::vector <std::string>& words, int count)
+{
+  unsigned long start = Timer::now ();
+  for (int i = 0; i < count; ++i)
+  {
+    CLI2 cli;
+    cli._entities = context.cli2._entities;
+    for (auto& word : words)
+      cli.add (word);
+
+    cli.analyze ();
+    cli.prepareFilter ();
+  }
+
+  return Timer::now () - start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  int count = argc > 1 ? strtol (argv[1], NULL, 10) : 200;
+
+  // An empty configuration and data directory, so that Context registers the
+  // commands, attributes, modifiers and operators as it does for 'task'.
+  char location[] = "/tmp/cli2.perf.XXXXXX";
+  if (! mkdtemp (location))
+    return 1;
+
+  std::string rc = std::string (location) + "/rc";
+  std::ofstream (rc) << "data.location=" << location << "\n"
+                     << "verbose=nothing\n";
+  setenv ("TASKRC", rc.c_str (), 1);
+
+  const char* args[] = {"task", "version"};
+  context.initialize (2, args);
+
+  for (int terms : {10, 50, 200})
+  {
+    auto words = filter (terms);
+    unsigned long total = measure (words, count);
+    std::cout << std::left << std::setw (16) << (std::to_string (terms) + " terms")
+              << std::right << std::setw (9) << total << " us"
+              << "  " << std::fixed << std::setprecision (1)
+              << (double) total / count << " us/parse\n";
+  }
+
+  unlink (rc.c_str ());
+  rmdir (location);
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
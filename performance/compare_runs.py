@@ -17,30 +17,26 @@ import collections
 import re
 import sys
 
-# Adjust if more performance tests are added
-COMMANDS = "next list all add export import".split()
-
 TaskPerf = collections.namedtuple("TaskPerf", "version commit at timing")
 
 
 def parse_perf(input):
-    tests = {}
-    for command in COMMANDS:
-        tests[command] = []
-
-        # Parse concatenated run_perf output
-        for i in re.findall("^  - task %s\.\.\.\n"
-                            "Perf task ([^ ]+) ([^ ]+) ([^ ]+) (.+)$"
-                            % command, input, re.MULTILINE):
-            info = i[0:3] + ({k:v for k, v in (i.split(":") for i in i[-1].split())},)
-            pt = TaskPerf(*info)
-            tests[command].append(pt)
+    # Commands in the order they first appear, from run_perf or bench output.
+    tests = collections.OrderedDict()
+    for i in re.findall("^  - task (.+?)\.\.\.\n"
+                        "Perf task ([^ ]+) ([^ ]+) ([^ ]+) (.+)$",
+                        input, re.MULTILINE):
+        info = i[1:4] + ({k:v for k, v in (i.split(":") for i in i[-1].split())},)
+        tests.setdefault(i[0], []).append(TaskPerf(*info))
     return tests
 
 
 def get_best(tests):
     best = {}
     for command in tests:
+        # Runs from older versions may not include every command.
+        if not tests[command]:
+            continue
         best[command] = {}
         for k in tests[command][0].timing:
             best[command][k] = str(min(int(t.timing[k]) for t in tests[command]))
@@ -52,6 +48,8 @@ if len(sys.argv) != 3:
     print(" $ %s file1 file2" % sys.argv[0])
     print("Where file1, file2 are generated as such:")
     print(" $ for i in `seq 20`; do ./run_perf >> filename 2>&1; done")
+    print("or, with the synthetic data sets of the benchmark target:")
+    print(" $ for i in `seq 5`; do ./bench 1k 10k >> filename; done")
     sys.exit(1)
 
 with open(sys.argv[1], "r") as fh:
@@ -61,14 +59,19 @@ with open(sys.argv[2], "r") as fh:
     tests_cur = parse_perf(fh.read())
     best_cur = get_best(tests_cur)
 
-print("Previous: %s (%s)" % (tests_prev[COMMANDS[0]][0].version, tests_prev[COMMANDS[0]][0].commit))
-print("Current:  %s (%s)" % (tests_cur[COMMANDS[0]][0].version, tests_cur[COMMANDS[0]][0].commit))
+first_prev = next(iter(tests_prev.values()))[0]
+first_cur = next(iter(tests_cur.values()))[0]
+print("Previous: %s (%s)" % (first_prev.version, first_prev.commit))
+print("Current:  %s (%s)" % (first_cur.version, first_cur.commit))
 
-for test in COMMANDS:
+for test in tests_cur:
+    if test not in best_prev or test not in best_cur:
+        continue
     print("# %s:" % test)
 
     out = ["" for i in range(5)]
-    for k in sorted(best_prev[test].keys()):
+    # Timings added or removed between the versions are not compared.
+    for k in sorted(set(best_prev[test]) & set(best_cur[test])):
         diff = str(int(best_cur[test][k]) - int(best_prev[test][k]))
 
         if float(best_prev[test][k]) > 0:
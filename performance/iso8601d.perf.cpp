@@ -0,0 +1,160 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <time.h>
+#include <main.h>
+#include <ISO8601.h>
+#include <Nibbler.h>
+#include <Timer.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// The general grammar path, as ISO8601d::parse took it for these forms before
+// the in-place fast path: a Nibbler over a copy of the input, then validation
+// and timegm.
+static bool reference_parse (const std::string& input, time_t& date)
+{
+  Nibbler n (input.substr (0));
+
+  int epoch;
+  if (n.getUnsignedInt (epoch) &&
+      n.depleted ()            &&
+      epoch >= 315532800)
+  {
+    date = static_cast <time_t> (epoch);
+    return true;
+  }
+
+  n = Nibbler (input.substr (0));
+  int year, month, day, hour, minute, second;
+  if (n.getDigit4 (year)   &&
+      n.getDigit2 (month)  && month &&
+      n.getDigit2 (day)    && day   &&
+      n.skip      ('T')    &&
+      n.getDigit2 (hour)   &&
+      n.getDigit2 (minute) && minute < 60 &&
+      n.getDigit2 (second) && second < 60 &&
+      n.skip      ('Z')    &&
+      n.depleted ()        &&
+      year >= 1900 && year <= 2200 &&
+      month <= 12 &&
+      day <= ISO8601d::daysInMonth (month, year))
+  {
+    struct tm t {};
+    t.tm_isdst = -1;
+    t.tm_year  = year - 1900;
+    t.tm_mon   = month - 1;
+    t.tm_mday  = day;
+    t.tm_hour  = hour;
+    t.tm_min   = minute;
+    t.tm_sec   = second;
+    date = timegm (&t);
+    return true;
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Timestamps as they appear in the data files and in JSON exports.
+static std::vector <std::string> corpus (int count, bool compact)
+{
+  std::vector <std::string> texts;
+  time_t base = 1451606400;  // 2016-01-01T00:00:00Z
+  for (int i = 0; i < count; ++i)
+  {
+    time_t when = base + (time_t) i * 977;
+    if (compact)
+    {
+      char buffer[32];
+      strftime (buffer, sizeof (buffer), "%Y%m%dT%H%M%SZ", gmtime (&when));
+      texts.push_back (buffer);
+    }
+    else
+      texts.push_back (std::to_string (when));
+  }
+
+  return texts;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void report (const std::string& name, unsigned long reference, unsigned long current, bool same)
+{
+  std::cout << std::left << std::setw (16) << name
+            << " reference " << std::right << std::setw (9) << reference << " us"
+            << "  current " << std::setw (9) << current << " us"
+            << "  speedup " << std::fixed << std::setprecision (2)
+            << (current ? (double) reference / current : 0.0) << "x"
+            << (same ? "" : "  MISMATCH")
+            << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool measure (const std::string& name, const std::vector <std::string>& texts)
+{
+  unsigned long start = Timer::now ();
+  long long expected = 0;
+  for (auto& text : texts)
+  {
+    time_t date = 0;
+    if (reference_parse (text, date))
+      expected += date;
+  }
+  unsigned long reference = Timer::now () - start;
+
+  start = Timer::now ();
+  long long actual = 0;
+  for (auto& text : texts)
+  {
+    ISO8601d iso ((time_t) 0);
+    std::string::size_type pos = 0;
+    if (iso.parse (text, pos) && pos == text.length ())
+      actual += iso.toEpoch ();
+  }
+  report (name, reference, Timer::now () - start, actual == expected);
+  return actual == expected;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  int count = argc > 1 ? strtol (argv[1], NULL, 10) : 200000;
+  bool ok = true;
+
+  ok &= measure ("epoch",   corpus (count, false));
+  ok &= measure ("compact", corpus (count, true));
+
+  return ok ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,187 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <main.h>
+#include <Lexer.h>
+#include <Timer.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// Command lines and report filters as they reach the lexer, one argument or
+// one filter at a time.
+static const std::vector <std::string> commandLines =
+{
+  "list",
+  "next",
+  "add Buy milk due:tomorrow +errand project:Home",
+  "add 'Call the plumber about the leak' priority:H due:eow",
+  "1-3,5 modify priority:M",
+  "12 done",
+  "8f2c1a3e-4b5d-4c6e-9f70-8192a3b4c5d6 modify +urgent",
+  "8f2c1a3e info",
+  "project:Work.Planning +meeting -waiting list",
+  "( due.before:eow or +OVERDUE ) and status:pending",
+  "( status:pending or status:waiting ) and ( +ACTIVE or urgency > 10 )",
+  "description ~ 'quarterly report' and entry.after:now-2wks",
+  "due < now + 3d and priority != L",
+  "rc.verbose:nothing rc.report.next.columns:id,due,description next",
+  "rc.dateformat:Y-M-D add Release notes due:2016-03-01T12:00:00",
+  "scheduled:2016-02-15 until:20160301T000000Z recur:weekly add Stand-up",
+  "wait:1456790400 add Renew passport",
+  "7 annotate http://example.com/issues/4321",
+  "9 modify /teh/the/g",
+  "/backup/ list",
+  "export /home/user/.task/pending.data",
+  "project:Home.Garden and tags.has:weekend",
+  "urgency.over:5 and ( depends.any: or +BLOCKED )",
+  "status:pending -tag1 -tag2 +tag3 limit:25",
+  "id:1,2,3,4 or uuid:6a2b3c4d",
+  "0x1f 3.14 -12 1e5 P1Y2M3DT4H5M6S 2wks 3days",
+  "_get 1.description",
+  "annotations.1.entry.year = 2016",
+  "due.month:3 and due.year:2016",
+  "modify description:\"Ship the release\" +release -- -notatag"
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The dispatch Lexer::token used before it consulted the first byte: every
+// recognizer, in order, on every token.  The corpus separates tokens with
+// single spaces, which isLiteral can step over from the outside.
+static bool reference_token (Lexer& lexer, std::string& token, Lexer::Type& type)
+{
+  while (lexer.isLiteral (" ", false, false))
+    ;
+
+  if (lexer.isEOS ())
+    return false;
+
+  return lexer.isString       (token, type, "'\"") ||
+         lexer.isDate         (token, type)        ||
+         lexer.isDuration     (token, type)        ||
+         lexer.isURL          (token, type)        ||
+         lexer.isPair         (token, type)        ||
+         lexer.isUUID         (token, type, true)  ||
+         lexer.isSet          (token, type)        ||
+         lexer.isDOM          (token, type)        ||
+         lexer.isHexNumber    (token, type)        ||
+         lexer.isNumber       (token, type)        ||
+         lexer.isSeparator    (token, type)        ||
+         lexer.isTag          (token, type)        ||
+         lexer.isPath         (token, type)        ||
+         lexer.isSubstitution (token, type)        ||
+         lexer.isPattern      (token, type)        ||
+         lexer.isOperator     (token, type)        ||
+         lexer.isIdentifier   (token, type)        ||
+         lexer.isWord         (token, type);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void report (const std::string& name, unsigned long reference, unsigned long current, bool same)
+{
+  std::cout << std::left << std::setw (16) << name
+            << " reference " << std::right << std::setw (9) << reference << " us"
+            << "  current " << std::setw (9) << current << " us"
+            << "  speedup " << std::fixed << std::setprecision (2)
+            << (current ? (double) reference / current : 0.0) << "x"
+            << (same ? "" : "  MISMATCH")
+            << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each line is lexed as a whole, as filters are, and word by word, as CLI2
+// lexes arguments.
+static bool measure (const std::string& name, const std::vector <std::string>& texts, int count)
+{
+  std::vector <std::string> expected;
+  std::string token;
+  Lexer::Type type;
+
+  unsigned long start = Timer::now ();
+  for (int i = 0; i < count; ++i)
+  {
+    for (auto& text : texts)
+    {
+      Lexer lexer (text);
+      while (reference_token (lexer, token, type))
+        if (i == 0)
+          expected.push_back (Lexer::typeToString (type) + " " + token);
+    }
+  }
+  unsigned long reference = Timer::now () - start;
+
+  std::vector <std::string> actual;
+  start = Timer::now ();
+  for (int i = 0; i < count; ++i)
+  {
+    for (auto& text : texts)
+    {
+      Lexer lexer (text);
+      while (lexer.token (token, type))
+        if (i == 0)
+          actual.push_back (Lexer::typeToString (type) + " " + token);
+    }
+  }
+
+  report (name, reference, Timer::now () - start, actual == expected);
+  return actual == expected;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  int count = argc > 1 ? strtol (argv[1], NULL, 10) : 2000;
+
+  // As Context configures the lexer by default.
+  Lexer::dateFormat = "m/d/Y";
+  for (auto& attribute : {"depends", "description", "due", "end", "entry",
+                          "id", "modified", "priority", "project", "recur",
+                          "scheduled", "start", "status", "tags", "until",
+                          "urgency", "uuid", "wait"})
+    Lexer::attributes[attribute] = "string";
+  for (auto& attribute : {"due", "end", "entry", "modified", "scheduled",
+                          "start", "until", "wait"})
+    Lexer::attributes[attribute] = "date";
+
+  std::vector <std::string> words;
+  for (auto& line : commandLines)
+    for (auto& word : Lexer::split (line))
+      words.push_back (word);
+
+  bool ok = true;
+  ok &= measure ("lines", commandLines, count);
+  ok &= measure ("arguments", words, count);
+
+  return ok ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,259 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include <main.h>
+#include <Color.h>
+#include <Timer.h>
+#include <text.h>
+#include <utf8.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// The codepoint-at-a-time implementations, as they were before the bulk ASCII
+// scan, for comparison.
+static unsigned int reference_utf8_length (const std::string& str)
+{
+  int byteLength = str.length ();
+  int charLength = byteLength;
+  const char* data = str.data ();
+  for (int i = 0; i < byteLength; i++)
+    if ((data[i] & 0xC0) == 0x80)
+      charLength--;
+
+  return charLength;
+}
+
+static unsigned int reference_utf8_width (const std::string& str)
+{
+  unsigned int length = 0;
+  std::string::size_type i = 0;
+  unsigned int c;
+  while ((c = utf8_next_char (str, i)))
+  {
+    int l = mk_wcwidth (c);
+    if (l != -1)
+      length += l;
+  }
+
+  return length;
+}
+
+static const std::string reference_utf8_substr (
+  const std::string& input,
+  unsigned int start,
+  unsigned int length)
+{
+  std::string::size_type index_start = 0;
+  for (unsigned int i = 0; i < start; i++)
+    utf8_next_char (input, index_start);
+
+  std::string::size_type index_end = index_start;
+  for (unsigned int i = 0; i < length; i++)
+    utf8_next_char (input, index_end);
+
+  return input.substr (index_start, index_end - index_start);
+}
+
+static int reference_longestWord (const std::string& input)
+{
+  int longest = 0;
+  int length = 0;
+  std::string::size_type i = 0;
+  int character;
+  while ((character = utf8_next_char (input, i)))
+  {
+    if (character == ' ')
+    {
+      if (length > longest)
+        longest = length;
+
+      length = 0;
+    }
+    else
+      length += mk_wcwidth (character);
+  }
+
+  if (length > longest)
+    longest = length;
+
+  return longest;
+}
+
+static std::string reference_strip (const std::string& input)
+{
+  int length = input.length ();
+  bool inside = false;
+  std::string output;
+  for (int i = 0; i < length; ++i)
+  {
+    if (inside)
+    {
+      if (input[i] == 'm')
+        inside = false;
+    }
+    else
+    {
+      if (input[i] == 033)
+        inside = true;
+      else
+        output += input[i];
+    }
+  }
+
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Descriptions typical of a task list: mostly ASCII, some accented or wide
+// text, some colorized.
+static std::vector <std::string> corpus (int count)
+{
+  static const char* samples[] =
+  {
+    "Call dentist",
+    "Review the quarterly budget with the finance team before Friday's meeting",
+    "Fix the login redirect loop reported by customers on the mobile site, see ticket",
+    "Buy milk, eggs, bread",
+    "Préparer la présentation pour la réunion de lundi",
+    "Überprüfen Sie die Änderungen im Repository",
+    "改变各种颜色 and update the style guide",
+    "Write the release notes for 2.5.1, covering hooks, performance and the new relative date format",
+    "\033[1mUrgent:\033[0m renew the domain registration",
+    "Plan the team offsite: venue, catering, agenda, travel, and a backup date in case of weather",
+  };
+
+  std::vector <std::string> texts;
+  for (int i = 0; i < count; ++i)
+    texts.push_back (samples[i % (sizeof (samples) / sizeof (samples[0]))]);
+
+  return texts;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void report (const std::string& name, unsigned long reference, unsigned long current, bool same)
+{
+  std::cout << std::left << std::setw (16) << name
+            << " reference " << std::right << std::setw (9) << reference << " us"
+            << "  current " << std::setw (9) << current << " us"
+            << "  speedup " << std::fixed << std::setprecision (2)
+            << (current ? (double) reference / current : 0.0) << "x"
+            << (same ? "" : "  MISMATCH")
+            << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int argc, char** argv)
+{
+  int count = argc > 1 ? strtol (argv[1], NULL, 10) : 200000;
+  std::vector <std::string> texts = corpus (count);
+  bool ok = true;
+
+  {
+    unsigned long start = Timer::now ();
+    unsigned long expected = 0;
+    for (auto& text : texts)
+      expected += reference_utf8_length (text);
+    unsigned long reference = Timer::now () - start;
+
+    start = Timer::now ();
+    unsigned long actual = 0;
+    for (auto& text : texts)
+      actual += utf8_length (text);
+    report ("utf8_length", reference, Timer::now () - start, actual == expected);
+    ok &= actual == expected;
+  }
+
+  {
+    unsigned long start = Timer::now ();
+    unsigned long expected = 0;
+    for (auto& text : texts)
+      expected += reference_utf8_width (text);
+    unsigned long reference = Timer::now () - start;
+
+    start = Timer::now ();
+    unsigned long actual = 0;
+    for (auto& text : texts)
+      actual += utf8_width (text);
+    report ("utf8_width", reference, Timer::now () - start, actual == expected);
+    ok &= actual == expected;
+  }
+
+  {
+    unsigned long start = Timer::now ();
+    std::string::size_type expected = 0;
+    for (auto& text : texts)
+      expected += reference_utf8_substr (text, 10, 20).length ();
+    unsigned long reference = Timer::now () - start;
+
+    start = Timer::now ();
+    std::string::size_type actual = 0;
+    for (auto& text : texts)
+      actual += utf8_substr (text, 10, 20).length ();
+    report ("utf8_substr", reference, Timer::now () - start, actual == expected);
+    ok &= actual == expected;
+  }
+
+  {
+    unsigned long start = Timer::now ();
+    long expected = 0;
+    for (auto& text : texts)
+      expected += reference_longestWord (text);
+    unsigned long reference = Timer::now () - start;
+
+    start = Timer::now ();
+    long actual = 0;
+    for (auto& text : texts)
+      actual += longestWord (text);
+    report ("longestWord", reference, Timer::now () - start, actual == expected);
+    ok &= actual == expected;
+  }
+
+  {
+    unsigned long start = Timer::now ();
+    std::string::size_type expected = 0;
+    for (auto& text : texts)
+      expected += reference_strip (text).length ();
+    unsigned long reference = Timer::now () - start;
+
+    start = Timer::now ();
+    std::string::size_type actual = 0;
+    for (auto& text : texts)
+      actual += Color::strip (text).length ();
+    report ("Color::strip", reference, Timer::now () - start, actual == expected);
+    ok &= actual == expected;
+  }
+
+  return ok ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Aggregate.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <util.h>
+
+// Below this many tasks, threads cost more than they save.
+static const size_t parallelMinimum = 20000;
+
+////////////////////////////////////////////////////////////////////////////////
+Aggregate::Totals::Totals ()
+: _count (0)
+, _pending (0)
+, _waiting (0)
+, _completed (0)
+, _deleted (0)
+, _recurring (0)
+, _values (0)
+, _sum (0.0)
+, _min (std::numeric_limits <double>::max ())
+, _max (std::numeric_limits <double>::lowest ())
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::Totals::add (const Totals& other)
+{
+  _count     += other._count;
+  _pending   += other._pending;
+  _waiting   += other._waiting;
+  _completed += other._completed;
+  _deleted   += other._deleted;
+  _recurring += other._recurring;
+  _values    += other._values;
+  _sum       += other._sum;
+  _min        = std::min (_min, other._min);
+  _max        = std::max (_max, other._max);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Aggregate::Aggregate (Keys keys, Value value /* = nullptr */)
+: _keys (keys)
+, _value (value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::add (const std::vector <Task>& tasks)
+{
+  unsigned int threads = std::thread::hardware_concurrency ();
+  if (tasks.size () < parallelMinimum || threads < 2)
+  {
+    add (tasks.begin (), tasks.end ());
+    return;
+  }
+
+  // Each chunk is accumulated separately, then merged in order.
+  size_t chunk = (tasks.size () + threads - 1) / threads;
+  std::vector <Aggregate> partials (threads, Aggregate (_keys, _value));
+  std::vector <std::thread> workers;
+  for (unsigned int i = 0; i < threads; ++i)
+  {
+    auto from = tasks.begin () + std::min (tasks.size (), i * chunk);
+    auto to   = tasks.begin () + std::min (tasks.size (), (i + 1) * chunk);
+    workers.push_back (std::thread ([&partials, i, from, to] ()
+    {
+      partials[i].add (from, to);
+    }));
+  }
+
+  for (auto& worker : workers)
+    worker.join ();
+
+  for (auto& partial : partials)
+    merge (partial);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::add (
+  std::vector <Task>::const_iterator from,
+  std::vector <Task>::const_iterator to)
+{
+  for (auto task = from; task != to; ++task)
+    add (*task);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::add (const Task& task)
+{
+  Totals one;
+  one._count = 1;
+  switch (task.getStatus ())
+  {
+  case Task::pending:   one._pending   = 1; break;
+  case Task::waiting:   one._waiting   = 1; break;
+  case Task::completed: one._completed = 1; break;
+  case Task::deleted:   one._deleted   = 1; break;
+  case Task::recurring: one._recurring = 1; break;
+  }
+
+  double value;
+  if (_value && _value (task, value))
+  {
+    one._values = 1;
+    one._sum = one._min = one._max = value;
+  }
+
+  _scratch.clear ();
+  _keys (task, _scratch);
+  for (auto& key : _scratch)
+    group (key).add (one);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::merge (const Aggregate& other)
+{
+  for (size_t i = 0; i < other._names.size (); ++i)
+    group (other._names[i]).add (other._totals[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Adds the totals of every project to each of its parent projects, so that
+// 'a' includes 'a.b' and 'a.b.c'.  This costs one extractParents call per
+// distinct project, rather than one per task.
+void Aggregate::rollUpProjects ()
+{
+  std::vector <std::string> names = _names;
+  std::vector <Totals> totals = _totals;
+  for (size_t i = 0; i < names.size (); ++i)
+    for (auto& parent : extractParents (names[i]))
+      group (parent).add (totals[i]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::map <std::string, Aggregate::Totals> Aggregate::groups () const
+{
+  std::map <std::string, Totals> all;
+  for (size_t i = 0; i < _names.size (); ++i)
+    all[_names[i]] = _totals[i];
+
+  return all;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::project (const Task& task, std::vector <std::string>& keys)
+{
+  keys.push_back (task.get ("project"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Aggregate::tags (const Task& task, std::vector <std::string>& keys)
+{
+  task.getTags (keys);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Aggregate::Totals& Aggregate::group (const std::string& name)
+{
+  auto i = _index.find (name);
+  if (i != _index.end ())
+    return _totals[i->second];
+
+  _index[name] = _names.size ();
+  _names.push_back (name);
+  _totals.push_back (Totals ());
+  return _totals.back ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,93 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_AGGREGATE
+#define INCLUDED_AGGREGATE
+
+#include <map>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <Task.h>
+
+// Aggregate groups tasks by key (a project, tags) in a single pass, and keeps
+// per-group counts, and the sum, minimum and maximum of an optional value.
+// Keys are interned, so each task costs one hash lookup per key.  Large task
+// lists are accumulated in chunks on several threads, then merged, so the key
+// and value functions must not modify shared state.
+class Aggregate
+{
+public:
+  class Totals
+  {
+  public:
+    Totals ();
+    void add (const Totals&);
+
+  public:
+    int _count;                  // All tasks
+    int _pending;                // By status
+    int _waiting;
+    int _completed;
+    int _deleted;
+    int _recurring;
+    int _values;                 // Tasks that provided a value
+    double _sum;                 // Sum of values
+    double _min;                 // Smallest value
+    double _max;                 // Largest value
+  };
+
+  typedef std::function <void (const Task&, std::vector <std::string>&)> Keys;
+  typedef std::function <bool (const Task&, double&)> Value;
+
+  Aggregate (Keys, Value value = nullptr);
+
+  void add (const std::vector <Task>&);
+  void add (const Task&);
+  void merge (const Aggregate&);
+  void rollUpProjects ();
+
+  std::map <std::string, Totals> groups () const;
+
+  static void project (const Task&, std::vector <std::string>&);
+  static void tags (const Task&, std::vector <std::string>&);
+
+private:
+  void add (std::vector <Task>::const_iterator, std::vector <Task>::const_iterator);
+  Totals& group (const std::string&);
+
+private:
+  Keys _keys;
+  Value _value;
+  std::unordered_map <std::string, size_t> _index;
+  std::vector <std::string> _names;
+  std::vector <Totals> _totals;
+  std::vector <std::string> _scratch;
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <stdlib.h>
 #include <Context.h>
+#include <Eval.h>
 #include <Lexer.h>
 #include <Color.h>
 #include <text.h>
@@ -44,6 +45,33 @@ int CLI2::minimumMatchLength = 3;
 // Alias expansion limit. Any more indicates some kind of error.
 static int safetyValveDefault = 10;
 
+// Names of A2::Tag values, in the same order.
+static const char* tagNames[] =
+{
+  "BINARY", "CMD", "FILTER", "MODIFICATION", "MISCELLANEOUS",
+  "RC", "CONFIG", "ORIGINAL", "PLAIN", "QUOTED",
+  "DEFAULT", "ASSUMED", "TERMINATED", "UNKNOWN",
+  "READONLY", "SHOWSID", "RUNSGC", "USESCONTEXT",
+  "ALLOWSFILTER", "ALLOWSMODIFICATIONS", "ALLOWSMISC",
+};
+
+static const std::string emptyAttribute;
+
+////////////////////////////////////////////////////////////////////////////////
+static bool tagFromName (const std::string& name, A2::Tag& tag)
+{
+  for (int i = 0; i < static_cast <int> (A2::Tag::count); ++i)
+  {
+    if (name == tagNames[i])
+    {
+      tag = static_cast <A2::Tag> (i);
+      return true;
+    }
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 A2::A2 (const std::string& raw, Lexer::Type lextype)
 {
@@ -60,6 +88,11 @@ A2::~A2 ()
 A2::A2 (const A2& other)
 : _lextype (other._lextype)
 , _tags (other._tags)
+, _raw (other._raw)
+, _canonical (other._canonical)
+, _name (other._name)
+, _modifier (other._modifier)
+, _value (other._value)
 , _attributes (other._attributes)
 {
 }
@@ -71,6 +104,11 @@ A2& A2::operator= (const A2& other)
   {
     _lextype    = other._lextype;
     _tags       = other._tags;
+    _raw        = other._raw;
+    _canonical  = other._canonical;
+    _name       = other._name;
+    _modifier   = other._modifier;
+    _value      = other._value;
     _attributes = other._attributes;
   }
 
@@ -78,64 +116,85 @@ A2& A2::operator= (const A2& other)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool A2::hasTag (const std::string& tag) const
+bool A2::hasTag (Tag tag) const
 {
-  if (std::find (_tags.begin (), _tags.end (), tag) != _tags.end ())
-    return true;
+  return _tags.test (static_cast <int> (tag));
+}
 
-  return false;
+////////////////////////////////////////////////////////////////////////////////
+void A2::tag (Tag tag)
+{
+  _tags.set (static_cast <int> (tag));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void A2::tag (const std::string& tag)
+void A2::unTag (Tag tag)
 {
-  if (! hasTag (tag))
-    _tags.push_back (tag);
+  _tags.reset (static_cast <int> (tag));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void A2::unTag (const std::string& tag)
+bool A2::hasTag (const std::string& name) const
 {
-  for (auto i = _tags.begin (); i != _tags.end (); ++i)
-  {
-    if (*i == tag)
-    {
-      _tags.erase (i);
-      break;
-    }
-  }
+  Tag tag;
+  return tagFromName (name, tag) && hasTag (tag);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Unknown names are ignored, as no argument can carry them.
+void A2::tag (const std::string& name)
+{
+  Tag tag;
+  if (tagFromName (name, tag))
+    this->tag (tag);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void A2::unTag (const std::string& name)
+{
+  Tag tag;
+  if (tagFromName (name, tag))
+    unTag (tag);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Accessor for attributes.
 void A2::attribute (const std::string& name, const std::string& value)
 {
-  _attributes[name] = value;
-
   if (name == "raw")
+  {
+    _raw = value;
     decompose ();
+  }
+  else if (name == "canonical") _canonical = value;
+  else if (name == "name")      _name      = value;
+  else if (name == "modifier")  _modifier  = value;
+  else if (name == "value")     _value     = value;
+  else                          _attributes[name] = value;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Accessor for attributes.
-const std::string A2::attribute (const std::string& name) const
+const std::string& A2::attribute (const std::string& name) const
 {
+  if (name == "raw")       return _raw;
+  if (name == "canonical") return _canonical;
+  if (name == "name")      return _name;
+  if (name == "modifier")  return _modifier;
+  if (name == "value")     return _value;
+
   // Prevent autovivification.
   auto i = _attributes.find (name);
   if (i != _attributes.end ())
     return i->second;
 
-  return "";
+  return emptyAttribute;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-const std::string A2::getToken () const
+const std::string& A2::getToken () const
 {
-  auto i = _attributes.find ("canonical");
-  if (i == _attributes.end ())
-    i = _attributes.find ("raw");
-
-  return i->second;
+  return _canonical != "" ? _canonical : _raw;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -143,9 +202,8 @@ void A2::decompose ()
 {
   if (_lextype == Lexer::Type::tag)
   {
-    std::string raw = _attributes["raw"];
-    attribute ("name", raw.substr (1));
-    attribute ("sign", raw.substr (0, 1));
+    attribute ("name", _raw.substr (1));
+    attribute ("sign", _raw.substr (0, 1));
   }
 
   else if (_lextype == Lexer::Type::substitution)
@@ -156,7 +214,7 @@ void A2::decompose ()
     std::string from;
     std::string to;
     std::string flags;
-    if (Lexer::decomposeSubstitution (_attributes["raw"], from, to, flags))
+    if (Lexer::decomposeSubstitution (_raw, from, to, flags))
     {
       attribute ("from",  from);
       attribute ("to",    to);
@@ -170,7 +228,7 @@ void A2::decompose ()
     std::string mod;
     std::string sep;
     std::string value;
-    if (Lexer::decomposePair (_attributes["raw"], name, mod, sep, value))
+    if (Lexer::decomposePair (_raw, name, mod, sep, value))
     {
       attribute ("name",      name);
       attribute ("modifier",  mod);
@@ -180,9 +238,9 @@ void A2::decompose ()
       if (name == "rc")
       {
         if (mod != "")
-          tag ("CONFIG");
+          tag (Tag::config);
         else
-          tag ("RC");
+          tag (Tag::rc);
       }
     }
   }
@@ -194,7 +252,7 @@ void A2::decompose ()
 
     std::string pattern;
     std::string flags;
-    if (Lexer::decomposePattern (_attributes["raw"], pattern, flags))
+    if (Lexer::decomposePattern (_raw, pattern, flags))
     {
       attribute ("pattern", pattern);
       attribute ("flags",   flags);
@@ -207,11 +265,18 @@ const std::string A2::dump () const
 {
   std::string output = Lexer::typeToString (_lextype);
 
-  // Dump attributes.
+  // Dump attributes, fixed and otherwise, by name.
+  auto all = _attributes;
+  all["raw"] = _raw;
+  if (_canonical != "") all["canonical"] = _canonical;
+  if (_name      != "") all["name"]      = _name;
+  if (_modifier  != "") all["modifier"]  = _modifier;
+  if (_value     != "") all["value"]     = _value;
+
   std::string atts;
-  for (auto a = _attributes.begin (); a != _attributes.end (); ++a)
+  for (auto a = all.begin (); a != all.end (); ++a)
   {
-    if (a != _attributes.begin ())
+    if (a != all.begin ())
       atts += " ";
 
     atts += a->first + "='\033[33m" + a->second + "\033[0m'";
@@ -222,20 +287,26 @@ const std::string A2::dump () const
 
   // Dump tags.
   std::string tags;
-  for (auto& tag : _tags)
+  for (int i = 0; i < static_cast <int> (Tag::count); ++i)
   {
+    if (! _tags.test (i))
+      continue;
+
     if (tags.length ())
       tags += ' ';
 
-         if (tag == "BINARY")        tags += "\033[1;37;44m"           + tag + "\033[0m";
-    else if (tag == "CMD")           tags += "\033[1;37;46m"           + tag + "\033[0m";
-    else if (tag == "FILTER")        tags += "\033[1;37;42m"           + tag + "\033[0m";
-    else if (tag == "MODIFICATION")  tags += "\033[1;37;43m"           + tag + "\033[0m";
-    else if (tag == "MISCELLANEOUS") tags += "\033[1;37;45m"           + tag + "\033[0m";
-    else if (tag == "RC")            tags += "\033[1;37;41m"           + tag + "\033[0m";
-    else if (tag == "CONFIG")        tags += "\033[1;37;101m"          + tag + "\033[0m";
-    else if (tag == "?")             tags += "\033[38;5;255;48;5;232m" + tag + "\033[0m";
-    else                             tags += "\033[32m"                + tag + "\033[0m";
+    std::string tag = tagNames[i];
+    switch (static_cast <Tag> (i))
+    {
+    case Tag::binary:        tags += "\033[1;37;44m"  + tag + "\033[0m"; break;
+    case Tag::cmd:           tags += "\033[1;37;46m"  + tag + "\033[0m"; break;
+    case Tag::filter:        tags += "\033[1;37;42m"  + tag + "\033[0m"; break;
+    case Tag::modification:  tags += "\033[1;37;43m"  + tag + "\033[0m"; break;
+    case Tag::miscellaneous: tags += "\033[1;37;45m"  + tag + "\033[0m"; break;
+    case Tag::rc:            tags += "\033[1;37;41m"  + tag + "\033[0m"; break;
+    case Tag::config:        tags += "\033[1;37;101m" + tag + "\033[0m"; break;
+    default:                 tags += "\033[32m"       + tag + "\033[0m"; break;
+    }
   }
 
   if (tags.length ())
@@ -329,6 +400,9 @@ void CLI2::applyOverrides (int argc, const char** argv)
 ////////////////////////////////////////////////////////////////////////////////
 CLI2::CLI2 ()
 : _context_filter_added (false)
+, _id_filter_only (false)
+, _filter_prepared (false)
+, _filter_compiled (false)
 {
 }
 
@@ -361,7 +435,7 @@ void CLI2::entity (const std::string& category, const std::string& name)
 void CLI2::add (const std::string& argument)
 {
   A2 arg (Lexer::trim (argument), Lexer::Type::word);
-  arg.tag ("ORIGINAL");
+  arg.tag (A2::Tag::original);
   _original_args.push_back (arg);
 
   // Adding a new argument invalidates prior analysis.
@@ -398,9 +472,9 @@ void CLI2::handleArg0 ()
 {
   // Capture arg0 separately, because it is the command that was run, and could
   // need special handling.
-  std::string raw = _original_args[0].attribute ("raw");
+  std::string raw = _original_args[0]._raw;
   A2 a (raw, Lexer::Type::word);
-  a.tag ("BINARY");
+  a.tag (A2::Tag::binary);
 
   std::string basename = "task";
   auto slash = raw.rfind ('/');
@@ -437,11 +511,11 @@ void CLI2::lexArguments ()
   bool terminated = false;
   for (unsigned int i = 1; i < _original_args.size (); ++i)
   {
-    bool quoted = Lexer::wasQuoted (_original_args[i].attribute ("raw"));
+    bool quoted = Lexer::wasQuoted (_original_args[i]._raw);
 
     std::string lexeme;
     Lexer::Type type;
-    Lexer lex (_original_args[i].attribute ("raw"));
+    Lexer lex (_original_args[i]._raw);
     if (lex.token (lexeme, type) &&
         (lex.isEOS () ||                         // Token goes to EOS
          (quoted && type == Lexer::Type::pair))  // Quoted pairs automatically go to EOS
@@ -452,21 +526,21 @@ void CLI2::lexArguments ()
       else if (terminated)
         type = Lexer::Type::word;
 
-      A2 a (_original_args[i].attribute ("raw"), type);
+      A2 a (_original_args[i]._raw, type);
       if (terminated)
-        a.tag ("TERMINATED");
+        a.tag (A2::Tag::terminated);
       if (quoted)
-        a.tag ("QUOTED");
+        a.tag (A2::Tag::quoted);
 
-      if (_original_args[i].hasTag ("ORIGINAL"))
-        a.tag ("ORIGINAL");
+      if (_original_args[i].hasTag (A2::Tag::original))
+        a.tag (A2::Tag::original);
 
       _args.push_back (a);
     }
     else
     {
       std::string quote = "'";
-      std::string escaped = _original_args[i].attribute ("raw");
+      std::string escaped = _original_args[i]._raw;
       str_replace (escaped, quote, "\\'");
 
       std::string::size_type cursor = 0;
@@ -475,11 +549,11 @@ void CLI2::lexArguments ()
       {
         Lexer::dequote (word);
         A2 unknown (word, Lexer::Type::word);
-        if (lex.wasQuoted (_original_args[i].attribute ("raw")))
-          unknown.tag ("QUOTED");
+        if (lex.wasQuoted (_original_args[i]._raw))
+          unknown.tag (A2::Tag::quoted);
 
-        if (_original_args[i].hasTag ("ORIGINAL"))
-          unknown.tag ("ORIGINAL");
+        if (_original_args[i].hasTag (A2::Tag::original))
+          unknown.tag (A2::Tag::original);
 
         _args.push_back (unknown);
       }
@@ -487,14 +561,14 @@ void CLI2::lexArguments ()
       // This branch may have no use-case.
       else
       {
-        A2 unknown (_original_args[i].attribute ("raw"), Lexer::Type::word);
-        unknown.tag ("UNKNOWN");
+        A2 unknown (_original_args[i]._raw, Lexer::Type::word);
+        unknown.tag (A2::Tag::unknown);
 
-        if (lex.wasQuoted (_original_args[i].attribute ("raw")))
-          unknown.tag ("QUOTED");
+        if (lex.wasQuoted (_original_args[i]._raw))
+          unknown.tag (A2::Tag::quoted);
 
-        if (_original_args[i].hasTag ("ORIGINAL"))
-          unknown.tag ("ORIGINAL");
+        if (_original_args[i].hasTag (A2::Tag::original))
+          unknown.tag (A2::Tag::original);
 
         _args.push_back (unknown);
       }
@@ -530,9 +604,9 @@ void CLI2::demotion ()
     }
 
     else if (a._lextype == Lexer::Type::pair &&
-        canonicalize (canonical, "pseudo", a.attribute ("name")))
+        canonicalize (canonical, "pseudo", a._name))
     {
-      context.config.set (canonical, a.attribute ("value"));
+      context.config.set (canonical, a._value);
       changes = true;
 
       // Equivalent to erasing 'a'.
@@ -548,14 +622,18 @@ void CLI2::demotion ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Intended to be called after ::add() to perform the final analysis.
+// Intended to be called after ::add() to perform the final analysis.  Anything
+// derived from _args, such as the prepared filter, is stale afterwards.
 void CLI2::analyze ()
 {
+  Profiler::Span span ("CLI2::analyze");
+
   if (context.config.getInteger ("debug.parser") >= 2)
     context.debug (dump ("CLI2::analyze"));
 
   // Process _original_args.
   _args.clear ();
+  invalidateFilter ();
   handleArg0 ();
   lexArguments ();
 
@@ -582,16 +660,28 @@ void CLI2::addFilter (const std::string& arg)
 {
   if (arg.length ())
   {
-    std::vector <std::string> filter;
-    filter.push_back ("(");
+    std::vector <std::string> lexemes;
 
     std::string lexeme;
     Lexer::Type type;
     Lexer lex (arg);
 
     while (lex.token (lexeme, type))
-      filter.push_back (lexeme);
+      lexemes.push_back (lexeme);
 
+    addFilter (lexemes);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Adds a filter that was already lexed, for callers that reuse one filter.
+void CLI2::addFilter (const std::vector <std::string>& lexemes)
+{
+  if (lexemes.size ())
+  {
+    std::vector <std::string> filter;
+    filter.push_back ("(");
+    filter.insert (filter.end (), lexemes.begin (), lexemes.end ());
     filter.push_back (")");
     add (filter);
     analyze ();
@@ -623,7 +713,7 @@ void CLI2::addContextFilter ()
         a._lextype == Lexer::Type::number ||
         a._lextype == Lexer::Type::set)
     {
-      context.debug (format ("UUID/ID argument found '{1}', not applying context.", a.attribute ("raw")));
+      context.debug (format ("UUID/ID argument found '{1}', not applying context.", a._raw));
       return;
     }
   }
@@ -643,15 +733,30 @@ void CLI2::addContextFilter ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Discards the prepared and compiled filter, which are rebuilt from _args when
+// next used.
+void CLI2::invalidateFilter ()
+{
+  _filter_prepared = false;
+  _filter_compiled = false;
+  _compiled_filter.reset ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Parse the command line, identifiying filter components, expanding syntactic
-// sugar as necessary.
+// sugar as necessary.  This is only done once per analysis, no matter how many
+// times the filter is used.
 void CLI2::prepareFilter ()
 {
+  if (_filter_prepared)
+    return;
+
   // Clear and re-populate.
   _id_ranges.clear ();
   _uuid_list.clear ();
   _context_filter_added = false;
+  _id_filter_only = false;
 
   // Remove all the syntactic sugar for FILTERs.
   lexFilterArgs ();
@@ -664,18 +769,19 @@ void CLI2::prepareFilter ()
   desugarFilterAttributes ();
   desugarFilterPatterns ();
   insertJunctions ();                 // Deliberately after all desugar calls.
+  _filter_prepared = true;
 
   if (context.verbose ("filter"))
   {
     std::string combined;
     for (auto& a : _args)
     {
-      if (a.hasTag ("FILTER"))
+      if (a.hasTag (A2::Tag::filter))
       {
         if (combined != "")
           combined += " ";
 
-        combined += a.attribute ("raw");
+        combined += a._raw;
       }
     }
 
@@ -690,8 +796,8 @@ const std::vector <std::string> CLI2::getWords ()
 {
   std::vector <std::string> words;
   for (auto& a : _args)
-    if (a.hasTag ("MISCELLANEOUS"))
-      words.push_back (a.attribute ("raw"));
+    if (a.hasTag (A2::Tag::miscellaneous))
+      words.push_back (a._raw);
 
   if (context.config.getInteger ("debug.parser") >= 2)
   {
@@ -742,7 +848,7 @@ bool CLI2::canonicalize (
 std::string CLI2::getBinary () const
 {
   if (_args.size ())
-    return _args[0].attribute ("raw");
+    return _args[0]._raw;
 
   return "";
 }
@@ -751,7 +857,7 @@ std::string CLI2::getBinary () const
 std::string CLI2::getCommand (bool canonical) const
 {
   for (auto& a : _args)
-    if (a.hasTag ("CMD"))
+    if (a.hasTag (A2::Tag::cmd))
       return a.attribute (canonical ? "canonical" : "raw");
 
   return "";
@@ -772,7 +878,7 @@ const std::string CLI2::dump (const std::string& title) const
     if (i != _original_args.begin ())
       out << ' ';
 
-    if (i->hasTag ("ORIGINAL"))
+    if (i->hasTag (A2::Tag::original))
       out << colorArgs.colorize (i->attribute ("raw"));
     else
       out << colorFilter.colorize (i->attribute ("raw"));
@@ -828,8 +934,8 @@ void CLI2::aliasExpansion ()
     std::string raw;
     for (auto& i : _args)
     {
-      raw = i.attribute ("raw");
-      if (i.hasTag ("TERMINATED"))
+      raw = i._raw;
+      if (i.hasTag (A2::Tag::terminated))
       {
         reconstructed.push_back (i);
       }
@@ -856,18 +962,18 @@ void CLI2::aliasExpansion ()
     bool terminated = false;
     for (auto& i : _original_args)
     {
-      if (i.attribute ("raw") == "--")
+      if (i._raw == "--")
         terminated = true;
 
       if (terminated)
       {
         reconstructedOriginals.push_back (i);
       }
-      else if (_aliases.find (i.attribute ("raw")) != _aliases.end ())
+      else if (_aliases.find (i._raw) != _aliases.end ())
       {
         std::string lexeme;
         Lexer::Type type;
-        Lexer lex (_aliases[i.attribute ("raw")]);
+        Lexer lex (_aliases[i._raw]);
         while (lex.token (lexeme, type))
           reconstructedOriginals.push_back (A2 (lexeme, type));
 
@@ -901,11 +1007,11 @@ void CLI2::canonicalizeNames ()
   {
     if (a._lextype == Lexer::Type::pair)
     {
-      std::string raw = a.attribute ("raw");
+      std::string raw = a._raw;
       if (raw.substr (0, 3) != "rc:" &&
           raw.substr (0, 3) != "rc.")
       {
-        std::string name = a.attribute ("name");
+        std::string name = a._name;
         std::string canonical;
         if (canonicalize (canonical, "pseudo",    name)    ||
             canonicalize (canonical, "attribute", name))
@@ -945,15 +1051,15 @@ void CLI2::categorizeArgs ()
       continue;
 
     // Record that the command has been found, it affects behavior.
-    if (a.hasTag ("CMD"))
+    if (a.hasTag (A2::Tag::cmd))
     {
       afterCommand = true;
     }
 
     // Skip admin args.
-    else if (a.hasTag ("BINARY") ||
-             a.hasTag ("RC")     ||
-             a.hasTag ("CONFIG"))
+    else if (a.hasTag (A2::Tag::binary) ||
+             a.hasTag (A2::Tag::rc)     ||
+             a.hasTag (A2::Tag::config))
     {
       // NOP.
     }
@@ -975,14 +1081,14 @@ void CLI2::categorizeArgs ()
              ! cmd->accepts_miscellaneous ())
     {
       // No commands were expected --> error.
-      throw format (STRING_PARSER_UNEXPECTED_ARG, command, a.attribute ("raw"));
+      throw format (STRING_PARSER_UNEXPECTED_ARG, command, a._raw);
     }
     else if (cmd                             &&
              ! cmd->accepts_filter ()        &&
              ! cmd->accepts_modifications () &&
                cmd->accepts_miscellaneous ())
     {
-      a.tag ("MISCELLANEOUS");
+      a.tag (A2::Tag::miscellaneous);
       changes = true;
     }
     else if (cmd                             &&
@@ -990,7 +1096,7 @@ void CLI2::categorizeArgs ()
                cmd->accepts_modifications () &&
              ! cmd->accepts_miscellaneous ())
     {
-      a.tag ("MODIFICATION");
+      a.tag (A2::Tag::modification);
       changes = true;
     }
     else if (cmd                             &&
@@ -1006,7 +1112,7 @@ void CLI2::categorizeArgs ()
              ! cmd->accepts_modifications () &&
              ! cmd->accepts_miscellaneous ())
     {
-      a.tag ("FILTER");
+      a.tag (A2::Tag::filter);
       changes = true;
     }
     else if (cmd                             &&
@@ -1015,9 +1121,9 @@ void CLI2::categorizeArgs ()
                cmd->accepts_miscellaneous ())
     {
       if (!afterCommand)
-        a.tag ("FILTER");
+        a.tag (A2::Tag::filter);
       else
-        a.tag ("MISCELLANEOUS");
+        a.tag (A2::Tag::miscellaneous);
 
       changes = true;
     }
@@ -1027,9 +1133,9 @@ void CLI2::categorizeArgs ()
              ! cmd->accepts_miscellaneous ())
     {
       if (!afterCommand)
-        a.tag ("FILTER");
+        a.tag (A2::Tag::filter);
       else
-        a.tag ("MODIFICATION");
+        a.tag (A2::Tag::modification);
 
       changes = true;
     }
@@ -1075,8 +1181,8 @@ void CLI2::parenthesizeOriginalFilter ()
   unsigned int lastOriginalFilter = 0;
   for (unsigned int i = 1; i < _args.size (); ++i)
   {
-    if (_args[i].hasTag ("FILTER") &&
-        _args[i].hasTag ("ORIGINAL"))
+    if (_args[i].hasTag (A2::Tag::filter) &&
+        _args[i].hasTag (A2::Tag::original))
     {
       if (firstOriginalFilter == 0)
         firstOriginalFilter = i;
@@ -1095,8 +1201,8 @@ void CLI2::parenthesizeOriginalFilter ()
       if (i == firstOriginalFilter)
       {
         A2 openParen ("(", Lexer::Type::op);
-        openParen.tag ("ORIGINAL");
-        openParen.tag ("FILTER");
+        openParen.tag (A2::Tag::original);
+        openParen.tag (A2::Tag::filter);
         reconstructed.push_back (openParen);
       }
 
@@ -1105,8 +1211,8 @@ void CLI2::parenthesizeOriginalFilter ()
       if (i == lastOriginalFilter)
       {
         A2 closeParen (")", Lexer::Type::op);
-        closeParen.tag ("ORIGINAL");
-        closeParen.tag ("FILTER");
+        closeParen.tag (A2::Tag::original);
+        closeParen.tag (A2::Tag::filter);
         reconstructed.push_back (closeParen);
       }
     }
@@ -1126,7 +1232,7 @@ bool CLI2::findCommand ()
 {
   for (auto& a : _args)
   {
-    std::string raw = a.attribute ("raw");
+    std::string raw = a._raw;
     std::string canonical;
 
     // If the arg canonicalized to a 'cmd', but is also not an exact match
@@ -1142,17 +1248,17 @@ bool CLI2::findCommand ()
       continue;
 
     a.attribute ("canonical", canonical);
-    a.tag ("CMD");
+    a.tag (A2::Tag::cmd);
 
     // Apply command DNA as tags.
     Command* command = context.commands[canonical];
-    if (command->read_only ())             a.tag ("READONLY");
-    if (command->displays_id ())           a.tag ("SHOWSID");
-    if (command->needs_gc ())              a.tag ("RUNSGC");
-    if (command->uses_context ())          a.tag ("USESCONTEXT");
-    if (command->accepts_filter ())        a.tag ("ALLOWSFILTER");
-    if (command->accepts_modifications ()) a.tag ("ALLOWSMODIFICATIONS");
-    if (command->accepts_miscellaneous ()) a.tag ("ALLOWSMISC");
+    if (command->read_only ())             a.tag (A2::Tag::readonly);
+    if (command->displays_id ())           a.tag (A2::Tag::showsid);
+    if (command->needs_gc ())              a.tag (A2::Tag::runsgc);
+    if (command->uses_context ())          a.tag (A2::Tag::usescontext);
+    if (command->accepts_filter ())        a.tag (A2::Tag::allowsfilter);
+    if (command->accepts_modifications ()) a.tag (A2::Tag::allowsmodifications);
+    if (command->accepts_miscellaneous ()) a.tag (A2::Tag::allowsmisc);
 
     if (context.config.getInteger ("debug.parser") >= 2)
       context.debug (dump ("CLI2::analyze findCommand"));
@@ -1190,22 +1296,22 @@ void CLI2::desugarFilterTags ()
   for (auto& a : _args)
   {
     if (a._lextype == Lexer::Type::tag &&
-        a.hasTag ("FILTER"))
+        a.hasTag (A2::Tag::filter))
     {
       changes = true;
 
       A2 left ("tags", Lexer::Type::dom);
-      left.tag ("FILTER");
+      left.tag (A2::Tag::filter);
       reconstructed.push_back (left);
 
-      std::string raw = a.attribute ("raw");
+      std::string raw = a._raw;
 
       A2 op (raw[0] == '+' ? "_hastag_" : "_notag_", Lexer::Type::op);
-      op.tag ("FILTER");
+      op.tag (A2::Tag::filter);
       reconstructed.push_back (op);
 
       A2 right ("" + raw.substr (1) + "", Lexer::Type::string);
-      right.tag ("FILTER");
+      right.tag (A2::Tag::filter);
       reconstructed.push_back (right);
     }
     else
@@ -1232,10 +1338,10 @@ void CLI2::findStrayModifications ()
   {
     for (auto& a : _args)
     {
-      if (a.hasTag ("FILTER"))
+      if (a.hasTag (A2::Tag::filter))
       {
-        a.unTag ("FILTER");
-        a.tag ("MODIFICATION");
+        a.unTag (A2::Tag::filter);
+        a.tag (A2::Tag::modification);
         changes = true;
       }
     }
@@ -1255,13 +1361,13 @@ void CLI2::desugarFilterAttributes ()
   for (auto& a : _args)
   {
     if (a._lextype == Lexer::Type::pair &&
-        a.hasTag ("FILTER"))
+        a.hasTag (A2::Tag::filter))
     {
-      std::string raw   = a.attribute ("raw");
-      std::string name  = a.attribute ("name");
-      std::string mod   = a.attribute ("modifier");
+      std::string raw   = a._raw;
+      std::string name  = a._name;
+      std::string mod   = a._modifier;
       std::string sep   = a.attribute ("separator");
-      std::string value = a.attribute ("value");
+      std::string value = a._value;
 
       // An unquoted string, while equivalent to an empty string, doesn't cause
       // an operand shortage in eval.
@@ -1303,15 +1409,15 @@ void CLI2::desugarFilterAttributes ()
           evalSupported = false;
 
         A2 lhs (name, Lexer::Type::dom);
-        lhs.tag ("FILTER");
+        lhs.tag (A2::Tag::filter);
         lhs.attribute ("canonical", canonical);
         lhs.attribute ("modifier", mod);
 
         A2 op ("", Lexer::Type::op);
-        op.tag ("FILTER");
+        op.tag (A2::Tag::filter);
 
         A2 rhs ("", Lexer::Type::string);
-        rhs.tag ("FILTER");
+        rhs.tag (A2::Tag::filter);
 
         // Special case for '<name>:<value>'.
         if (mod == "")
@@ -1405,7 +1511,7 @@ void CLI2::desugarFilterAttributes ()
         // Do not modify this construct without full understanding.
         if (values.size () == 1 || ! evalSupported)
         {
-          if (Lexer::isDOM (rhs.attribute ("raw")))
+          if (Lexer::isDOM (rhs._raw))
             rhs._lextype = Lexer::Type::dom;
 
           reconstructed.push_back (rhs);
@@ -1453,21 +1559,21 @@ void CLI2::desugarFilterPatterns ()
   for (auto& a : _args)
   {
     if (a._lextype == Lexer::Type::pattern &&
-        a.hasTag ("FILTER"))
+        a.hasTag (A2::Tag::filter))
     {
       changes = true;
 
       A2 lhs ("description", Lexer::Type::dom);
-      lhs.tag ("FILTER");
+      lhs.tag (A2::Tag::filter);
       reconstructed.push_back (lhs);
 
       A2 op ("~", Lexer::Type::op);
-      op.tag ("FILTER");
+      op.tag (A2::Tag::filter);
       reconstructed.push_back (op);
 
       A2 rhs (a.attribute ("pattern"), Lexer::Type::string);
       rhs.attribute ("flags", a.attribute ("flags"));
-      rhs.tag ("FILTER");
+      rhs.tag (A2::Tag::filter);
       reconstructed.push_back (rhs);
     }
     else
@@ -1503,7 +1609,7 @@ void CLI2::findIDs ()
 
     for (auto& a : _args)
     {
-      if (a.hasTag ("FILTER"))
+      if (a.hasTag (A2::Tag::filter))
       {
         ++filterCount;
 
@@ -1513,7 +1619,7 @@ void CLI2::findIDs ()
           if (! previousFilterArgWasAnOperator)
           {
             changes = true;
-            std::string number = a.attribute ("raw");
+            std::string number = a._raw;
             _id_ranges.push_back (std::pair <std::string, std::string> (number, number));
           }
         }
@@ -1521,7 +1627,7 @@ void CLI2::findIDs ()
         {
           // Split the ID list into elements.
           std::vector <std::string> elements;
-          split (elements, a.attribute ("raw"), ',');
+          split (elements, a._raw, ',');
 
           for (auto& element : elements)
           {
@@ -1538,7 +1644,7 @@ void CLI2::findIDs ()
           }
         }
 
-        std::string raw = a.attribute ("raw");
+        std::string raw = a._raw;
         previousFilterArgWasAnOperator = (a._lextype == Lexer::Type::op &&
                                     raw != "("                    &&
                                     raw != ")")
@@ -1558,9 +1664,9 @@ void CLI2::findIDs ()
     {
       for (auto& a : _args)
       {
-        if (a.hasTag ("MODIFICATION"))
+        if (a.hasTag (A2::Tag::modification))
         {
-          std::string raw = a.attribute ("raw");
+          std::string raw = a._raw;
 
           // For a number to be an ID, it must not contain any sign or floating
           // point elements.
@@ -1570,14 +1676,14 @@ void CLI2::findIDs ()
               raw.find ('-') == std::string::npos)
           {
             changes = true;
-            a.unTag ("MODIFICATION");
-            a.tag ("FILTER");
+            a.unTag (A2::Tag::modification);
+            a.tag (A2::Tag::filter);
             _id_ranges.push_back (std::pair <std::string, std::string> (raw, raw));
           }
           else if (a._lextype == Lexer::Type::set)
           {
-            a.unTag ("MODIFICATION");
-            a.tag ("FILTER");
+            a.unTag (A2::Tag::modification);
+            a.tag (A2::Tag::filter);
 
             // Split the ID list into elements.
             std::vector <std::string> elements;
@@ -1608,12 +1714,12 @@ void CLI2::findIDs ()
     std::vector <A2> reconstructed;
     for (auto& a : _args)
     {
-      if (a.hasTag ("FILTER") &&
+      if (a.hasTag (A2::Tag::filter) &&
           a._lextype == Lexer::Type::number)
       {
         changes = true;
-        A2 pair ("id:" + a.attribute ("raw"), Lexer::Type::pair);
-        pair.tag ("FILTER");
+        A2 pair ("id:" + a._raw, Lexer::Type::pair);
+        pair.tag (A2::Tag::filter);
         pair.decompose ();
         reconstructed.push_back (pair);
       }
@@ -1640,10 +1746,10 @@ void CLI2::findUUIDs ()
     for (auto& a : _args)
     {
       if (a._lextype == Lexer::Type::uuid &&
-          a.hasTag ("FILTER"))
+          a.hasTag (A2::Tag::filter))
       {
         changes = true;
-        _uuid_list.push_back (a.attribute ("raw"));
+        _uuid_list.push_back (a._raw);
       }
     }
 
@@ -1652,12 +1758,12 @@ void CLI2::findUUIDs ()
       for (auto& a : _args)
       {
         if (a._lextype == Lexer::Type::uuid &&
-            a.hasTag ("MODIFICATION"))
+            a.hasTag (A2::Tag::modification))
         {
           changes = true;
-          a.unTag ("MODIFICATION");
-          a.tag ("FILTER");
-          _uuid_list.push_back (a.attribute ("raw"));
+          a.unTag (A2::Tag::modification);
+          a.tag (A2::Tag::filter);
+          _uuid_list.push_back (a._raw);
         }
       }
     }
@@ -1669,12 +1775,12 @@ void CLI2::findUUIDs ()
     std::vector <A2> reconstructed;
     for (auto& a : _args)
     {
-      if (a.hasTag ("FILTER") &&
+      if (a.hasTag (A2::Tag::filter) &&
           a._lextype == Lexer::Type::uuid)
       {
         changes = true;
-        A2 pair ("uuid:" + a.attribute ("raw"), Lexer::Type::pair);
-        pair.tag ("FILTER");
+        A2 pair ("uuid:" + a._raw, Lexer::Type::pair);
+        pair.tag (A2::Tag::filter);
         pair.decompose ();
         reconstructed.push_back (pair);
       }
@@ -1704,13 +1810,25 @@ void CLI2::insertIDExpr ()
   // with a synthesized expression. All other occurences are eaten.
   bool changes = false;
   bool foundID = false;
+  bool foundOther = false;
   std::vector <A2> reconstructed;
   for (auto& a : _args)
   {
+    // Note whether anything other than IDs, UUIDs and the parentheses around
+    // them takes part in the filter.
+    if (a.hasTag (A2::Tag::filter)                     &&
+        a._lextype != Lexer::Type::set          &&
+        a._lextype != Lexer::Type::number       &&
+        a._lextype != Lexer::Type::uuid         &&
+        ! (a._lextype == Lexer::Type::op        &&
+           (a._raw == "(" ||
+            a._raw == ")")))
+      foundOther = true;
+
     if ((a._lextype == Lexer::Type::set ||
          a._lextype == Lexer::Type::number ||
          a._lextype == Lexer::Type::uuid) &&
-        a.hasTag ("FILTER"))
+        a.hasTag (A2::Tag::filter))
     {
       if (! foundID)
       {
@@ -1733,21 +1851,21 @@ void CLI2::insertIDExpr ()
         //   )
 
         // Building block operators.
-        A2 openParen  ("(",   Lexer::Type::op);  openParen.tag  ("FILTER");
-        A2 closeParen (")",   Lexer::Type::op);  closeParen.tag ("FILTER");
-        A2 opOr       ("or",  Lexer::Type::op);  opOr.tag       ("FILTER");
-        A2 opAnd      ("and", Lexer::Type::op);  opAnd.tag      ("FILTER");
-        A2 opSimilar  ("=",   Lexer::Type::op);  opSimilar.tag  ("FILTER");
-        A2 opEqual    ("==",  Lexer::Type::op);  opEqual.tag    ("FILTER");
-        A2 opGTE      (">=",  Lexer::Type::op);  opGTE.tag      ("FILTER");
-        A2 opLTE      ("<=",  Lexer::Type::op);  opLTE.tag      ("FILTER");
+        A2 openParen  ("(",   Lexer::Type::op);  openParen.tag  (A2::Tag::filter);
+        A2 closeParen (")",   Lexer::Type::op);  closeParen.tag (A2::Tag::filter);
+        A2 opOr       ("or",  Lexer::Type::op);  opOr.tag       (A2::Tag::filter);
+        A2 opAnd      ("and", Lexer::Type::op);  opAnd.tag      (A2::Tag::filter);
+        A2 opSimilar  ("=",   Lexer::Type::op);  opSimilar.tag  (A2::Tag::filter);
+        A2 opEqual    ("==",  Lexer::Type::op);  opEqual.tag    (A2::Tag::filter);
+        A2 opGTE      (">=",  Lexer::Type::op);  opGTE.tag      (A2::Tag::filter);
+        A2 opLTE      ("<=",  Lexer::Type::op);  opLTE.tag      (A2::Tag::filter);
 
         // Building block attributes.
         A2 argID ("id", Lexer::Type::dom);
-        argID.tag ("FILTER");
+        argID.tag (A2::Tag::filter);
 
         A2 argUUID ("uuid", Lexer::Type::dom);
-        argUUID.tag ("FILTER");
+        argUUID.tag (A2::Tag::filter);
 
         reconstructed.push_back (openParen);
 
@@ -1764,7 +1882,7 @@ void CLI2::insertIDExpr ()
             reconstructed.push_back (opEqual);
 
             A2 value (r->first, Lexer::Type::number);
-            value.tag ("FILTER");
+            value.tag (A2::Tag::filter);
             reconstructed.push_back (value);
 
             reconstructed.push_back (closeParen);
@@ -1784,7 +1902,7 @@ void CLI2::insertIDExpr ()
             reconstructed.push_back (opGTE);
 
             A2 startValue ((ascending ? r->first : r->second), Lexer::Type::number);
-            startValue.tag ("FILTER");
+            startValue.tag (A2::Tag::filter);
             reconstructed.push_back (startValue);
 
             reconstructed.push_back (opAnd);
@@ -1792,7 +1910,7 @@ void CLI2::insertIDExpr ()
             reconstructed.push_back (opLTE);
 
             A2 endValue ((ascending ? r->second : r->first), Lexer::Type::number);
-            endValue.tag ("FILTER");
+            endValue.tag (A2::Tag::filter);
             reconstructed.push_back (endValue);
 
             reconstructed.push_back (closeParen);
@@ -1815,7 +1933,7 @@ void CLI2::insertIDExpr ()
           reconstructed.push_back (opSimilar);
 
           A2 value (*u, Lexer::Type::string);
-          value.tag ("FILTER");
+          value.tag (A2::Tag::filter);
           reconstructed.push_back (value);
 
           reconstructed.push_back (closeParen);
@@ -1833,6 +1951,7 @@ void CLI2::insertIDExpr ()
   if (changes)
   {
     _args = reconstructed;
+    _id_filter_only = ! foundOther;
 
     if (context.config.getInteger ("debug.parser") >= 2)
       context.debug (dump ("CLI2::prepareFilter insertIDExpr"));
@@ -1849,17 +1968,17 @@ void CLI2::lexFilterArgs ()
   for (auto& a : _args)
   {
     if (a._lextype == Lexer::Type::word &&
-        a.hasTag ("FILTER"))
+        a.hasTag (A2::Tag::filter))
     {
       changes = true;
 
       std::string lexeme;
       Lexer::Type type;
-      Lexer lex (a.attribute ("raw"));
+      Lexer lex (a._raw);
       while (lex.token (lexeme, type))
       {
         A2 extra (lexeme, type);
-        extra.tag ("FILTER");
+        extra.tag (A2::Tag::filter);
         reconstructed.push_back (extra);
       }
     }
@@ -1894,7 +2013,7 @@ void CLI2::desugarFilterPlainArgs ()
   auto prev = &_args[0];
   for (auto& a : _args)
   {
-    auto raw   = a.attribute ("raw");
+    auto raw   = a._raw;
     auto praw  = prev->attribute ("raw");
     auto ppraw = prevprev->attribute ("raw");
 
@@ -1908,7 +2027,7 @@ void CLI2::desugarFilterPlainArgs ()
         (prev->_lextype == Lexer::Type::identifier ||  // candidate
          prev->_lextype == Lexer::Type::word)      &&  // candidate
 
-        prev->hasTag ("FILTER")                    &&  // candidate
+        prev->hasTag (A2::Tag::filter)                    &&  // candidate
 
         (a._lextype != Lexer::Type::op             ||  // argY
          raw == "("                                ||
@@ -1917,7 +2036,7 @@ void CLI2::desugarFilterPlainArgs ()
          raw == "or"                               ||
          raw == "xor"))
     {
-      prev->tag ("PLAIN");
+      prev->tag (A2::Tag::plain);
     }
 
     prevprev = prev;
@@ -1926,7 +2045,7 @@ void CLI2::desugarFilterPlainArgs ()
 
   // Cover the case where the *last* argument is a plain arg.
   auto& penultimate = _args[_args.size () - 2];
-  auto praw         = penultimate.attribute ("raw");
+  auto praw         = penultimate._raw;
   auto& last        = _args[_args.size () - 1];
   if ((penultimate._lextype != Lexer::Type::op     ||  // argX
        praw == "("                                 ||
@@ -1938,9 +2057,9 @@ void CLI2::desugarFilterPlainArgs ()
       (last._lextype == Lexer::Type::identifier    ||  // candidate
        last._lextype == Lexer::Type::word)         &&  // candidate
 
-      last.hasTag ("FILTER"))                          // candidate
+      last.hasTag (A2::Tag::filter))                          // candidate
   {
-    last.tag ("PLAIN");
+    last.tag (A2::Tag::plain);
   }
 
 
@@ -1949,26 +2068,26 @@ void CLI2::desugarFilterPlainArgs ()
   std::vector <A2> reconstructed;
   for (auto& a : _args)
   {
-    if (a.hasTag ("PLAIN"))
+    if (a.hasTag (A2::Tag::plain))
     {
       changes = true;
 
       A2 lhs ("description", Lexer::Type::dom);
       lhs.attribute ("canonical", "description");
-      lhs.tag ("FILTER");
-      lhs.tag ("PLAIN");
+      lhs.tag (A2::Tag::filter);
+      lhs.tag (A2::Tag::plain);
       reconstructed.push_back (lhs);
 
       A2 op ("~", Lexer::Type::op);
-      op.tag ("FILTER");
-      op.tag ("PLAIN");
+      op.tag (A2::Tag::filter);
+      op.tag (A2::Tag::plain);
       reconstructed.push_back (op);
 
-      std::string word = a.attribute ("raw");
+      std::string word = a._raw;
       Lexer::dequote (word);
       A2 rhs (word, Lexer::Type::string);
-      rhs.tag ("FILTER");
-      rhs.tag ("PLAIN");
+      rhs.tag (A2::Tag::filter);
+      rhs.tag (A2::Tag::plain);
       reconstructed.push_back (rhs);
     }
     else
@@ -2001,7 +2120,7 @@ void CLI2::insertJunctions ()
 
   for (auto a = _args.begin (); a != _args.end (); ++a)
   {
-    if (a->hasTag ("FILTER"))
+    if (a->hasTag (A2::Tag::filter))
     {
       // The prev iterator should be the first FILTER arg.
       if (prev == _args.begin ())
@@ -2016,7 +2135,7 @@ void CLI2::insertJunctions ()
             (prev->attribute ("raw") == ")"    && a->attribute ("raw") == "("))
         {
           A2 opOr ("and", Lexer::Type::op);
-          opOr.tag ("FILTER");
+          opOr.tag (A2::Tag::filter);
           reconstructed.push_back (opOr);
           changes = true;
         }
@@ -2057,9 +2176,9 @@ void CLI2::defaultCommand ()
 
   for (auto& a : _args)
   {
-    std::string raw = a.attribute ("raw");
+    std::string raw = a._raw;
 
-    if (a.hasTag ("CMD"))
+    if (a.hasTag (A2::Tag::cmd))
       found_command = true;
 
     if (a._lextype == Lexer::Type::uuid ||
@@ -2092,7 +2211,7 @@ void CLI2::defaultCommand ()
           reconstructedOriginals.push_back (A2 (lexeme, type));
 
           A2 cmd (lexeme, type);
-          cmd.tag ("DEFAULT");
+          cmd.tag (A2::Tag::defaulted);
           reconstructed.push_back (cmd);
         }
 
@@ -2110,7 +2229,7 @@ void CLI2::defaultCommand ()
     else
     {
       A2 info ("information", Lexer::Type::word);
-      info.tag ("ASSUMED");
+      info.tag (A2::Tag::assumed);
       _args.push_back (info);
       changes = true;
     }
@@ -2141,7 +2260,7 @@ std::vector <A2> CLI2::lexExpression (const std::string& expression)
   while (lex.token (lexeme, type))
   {
     A2 token (lexeme, type);
-    token.tag ("FILTER");
+    token.tag (A2::Tag::filter);
     lexed.push_back (token);
   }
 
@@ -2150,9 +2269,9 @@ std::vector <A2> CLI2::lexExpression (const std::string& expression)
   if (lexed.size () > 1)
   {
     A2 openParen  ("(", Lexer::Type::op);
-    openParen.tag ("FILTER");
+    openParen.tag (A2::Tag::filter);
     A2 closeParen (")", Lexer::Type::op);
-    closeParen.tag ("FILTER");
+    closeParen.tag (A2::Tag::filter);
 
     lexed.insert (lexed.begin (), openParen);
     lexed.push_back (closeParen);
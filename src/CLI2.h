@@ -29,30 +29,51 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <bitset>
+#include <memory>
 #include <Lexer.h>
 #include <FS.h>
 
+class Eval;
+
 // Represents a single argument.
 class A2
 {
 public:
+  // Tags are held as a bitset, and the attributes every pass consults as
+  // fixed fields.  The string accessors map names onto both.
+  enum class Tag { binary, cmd, filter, modification, miscellaneous,
+                   rc, config, original, plain, quoted,
+                   defaulted, assumed, terminated, unknown,
+                   readonly, showsid, runsgc, usescontext,
+                   allowsfilter, allowsmodifications, allowsmisc,
+                   count };
+
   A2 (const std::string&, Lexer::Type);
   ~A2 ();
   A2 (const A2&);
   A2& operator= (const A2&);
+  bool hasTag (Tag) const;
+  void tag (Tag);
+  void unTag (Tag);
   bool hasTag (const std::string&) const;
   void tag (const std::string&);
   void unTag (const std::string&);
   void attribute (const std::string&, const std::string&);
-  const std::string attribute (const std::string&) const;
-  const std::string getToken () const;
+  const std::string& attribute (const std::string&) const;
+  const std::string& getToken () const;
   const std::string dump () const;
   void decompose ();
 
 public:
-  Lexer::Type                         _lextype;
-  std::vector <std::string>           _tags;
-  std::map <std::string, std::string> _attributes;
+  Lexer::Type                                   _lextype;
+  std::bitset <static_cast <int> (Tag::count)> _tags;
+  std::string                                   _raw;
+  std::string                                   _canonical;
+  std::string                                   _name;
+  std::string                                   _modifier;
+  std::string                                   _value;
+  std::map <std::string, std::string>           _attributes;
 };
 
 // Represents the command line.
@@ -75,8 +96,10 @@ public:
   void add (const std::vector <std::string>&);
   void analyze ();
   void addFilter (const std::string& arg);
+  void addFilter (const std::vector <std::string>&);
   void addContextFilter ();
   void prepareFilter ();
+  void invalidateFilter ();
   const std::vector <std::string> getWords ();
   bool canonicalize (std::string&, const std::string&, const std::string&) const;
   std::string getBinary () const;
@@ -115,6 +138,13 @@ public:
   std::vector <std::pair <std::string, std::string>> _id_ranges;
   std::vector <std::string>                          _uuid_list;
   bool                                               _context_filter_added;
+  bool                                               _id_filter_only;
+  bool                                               _filter_prepared;
+
+  // The filter compiled from _args, built on first use by Filter, and
+  // discarded by invalidateFilter.  Null if there is no filter.
+  std::unique_ptr <Eval>                             _compiled_filter;
+  bool                                               _filter_compiled;
 };
 
 #endif
@@ -510,25 +510,26 @@ void Color::_colorize (std::string &result, const std::string& input)
 // Remove color codes from a string.
 std::string Color::strip (const std::string& input)
 {
-  int length = input.length ();
-  bool inside = false;
+  // Copy the text between escape sequences in bulk, rather than a character
+  // at a time.
   std::string output;
-  for (int i = 0; i < length; ++i)
+  std::string::size_type start = 0;
+  std::string::size_type escape;
+  while ((escape = input.find ('\033', start)) != std::string::npos)
   {
-    if (inside)
-    {
-      if (input[i] == 'm')
-        inside = false;
-    }
-    else
-    {
-      if (input[i] == 033)
-        inside = true;
-      else
-        output += input[i];
-    }
+    output.append (input, start, escape - start);
+
+    std::string::size_type m = input.find ('m', escape + 1);
+    if (m == std::string::npos)
+      return output;
+
+    start = m + 1;
   }
 
+  if (start == 0)
+    return input;
+
+  output.append (input, start, std::string::npos);
   return output;
 }
 
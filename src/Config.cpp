@@ -34,6 +34,7 @@
 #include <inttypes.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdio.h>
 #include <ISO8601.h>
 #include <FS.h>
 #include <Timer.h>
@@ -62,9 +63,12 @@ std::string Config::_defaults =
   "# Files\n"
   "data.location=~/.task\n"
   "locking=on                                     # Use file-level locking\n"
+  "config.cache=off                               # Keep a parsed image of the configuration\n"
   "gc=on                                          # Garbage-collect data files - DO NOT CHANGE unless you are sure\n"
   "exit.on.missing.db=no                          # Whether to exit if ~/.task is not found\n"
+  "backlog.compact=no                             # Compact backlog.data on every change\n"
   "hooks=on                                       # Master control switch for hooks\n"
+  "hooks.parallel=4                               # Max concurrent on-launch/on-exit hook scripts\n"
   "\n"
   "# Terminal\n"
   "detection=on                                   # Detects terminal width\n"
@@ -270,6 +274,9 @@ std::string Config::_defaults =
   "#taskd.trust=ignore hostname\n"
   "#taskd.trust=allow all\n"
   "taskd.ciphers=NORMAL\n"
+  "taskd.compression=yes\n"
+  "taskd.compression.upload=no\n"
+  "taskd.compression.limit=104857600\n"
   "\n"
   "# Aliases - alternate names for commands\n"
   "alias.rm=delete                                # Alias for the delete command\n"
@@ -382,6 +389,70 @@ std::string Config::_defaults =
   "report.blocking.filter= status:pending +BLOCKING\n"
   "\n";
 
+////////////////////////////////////////////////////////////////////////////////
+// Identifies the layout of a configuration image, see Config::saveImage.
+static const std::string imageMagic = "task-config-image-2";
+
+////////////////////////////////////////////////////////////////////////////////
+// 64-bit FNV-1a, used to recognize unchanged configuration files.
+static uint64_t contentHash (const std::string& input)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  auto end = input.data () + input.length ();
+  for (auto c = input.data (); c != end; ++c)
+  {
+    hash ^= (unsigned char) *c;
+    hash *= 1099511628211ULL;
+  }
+
+  return hash;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void writeImageNumber (std::string& image, uint64_t number)
+{
+  image.append ((const char*) &number, sizeof (number));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void writeImageString (std::string& image, const std::string& text)
+{
+  writeImageNumber (image, text.length ());
+  image += text;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool readImageNumber (const std::string& image, size_t& cursor, uint64_t& number)
+{
+  if (image.length () - cursor < sizeof (number))
+    return false;
+
+  image.copy ((char*) &number, sizeof (number), cursor);
+  cursor += sizeof (number);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool readImageString (const std::string& image, size_t& cursor, std::string& text)
+{
+  uint64_t length;
+  if (! readImageNumber (image, cursor, length) ||
+      image.length () - cursor < length)
+    return false;
+
+  text.assign (image, cursor, length);
+  cursor += length;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Names of the interned keys, indexed by Config::Key.
+static std::vector <std::string>& keyNames ()
+{
+  static std::vector <std::string> names;
+  return names;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // DO NOT CALL Config::setDefaults.
 //
@@ -392,6 +463,8 @@ std::string Config::_defaults =
 // In all real use cases, Config::load is called.
 Config::Config ()
 : _original_file ()
+, _revision (1)
+, _derived_changed (false)
 {
 }
 
@@ -410,17 +483,65 @@ void Config::load (const std::string& file, int nest /* = 1 */)
   if (nest > 10)
     throw std::string (STRING_CONFIG_OVERNEST);
 
-  // First time in, load the default values.
+  // First time in, load the default values, unless an image of the parsed
+  // configuration is still current.
   if (nest == 1)
   {
-    setDefaults ();
     _original_file = File (file);
+    _sources.clear ();
+    _image = "";
+    _image_settings = "";
+    _derived.clear ();
+    _derived_changed = false;
+
+    if (loadImage (file + ".cache"))
+    {
+      _image = file + ".cache";
+      return;
+    }
+
+    setDefaults ();
   }
 
   // Read the file, then parse the contents.
   std::string contents;
-  if (File::read (file, contents) && contents.length ())
-    parse (contents, nest);
+  if (File::read (file, contents))
+  {
+    _sources.push_back (std::pair <std::string, uint64_t> (file, contentHash (contents)));
+    if (contents.length ())
+      parse (contents, nest);
+  }
+
+  if (nest == 1)
+  {
+    File image (file + ".cache");
+    if (getBoolean ("config.cache") && _sources.size ())
+    {
+      // The settings part is kept, so that derived data can be added to the
+      // image later, after overrides have changed the settings in memory.
+      _image = image._data;
+      writeImageString (_image_settings, imageMagic);
+      writeImageNumber (_image_settings, defaultsHash ());
+
+      writeImageNumber (_image_settings, _sources.size ());
+      for (auto& source : _sources)
+      {
+        writeImageString (_image_settings, source.first);
+        writeImageNumber (_image_settings, source.second);
+      }
+
+      writeImageNumber (_image_settings, size ());
+      for (auto& entry : *this)
+      {
+        writeImageString (_image_settings, entry.first);
+        writeImageString (_image_settings, entry.second);
+      }
+
+      saveImage ();
+    }
+    else if (image.exists ())
+      image.remove ();
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -430,6 +551,8 @@ void Config::parse (const std::string& input, int nest /* = 1 */)
   if (input.length () == 0)
     return;
 
+  ++_revision;
+
   // Split the input into lines.
   std::vector <std::string> lines;
   split (lines, input, "\n");
@@ -478,6 +601,174 @@ void Config::parse (const std::string& input, int nest /* = 1 */)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// An image holds the parsed configuration, preceded by what it was parsed
+// from: the built-in defaults, and every file in the include chain, in order.
+// It is only used while all of those are unchanged.
+bool Config::loadImage (const std::string& file)
+{
+  std::ifstream in (file.c_str (), std::ios::binary);
+  if (! in.good ())
+    return false;
+
+  std::stringstream buffer;
+  buffer << in.rdbuf ();
+  std::string image = buffer.str ();
+
+  size_t cursor = 0;
+  std::string text;
+  uint64_t number;
+  if (! readImageString (image, cursor, text)   ||
+      text != imageMagic                        ||
+      ! readImageNumber (image, cursor, number) ||
+      number != defaultsHash ())
+    return false;
+
+  // Every file that was read must still have the same contents.
+  uint64_t count;
+  if (! readImageNumber (image, cursor, count))
+    return false;
+
+  std::vector <std::pair <std::string, uint64_t>> sources;
+  std::string contents;
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    if (! readImageString (image, cursor, text)   ||
+        ! readImageNumber (image, cursor, number) ||
+        ! File::read (text, contents)             ||
+        contentHash (contents) != number)
+      return false;
+
+    sources.push_back (std::pair <std::string, uint64_t> (text, number));
+  }
+
+  // Entries were written in key order, so each insertion is at the end.
+  std::map <std::string, std::string> entries;
+  std::string value;
+  if (! readImageNumber (image, cursor, count))
+    return false;
+
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    if (! readImageString (image, cursor, text) ||
+        ! readImageString (image, cursor, value))
+      return false;
+
+    entries.emplace_hint (entries.end (), text, value);
+  }
+
+  // Then the derived data, each a name and a list of strings.
+  size_t settings = cursor;
+  std::map <std::string, std::vector <std::string>> derived;
+  if (! readImageNumber (image, cursor, count))
+    return false;
+
+  for (uint64_t i = 0; i < count; ++i)
+  {
+    uint64_t length;
+    if (! readImageString (image, cursor, text) ||
+        ! readImageNumber (image, cursor, length))
+      return false;
+
+    auto& data = derived[text];
+    for (uint64_t j = 0; j < length; ++j)
+    {
+      if (! readImageString (image, cursor, value))
+        return false;
+
+      data.push_back (value);
+    }
+  }
+
+  if (cursor != image.length ())
+    return false;
+
+  std::map <std::string, std::string>::swap (entries);
+  _sources.swap (sources);
+  _image_settings = image.substr (0, settings);
+  _derived.swap (derived);
+  ++_revision;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The image is written to a temporary file and renamed, so that a concurrent
+// task never reads a partial image.  Failure is silent, because the image is
+// only an optimization.
+void Config::saveImage () const
+{
+  std::string image = _image_settings;
+  writeImageNumber (image, _derived.size ());
+  for (auto& data : _derived)
+  {
+    writeImageString (image, data.first);
+    writeImageNumber (image, data.second.size ());
+    for (auto& value : data.second)
+      writeImageString (image, value);
+  }
+
+  std::string temporary = _image + "." + format ((int) getpid ());
+  std::ofstream out (temporary.c_str (), std::ios::binary | std::ios::trunc);
+  if (out.good ())
+  {
+    // The configuration may hold credentials.
+    chmod (temporary.c_str (), 0600);
+    out.write (image.data (), image.length ());
+    out.close ();
+
+    if (out.good () &&
+        rename (temporary.c_str (), _image.c_str ()) == 0)
+      return;
+  }
+
+  unlink (temporary.c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Config::getDerived (
+  const std::string& name,
+  std::vector <std::string>& data) const
+{
+  auto found = _derived.find (name);
+  if (found == _derived.end ())
+    return false;
+
+  data = found->second;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The caller must be able to tell whether derived data still matches the
+// settings, which may since have been overridden.
+void Config::setDerived (
+  const std::string& name,
+  const std::vector <std::string>& data)
+{
+  auto& stored = _derived[name];
+  if (stored != data)
+  {
+    stored = data;
+    _derived_changed = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Writes the image again if derived data was added, and the image is kept.
+void Config::saveDerived ()
+{
+  if (_derived_changed && _image != "")
+    saveImage ();
+
+  _derived_changed = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+uint64_t Config::defaultsHash ()
+{
+  static uint64_t hash = contentHash (_defaults);
+  return hash;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Config::createDefaultRC (const std::string& rc, const std::string& data)
 {
@@ -542,6 +833,7 @@ void Config::setDefaults ()
 void Config::clear ()
 {
   std::map <std::string, std::string>::clear ();
+  ++_revision;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -605,18 +897,75 @@ bool Config::getBoolean (const std::string& key)
 void Config::set (const std::string& key, const int value)
 {
   (*this)[key] = format (value);
+  ++_revision;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Config::set (const std::string& key, const double value)
 {
   (*this)[key] = format (value, 1, 8);
+  ++_revision;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Config::set (const std::string& key, const std::string& value)
 {
   (*this)[key] = value;
+  ++_revision;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keys are shared by all Config objects, and are never released.
+Config::Key Config::key (const std::string& name)
+{
+  static std::map <std::string, Key> keys;
+
+  auto i = keys.find (name);
+  if (i != keys.end ())
+    return i->second;
+
+  Key handle = keys.size ();
+  keys[name] = handle;
+  keyNames ().push_back (name);
+  return handle;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Config::getInteger (Key handle)
+{
+  return value (handle).integer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+double Config::getReal (Key handle)
+{
+  return value (handle).real;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Config::getBoolean (Key handle)
+{
+  return value (handle).boolean;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Values are parsed by the string accessors, so that the two always agree.
+const Config::Value& Config::value (Key handle)
+{
+  if (handle >= _values.size ())
+    _values.resize (handle + 1, Value {0, 0, 0.0, false});
+
+  auto& v = _values[handle];
+  if (v.revision != _revision)
+  {
+    auto& name = keyNames ()[handle];
+    v.integer  = getInteger (name);
+    v.real     = getReal    (name);
+    v.boolean  = getBoolean (name);
+    v.revision = _revision;
+  }
+
+  return v;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
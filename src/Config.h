@@ -30,6 +30,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include <stdint.h>
 #include <FS.h>
 
 class Config : public std::map <std::string, std::string>
@@ -58,11 +59,50 @@ public:
   void set (const std::string&, const std::string&);
   void all (std::vector <std::string>&) const;
 
+  // Interned keys, for code that reads a setting per task or per row.  The
+  // value is parsed once, and again only after the configuration changes.
+  typedef unsigned int Key;
+  static Key  key        (const std::string&);
+  int         getInteger (Key);
+  double      getReal    (Key);
+  bool        getBoolean (Key);
+
+  // Changes whenever any setting does.
+  unsigned int revision () const { return _revision; }
+
+  // Data derived from the configuration, such as a compiled report, which is
+  // kept in the configuration image along with the settings it came from.
+  bool getDerived (const std::string&, std::vector <std::string>&) const;
+  void setDerived (const std::string&, const std::vector <std::string>&);
+  void saveDerived ();
+
 public:
   File _original_file;
 
+private:
+  struct Value
+  {
+    unsigned int revision;
+    int          integer;
+    double       real;
+    bool         boolean;
+  };
+
+  const Value& value (Key);
+
+  bool loadImage (const std::string&);
+  void saveImage () const;
+  static uint64_t defaultsHash ();
+
 private:
   static std::string _defaults;
+  unsigned int _revision;
+  std::vector <Value> _values;
+  std::vector <std::pair <std::string, uint64_t>> _sources;
+  std::string _image;             // Image file, when the image is kept
+  std::string _image_settings;    // The image, up to the derived data
+  std::map <std::string, std::vector <std::string>> _derived;
+  bool _derived_changed;
 };
 
 #endif
@@ -84,11 +84,6 @@ Context::Context ()
 ////////////////////////////////////////////////////////////////////////////////
 Context::~Context ()
 {
-  for (auto& com : commands)
-    delete com.second;
-
-  for (auto& col : columns)
-    delete col.second;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -111,6 +106,7 @@ int Context::initialize (int argc, const char** argv)
     //
     ////////////////////////////////////////////////////////////////////////////
 
+    timer_init_config.start ();
     CLI2::getOverride (argc, argv, home_dir, rc_file);
 
     char* override = getenv ("TASKRC");
@@ -124,6 +120,10 @@ int Context::initialize (int argc, const char** argv)
     config.load (rc_file);
     CLI2::applyOverrides (argc, argv);
 
+    // Spans are only recorded from here on, once rc.profile is known.
+    Profiler::enable (Profiler::parse (config.get ("profile")));
+    Profiler::Span span ("Context::initialize");
+
     ////////////////////////////////////////////////////////////////////////////
     //
     // [2] Locate the data directory.
@@ -147,28 +147,40 @@ int Context::initialize (int argc, const char** argv)
 
     tdb2.set_location (data_dir);
     createDefaultConfig ();
+    timer_init_config.stop ();
 
     ////////////////////////////////////////////////////////////////////////////
     //
-    // [3] Instantiate Command objects and capture command entities.
+    // [3] Register Command objects and capture command entities.  Only the
+    //     command that runs is constructed.
     //
     ////////////////////////////////////////////////////////////////////////////
 
+    timer_init_commands.start ();
     Command::factory (commands);
-    for (auto& cmd : commands)
-      cli2.entity ("cmd", cmd.first);
+    for (auto& cmd : commands.names ())
+      cli2.entity ("cmd", cmd);
+    timer_init_commands.stop ();
 
     ////////////////////////////////////////////////////////////////////////////
     //
-    // [4] Instantiate Column objects and capture column entities.
+    // [4] Register Column objects and capture column entities and types.
+    //     Columns are constructed on first use.
     //
     ////////////////////////////////////////////////////////////////////////////
 
-    Column::factory (columns);
-    for (auto& col : columns)
-      cli2.entity ("attribute", col.first);
+    timer_init_columns.start ();
+    std::map <std::string, std::string> types;
+    Column::factory (columns, types);
+    for (auto& type : types)
+    {
+      cli2.entity ("attribute", type.first);
+      Task::attributes[type.first] = type.second;
+      Lexer::attributes[type.first] = type.second;
+    }
 
     cli2.entity ("pseudo", "limit");
+    timer_init_columns.stop ();
 
     ////////////////////////////////////////////////////////////////////////////
     //
@@ -202,10 +214,12 @@ int Context::initialize (int argc, const char** argv)
     //
     ////////////////////////////////////////////////////////////////////////////
 
+    timer_init_cli.start ();
     for (int i = 0; i < argc; i++)
       cli2.add (argv[i]);
 
     cli2.analyze ();
+    timer_init_cli.stop ();
 
     // Extract a recomposed command line.
     bool foundDefault = false;
@@ -312,10 +326,13 @@ int Context::run ()
 
   try
   {
+    Profiler::Span span ("Context::run");
     hooks.onLaunch ();
     rc = dispatch (output);
     tdb2.commit ();           // Harmless if called when nothing changed.
+    config.saveDerived ();    // Likewise.
     hooks.onExit ();          // No chance to update data.
+    span.stop ();
 
     timer_total.stop ();
 
@@ -332,6 +349,10 @@ int Context::run ()
       << ISO8601d ().toISO ()
 
       << " init:"   << timer_init.total ()
+      << " init.config:"   << timer_init_config.total ()
+      << " init.commands:" << timer_init_commands.total ()
+      << " init.columns:"  << timer_init_columns.total ()
+      << " init.cli:"      << timer_init_cli.total ()
       << " load:"   << timer_load.total ()
       << " gc:"     << timer_gc.total ()
       << " filter:" << timer_filter.total ()
@@ -412,6 +433,16 @@ int Context::run ()
     else
       std::cerr << e << "\n";
 
+  // Dump the profile, controlled by rc.profile, to rc.profile.file or stderr.
+  if (Profiler::enabled ())
+  {
+    std::string file = config.get ("profile.file");
+    if (file != "")
+      File::write (file, Profiler::render ());
+    else
+      std::cerr << Profiler::render ();
+  }
+
   return rc;
 }
 
@@ -584,11 +615,7 @@ bool Context::verbose (const std::string& token)
 ////////////////////////////////////////////////////////////////////////////////
 const std::vector <std::string> Context::getColumns () const
 {
-  std::vector <std::string> output;
-  for (auto& col : columns)
-    output.push_back (col.first);
-
-  return output;
+  return columns.names ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -638,26 +665,6 @@ void Context::staticInitialization ()
 
   ISO8601d::weekstart       = config.get ("weekstart");
 
-  for (auto& rc : config)
-  {
-    if (rc.first.substr (0, 4) == "uda." &&
-        rc.first.substr (rc.first.length () - 7, 7) == ".values")
-    {
-      std::string name = rc.first.substr (4, rc.first.length () - 7 - 4);
-      std::vector <std::string> values;
-      split (values, rc.second, ',');
-
-      for (auto r = values.rbegin(); r != values.rend (); ++r)
-        Task::customOrder[name].push_back (*r);
-    }
-  }
-
-  for (auto& col : columns)
-  {
-    Task::attributes[col.first] = col.second->type ();
-    Lexer::attributes[col.first] = col.second->type ();
-  }
-
   Task::urgencyProjectCoefficient     = config.getReal ("urgency.project.coefficient");
   Task::urgencyActiveCoefficient      = config.getReal ("urgency.active.coefficient");
   Task::urgencyScheduledCoefficient   = config.getReal ("urgency.scheduled.coefficient");
@@ -670,13 +677,30 @@ void Context::staticInitialization ()
   Task::urgencyAgeCoefficient         = config.getReal ("urgency.age.coefficient");
   Task::urgencyAgeMax                 = config.getReal ("urgency.age.max");
 
-  // Tag- and project-specific coefficients.
-  std::vector <std::string> all;
-  config.all (all);
-  for (auto& var : all)
-    if (var.substr (0, 13) == "urgency.user." ||
-        var.substr (0, 12) == "urgency.uda.")
-      Task::coefficients[var] = config.getReal (var);
+  // UDA value orders, and tag- and project-specific coefficients, in a single
+  // pass over the configuration.
+  for (auto& rc : config)
+  {
+    if (rc.first.compare (0, 4, "uda.") == 0)
+    {
+      if (rc.first.length () > 11 &&
+          rc.first.compare (rc.first.length () - 7, 7, ".values") == 0)
+      {
+        std::string name = rc.first.substr (4, rc.first.length () - 7 - 4);
+        std::vector <std::string> values;
+        split (values, rc.second, ',');
+
+        for (auto r = values.rbegin(); r != values.rend (); ++r)
+          Task::customOrder[name].push_back (*r);
+      }
+    }
+    else if (rc.first.compare (0, 13, "urgency.user.") == 0 ||
+             rc.first.compare (0, 12, "urgency.uda.") == 0)
+      Task::coefficients[rc.first] = config.getReal (rc.first);
+  }
+
+  // Taken last, as the named dates depend on the settings above.
+  snapshot.take (config.getInteger ("due"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -37,6 +37,8 @@
 #include <FS.h>
 #include <CLI2.h>
 #include <Timer.h>
+#include <Profiler.h>
+#include <TimeSnapshot.h>
 #include <set>
 
 class Context
@@ -99,14 +101,20 @@ public:
   std::vector <std::string>           errors;
   std::vector <std::string>           debugMessages;
 
-  std::map <std::string, Command*>    commands;
-  std::map <std::string, Column*>     columns;
+  Registry <Command>                  commands;
+  Registry <Column>                   columns;
 
   int                                 terminal_width;
   int                                 terminal_height;
 
+  TimeSnapshot                        snapshot;
+
   Timer                               timer_total;
   Timer                               timer_init;
+  Timer                               timer_init_config;
+  Timer                               timer_init_commands;
+  Timer                               timer_init_columns;
+  Timer                               timer_init_cli;
   Timer                               timer_load;
   Timer                               timer_gc;
   Timer                               timer_filter;
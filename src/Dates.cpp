@@ -27,14 +27,18 @@
 #include <cmake.h>
 #include <Dates.h>
 #include <algorithm>
+#include <unordered_map>
 #include <stdlib.h>
 #include <time.h>
 #include <text.h>
 #include <ISO8601.h>
 #include <Lexer.h>
 #include <CLI2.h>
+#include <Context.h>
 #include <i18n.h>
 
+extern Context context;
+
 ////////////////////////////////////////////////////////////////////////////////
 static bool isMonth (const std::string& name, int& i)
 {
@@ -131,10 +135,11 @@ static void midsommarafton (struct tm* t)
 //   midsommar      = midnight, 1st Saturday after 20th June
 //   midsommarafton = midnight, 1st Friday after 19th June
 //
-bool namedDates (const std::string& name, Variant& value)
+static bool resolveNamedDate (const std::string& name, Variant& value)
 {
-  time_t now = time (NULL);
-  struct tm* t = localtime (&now);
+  time_t now = context.snapshot.now;
+  struct tm local = context.snapshot.local;
+  struct tm* t = &local;
   int i;
 
   int minimum = CLI2::minimumMatchLength;
@@ -516,4 +521,32 @@ bool namedDates (const std::string& name, Variant& value)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Names resolve against the command's time snapshot, so each name, whether it
+// is a date or not, is only resolved once per snapshot.
+bool namedDates (const std::string& name, Variant& value)
+{
+  static int revision = -1;
+  static std::unordered_map <std::string, std::pair <bool, Variant>> resolved;
+
+  if (revision != context.snapshot.revision)
+  {
+    resolved.clear ();
+    revision = context.snapshot.revision;
+  }
+
+  auto i = resolved.find (name);
+  if (i == resolved.end ())
+  {
+    Variant date;
+    bool found = resolveNamedDate (name, date);
+    i = resolved.insert ({name, {found, date}}).first;
+  }
+
+  if (i->second.first)
+    value = i->second.second;
+
+  return i->second.first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
@@ -164,6 +164,7 @@ void Eval::evaluatePostfixExpression (const std::string& e, Variant& v) const
 void Eval::compileExpression (
   const std::vector <std::pair <std::string, Lexer::Type>>& precompiled)
 {
+  Profiler::Span span ("Eval::compileExpression");
   _compiled = precompiled;
 
   // Parse for syntax checking and operator replacement.
@@ -177,13 +178,25 @@ void Eval::compileExpression (
   infixToPostfix (_compiled);
   if (_debug)
     context.debug ("[1;37;42mFILTER[0m Postfix      " + dump (_compiled));
+
+  // Literals are the same for every evaluation, so are converted only once.
+  _literals.assign (_compiled.size (), Variant ());
+  for (unsigned int i = 0; i < _compiled.size (); ++i)
+    if (_compiled[i].second != Lexer::Type::op         &&
+        _compiled[i].second != Lexer::Type::dom        &&
+        _compiled[i].second != Lexer::Type::identifier)
+      evaluateLiteral (_compiled[i], _literals[i]);
+
+  precastLiterals ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Eval::evaluateCompiledExpression (Variant& v)
 {
+  Profiler::Span span ("Eval::evaluateCompiledExpression");
+
   // Call the postfix evaluator.
-  evaluatePostfixStack (_compiled, v);
+  evaluatePostfixStack (_compiled, v, &_literals);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -218,16 +231,20 @@ std::vector <std::string> Eval::getBinaryOperators ()
 ////////////////////////////////////////////////////////////////////////////////
 void Eval::evaluatePostfixStack (
   const std::vector <std::pair <std::string, Lexer::Type>>& tokens,
-  Variant& result) const
+  Variant& result,
+  const std::vector <Variant>* literals /* = nullptr */) const
 {
   if (tokens.size () == 0)
     throw std::string (STRING_EVAL_NO_EXPRESSION);
 
   // This is stack used by the postfix evaluator.
   std::vector <Variant> values;
+  values.reserve (tokens.size ());
 
-  for (auto& token : tokens)
+  for (unsigned int i = 0; i < tokens.size (); ++i)
   {
+    auto& token = tokens[i];
+
     // Unary operators.
     if (token.second == Lexer::Type::op &&
         token.first == "!")
@@ -235,7 +252,7 @@ void Eval::evaluatePostfixStack (
       if (values.size () < 1)
         throw std::string (STRING_EVAL_NO_EVAL);
 
-      Variant right = values.back ();
+      Variant right = std::move (values.back ());
       values.pop_back ();
       Variant result = ! right;
       values.push_back (result);
@@ -248,7 +265,7 @@ void Eval::evaluatePostfixStack (
       if (values.size () < 1)
         throw std::string (STRING_EVAL_NO_EVAL);
 
-      Variant right = values.back ();
+      Variant right = std::move (values.back ());
       values.pop_back ();
 
       Variant result (0);
@@ -272,10 +289,10 @@ void Eval::evaluatePostfixStack (
       if (values.size () < 2)
         throw std::string (STRING_EVAL_NO_EVAL);
 
-      Variant right = values.back ();
+      Variant right = std::move (values.back ());
       values.pop_back ();
 
-      Variant left = values.back ();
+      Variant left = std::move (values.back ());
       values.pop_back ();
 
       // Ordering these by anticipation frequency of use is a good idea.
@@ -312,77 +329,43 @@ void Eval::evaluatePostfixStack (
         context.debug (format ("Eval ↓'{1}' {2} ↓'{3}' → ↑'{4}'", (std::string) left, token.first, (std::string) right, (std::string) result));
     }
 
-    // Literals and identifiers.
-    else
+    // Identifiers.
+    else if (token.second == Lexer::Type::dom ||
+             token.second == Lexer::Type::identifier)
     {
       Variant v (token.first);
-      switch (token.second)
+      bool found = false;
+      for (auto source = _sources.begin (); source != _sources.end (); ++source)
       {
-      case Lexer::Type::number:
-        if (Lexer::isAllDigits (token.first))
-        {
-          v.cast (Variant::type_integer);
-          if (_debug)
-            context.debug (format ("Eval literal number ↑'{1}'", (std::string) v));
-        }
-        else
+        if ((*source) (token.first, v))
         {
-          v.cast (Variant::type_real);
           if (_debug)
-            context.debug (format ("Eval literal decimal ↑'{1}'", (std::string) v));
-        }
-        break;
-
-      case Lexer::Type::op:
-        throw std::string (STRING_EVAL_OP_EXPECTED);
-        break;
-
-      case Lexer::Type::dom:
-      case Lexer::Type::identifier:
-        {
-          bool found = false;
-          for (auto source = _sources.begin (); source != _sources.end (); ++source)
-          {
-            if ((*source) (token.first, v))
-            {
-              if (_debug)
-                context.debug (format ("Eval identifier source '{1}' → ↑'{2}'", token.first, (std::string) v));
-              found = true;
-              break;
-            }
-          }
-
-          // An identifier that fails lookup is a string.
-          if (!found)
-          {
-            v.cast (Variant::type_string);
-            if (_debug)
-              context.debug (format ("Eval identifier source failed '{1}'", token.first));
-          }
+            context.debug (format ("Eval identifier source '{1}' → ↑'{2}'", token.first, (std::string) v));
+          found = true;
+          break;
         }
-        break;
+      }
 
-      case Lexer::Type::date:
-        v.cast (Variant::type_date);
+      // An identifier that fails lookup is a string.
+      if (!found)
+      {
+        v.cast (Variant::type_string);
         if (_debug)
-          context.debug (format ("Eval literal date ↑'{1}'", (std::string) v));
-        break;
+          context.debug (format ("Eval identifier source failed '{1}'", token.first));
+      }
 
-      case Lexer::Type::duration:
-        v.cast (Variant::type_duration);
-        if (_debug)
-          context.debug (format ("Eval literal duration ↑'{1}'", (std::string) v));
-        break;
+      values.push_back (std::move (v));
+    }
 
-      // Nothing to do.
-      case Lexer::Type::string:
-      default:
-        if (_debug)
-          context.debug (format ("Eval literal string ↑'{1}'", (std::string) v));
-        break;
-      }
+    // Literals, which a compiled expression has already converted.
+    else if (literals)
+      values.push_back ((*literals)[i]);
 
-      values.push_back (v);
+    else
+    {
+      Variant v;
+      evaluateLiteral (token, v);
+      values.push_back (std::move (v));
     }
   }
 
@@ -394,6 +377,88 @@ void Eval::evaluatePostfixStack (
   result = values[0];
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Eval::evaluateLiteral (
+  const std::pair <std::string, Lexer::Type>& token,
+  Variant& v) const
+{
+  v = Variant (token.first);
+  switch (token.second)
+  {
+  case Lexer::Type::number:
+    if (Lexer::isAllDigits (token.first))
+    {
+      v.cast (Variant::type_integer);
+      if (_debug)
+        context.debug (format ("Eval literal number ↑'{1}'", (std::string) v));
+    }
+    else
+    {
+      v.cast (Variant::type_real);
+      if (_debug)
+        context.debug (format ("Eval literal decimal ↑'{1}'", (std::string) v));
+    }
+    break;
+
+  case Lexer::Type::op:
+    throw std::string (STRING_EVAL_OP_EXPECTED);
+    break;
+
+  case Lexer::Type::date:
+    v.cast (Variant::type_date);
+    if (_debug)
+      context.debug (format ("Eval literal date ↑'{1}'", (std::string) v));
+    break;
+
+  case Lexer::Type::duration:
+    v.cast (Variant::type_duration);
+    if (_debug)
+      context.debug (format ("Eval literal duration ↑'{1}'", (std::string) v));
+    break;
+
+  // Nothing to do.
+  case Lexer::Type::string:
+  default:
+    if (_debug)
+      context.debug (format ("Eval literal string ↑'{1}'", (std::string) v));
+    break;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A string literal that is an operand alongside a date or duration attribute,
+// as in 'due < eow', is cast to that type on every evaluation.  Resolve those
+// casts once, here.  The literal remains a string, so that it still compares
+// as one when the task lacks the attribute.
+void Eval::precastLiterals ()
+{
+  for (unsigned int i = 2; i < _compiled.size (); ++i)
+  {
+    if (_compiled[i].second     != Lexer::Type::op ||
+        _compiled[i - 1].second == Lexer::Type::op ||
+        _compiled[i - 2].second == Lexer::Type::op)
+      continue;
+
+    for (auto operand : {i - 2, i - 1})
+    {
+      auto& token = _compiled[operand];
+      if (token.second != Lexer::Type::dom &&
+          token.second != Lexer::Type::identifier)
+        continue;
+
+      unsigned int other = operand == i - 1 ? i - 2 : i - 1;
+      auto type = Task::attributes.find (token.first);
+      if (type == Task::attributes.end ())
+        continue;
+
+      if (type->second == "date")
+        _literals[other].precast (Variant::type_date);
+      else if (type->second == "duration")
+        _literals[other].precast (Variant::type_duration);
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 // Grammar:
@@ -51,7 +51,9 @@ public:
   static std::vector <std::string> getBinaryOperators ();
 
 private:
-  void evaluatePostfixStack (const std::vector <std::pair <std::string, Lexer::Type>>&, Variant&) const;
+  void evaluatePostfixStack (const std::vector <std::pair <std::string, Lexer::Type>>&, Variant&, const std::vector <Variant>* literals = nullptr) const;
+  void evaluateLiteral (const std::pair <std::string, Lexer::Type>&, Variant&) const;
+  void precastLiterals ();
   void infixToPostfix (std::vector <std::pair <std::string, Lexer::Type>>&) const;
   void infixParse (std::vector <std::pair <std::string, Lexer::Type>>&) const;
   bool parseLogical (std::vector <std::pair <std::string, Lexer::Type>>&, unsigned int &) const;
@@ -72,6 +74,7 @@ private:
   std::vector <bool (*)(const std::string&, Variant&)> _sources;
   bool _debug;
   std::vector <std::pair <std::string, Lexer::Type>> _compiled;
+  std::vector <Variant> _literals;
 };
 
 
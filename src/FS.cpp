@@ -458,6 +458,21 @@ void File::unlock ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// True if the open file is no longer the one at its path, because it was
+// removed, or another file was renamed over it.
+bool File::replaced () const
+{
+  struct stat opened;
+  struct stat named;
+  if (_h == -1 || fstat (_h, &opened))
+    return false;
+
+  return stat (_data.c_str (), &named)    ||
+         opened.st_dev != named.st_dev ||
+         opened.st_ino != named.st_ino;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Opens if necessary.
 void File::read (std::string& contents)
@@ -85,6 +85,7 @@ public:
 
   bool lock ();
   void unlock ();
+  bool replaced () const;
 
   void read (std::string&);
   void read (std::vector <std::string>&);
@@ -66,26 +66,14 @@ Filter::Filter ()
 // Take an input set of tasks and filter into a subset.
 void Filter::subset (const std::vector <Task>& input, std::vector <Task>& output)
 {
+  Profiler::Span span ("Filter::subset");
   context.timer_filter.start ();
   _startCount = (int) input.size ();
 
-  context.cli2.prepareFilter ();
-
-  std::vector <std::pair <std::string, Lexer::Type>> precompiled;
-  for (auto& a : context.cli2._args)
-    if (a.hasTag ("FILTER"))
-      precompiled.push_back (std::pair <std::string, Lexer::Type> (a.getToken (), a._lextype));
-
-  if (precompiled.size ())
+  Eval* eval = compiled ();
+  if (eval)
   {
-    Eval eval;
-    eval.addSource (domSource);
-    eval.addSource (namedDates);
-
-    // Debug output from Eval during compilation is useful.  During evaluation
-    // it is mostly noise.
-    eval.debug (context.config.getInteger ("debug.parser") >= 3 ? true : false);
-    eval.compileExpression (precompiled);
+    eval->debug (context.config.getInteger ("debug.parser") >= 3 ? true : false);
 
     for (auto& task : input)
     {
@@ -93,12 +81,12 @@ void Filter::subset (const std::vector <Task>& input, std::vector <Task>& output
       contextTask = task;
 
       Variant var;
-      eval.evaluateCompiledExpression (var);
+      eval->evaluateCompiledExpression (var);
       if (var.get_bool ())
         output.push_back (task);
     }
 
-    eval.debug (false);
+    eval->debug (false);
   }
   else
     output = input;
@@ -112,33 +100,30 @@ void Filter::subset (const std::vector <Task>& input, std::vector <Task>& output
 // Take the set of all tasks and filter into a subset.
 void Filter::subset (std::vector <Task>& output)
 {
+  Profiler::Span span ("Filter::subset");
   context.timer_filter.start ();
 
   context.cli2.prepareFilter ();
+  if (context.cli2._id_filter_only &&
+      selectByID (output))
+  {
+    context.timer_filter.stop ();
+    return;
+  }
 
-  std::vector <std::pair <std::string, Lexer::Type>> precompiled;
-  for (auto& a : context.cli2._args)
-    if (a.hasTag ("FILTER"))
-      precompiled.push_back (std::pair <std::string, Lexer::Type> (a.getToken (), a._lextype));
+  Eval* eval = compiled ();
 
   // Shortcut indicates that only pending.data needs to be loaded.
   bool shortcut = false;
 
-  if (precompiled.size ())
+  if (eval)
   {
     context.timer_filter.stop ();
     auto pending = context.tdb2.pending.get_tasks ();
     context.timer_filter.start ();
     _startCount = (int) pending.size ();
 
-    Eval eval;
-    eval.addSource (domSource);
-    eval.addSource (namedDates);
-
-    // Debug output from Eval during compilation is useful.  During evaluation
-    // it is mostly noise.
-    eval.debug (context.config.getInteger ("debug.parser") >= 3 ? true : false);
-    eval.compileExpression (precompiled);
+    eval->debug (context.config.getInteger ("debug.parser") >= 3 ? true : false);
 
     output.clear ();
     for (auto& task : pending)
@@ -147,7 +132,7 @@ void Filter::subset (std::vector <Task>& output)
       contextTask = task;
 
       Variant var;
-      eval.evaluateCompiledExpression (var);
+      eval->evaluateCompiledExpression (var);
       if (var.get_bool ())
         output.push_back (task);
     }
@@ -166,13 +151,13 @@ void Filter::subset (std::vector <Task>& output)
         contextTask = task;
 
         Variant var;
-        eval.evaluateCompiledExpression (var);
+        eval->evaluateCompiledExpression (var);
         if (var.get_bool ())
           output.push_back (task);
       }
     }
 
-    eval.debug (false);
+    eval->debug (false);
   }
   else
   {
@@ -193,11 +178,106 @@ void Filter::subset (std::vector <Task>& output)
   context.timer_filter.stop ();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// When the filter is nothing but IDs and UUIDs, the tasks are looked up
+// directly, instead of evaluating the filter against every task.  Only pending
+// tasks have IDs, and the UUIDs must be complete and belong to pending tasks,
+// otherwise this returns false, and the filter is evaluated as usual.  IDs are
+// assigned in pending.data order, so the output is in the same order as the
+// evaluated filter would produce.
+bool Filter::selectByID (std::vector <Task>& output)
+{
+  context.timer_filter.stop ();
+  auto& pending = context.tdb2.pending.get_tasks ();
+  context.timer_filter.start ();
+
+  int latest = context.tdb2.latest_id ();
+
+  std::vector <int> ids;
+  for (auto& range : context.cli2._id_ranges)
+  {
+    if (! Lexer::isAllDigits (range.first) ||
+        ! Lexer::isAllDigits (range.second))
+      return false;
+
+    int low  = strtol (range.first.c_str (),  NULL, 10);
+    int high = strtol (range.second.c_str (), NULL, 10);
+    if (low > high)
+      std::swap (low, high);
+
+    // An ID of zero would match completed tasks.
+    if (low < 1)
+      return false;
+
+    for (int id = low; id <= std::min (high, latest); ++id)
+      ids.push_back (id);
+  }
+
+  for (auto& uuid : context.cli2._uuid_list)
+  {
+    int id = uuid.length () == 36 ? context.tdb2.pending.id (uuid) : 0;
+    if (! id)
+      return false;
+
+    ids.push_back (id);
+  }
+
+  std::sort (ids.begin (), ids.end ());
+  ids.erase (std::unique (ids.begin (), ids.end ()), ids.end ());
+
+  output.clear ();
+  for (auto id : ids)
+  {
+    Task task;
+    if (context.tdb2.pending.get (id, task))
+      output.push_back (task);
+  }
+
+  _startCount = (int) pending.size ();
+  _endCount = (int) output.size ();
+  context.debug (format ("Filtered {1} tasks --> {2} tasks [ID lookup]", _startCount, _endCount));
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The filter only changes when the command line is analyzed again, so it is
+// compiled once per analysis, kept with the arguments in CLI2, and shared by
+// every subset call.  Returns null if there is no filter.
+Eval* Filter::compiled ()
+{
+  CLI2& cli = context.cli2;
+  cli.prepareFilter ();
+
+  if (! cli._filter_compiled)
+  {
+    std::vector <std::pair <std::string, Lexer::Type>> precompiled;
+    for (auto& a : cli._args)
+      if (a.hasTag (A2::Tag::filter))
+        precompiled.push_back (std::pair <std::string, Lexer::Type> (a.getToken (), a._lextype));
+
+    if (precompiled.size ())
+    {
+      cli._compiled_filter.reset (new Eval);
+      cli._compiled_filter->addSource (domSource);
+      cli._compiled_filter->addSource (namedDates);
+
+      // Debug output from Eval during compilation is useful.
+      cli._compiled_filter->debug (context.config.getInteger ("debug.parser") >= 3 ? true : false);
+      cli._compiled_filter->compileExpression (precompiled);
+      cli._compiled_filter->debug (false);
+    }
+
+    cli._filter_compiled = true;
+  }
+
+  return cli._compiled_filter.get ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool Filter::hasFilter ()
 {
   for (auto& a : context.cli2._args)
-    if (a.hasTag ("FILTER"))
+    if (a.hasTag (A2::Tag::filter))
       return true;
 
   return false;
@@ -231,10 +311,10 @@ bool Filter::pendingOnly ()
 
   for (auto& a : context.cli2._args)
   {
-    if (a.hasTag ("FILTER"))
+    if (a.hasTag (A2::Tag::filter))
     {
-      std::string raw       = a.attribute ("raw");
-      std::string canonical = a.attribute ("canonical");
+      const std::string& raw       = a._raw;
+      const std::string& canonical = a._canonical;
 
       if (a._lextype == Lexer::Type::op  && raw == "or")           ++countOr;
       if (a._lextype == Lexer::Type::op  && raw == "xor")          ++countXor;
@@ -277,11 +357,11 @@ void Filter::safety ()
     bool filter = false;
     for (auto& a : context.cli2._args)
     {
-      if (a.hasTag ("CMD") &&
-          ! a.hasTag ("READONLY"))
+      if (a.hasTag (A2::Tag::cmd) &&
+          ! a.hasTag (A2::Tag::readonly))
         readonly = false;
 
-      if (a.hasTag ("FILTER"))
+      if (a.hasTag (A2::Tag::filter))
         filter = true;
     }
 
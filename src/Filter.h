@@ -32,6 +32,8 @@
 #include <Task.h>
 #include <Variant.h>
 
+class Eval;
+
 bool domSource (const std::string&, Variant&);
 
 class Filter
@@ -45,6 +47,10 @@ public:
   bool pendingOnly ();
   void safety ();
   void disableSafety ();
+  Eval* compiled ();
+
+private:
+  bool selectByID (std::vector <Task>&);
 
 private:
   int  _startCount;
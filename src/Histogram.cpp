@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Histogram.h>
+#include <TimeZone.h>
+#include <assert.h>
+
+////////////////////////////////////////////////////////////////////////////////
+Histogram::Histogram ()
+: _period ('D')
+, _first (0)
+, _last (-1)
+, _resolved (false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Histogram::Histogram (char period, int first, int last)
+{
+  reset (period, first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Covers periods first..last inclusive, all with a zero count.
+void Histogram::reset (char period, int first, int last)
+{
+  _period = period;
+  _first = first;
+  _last = last;
+  _resolved = false;
+  _counts.assign (last >= first ? last - first + 2 : 1, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts an event in a single period.
+void Histogram::add (int period, int count /* = 1 */)
+{
+  add (period, period + 1, count);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Counts an interval covering periods from..to-1, clipped to the range.
+void Histogram::add (int from, int to, int count)
+{
+  assert (! _resolved);
+
+  if (from < _first)
+    from = _first;
+
+  if (to > _last + 1)
+    to = _last + 1;
+
+  if (from < to)
+  {
+    _counts[from - _first] += count;
+    _counts[to - _first]   -= count;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Converts the differences into counts.  No more additions after this.
+void Histogram::resolve ()
+{
+  int running = 0;
+  for (auto& count : _counts)
+    count = running += count;
+
+  _resolved = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Histogram::operator[] (int period) const
+{
+  assert (_resolved);
+
+  if (period < _first || period > _last)
+    return 0;
+
+  return _counts[period - _first];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Histogram::first () const
+{
+  return _first;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Histogram::last () const
+{
+  return _last;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The number of the period containing the given time.
+int Histogram::period (time_t t, char period)
+{
+  struct tm tm;
+  TimeZone::toLocal (t, tm);
+
+  switch (period)
+  {
+  case 'Y': return tm.tm_year + 1900;
+  case 'M': return (tm.tm_year + 1900) * 12 + tm.tm_mon;
+  }
+
+  int days = TimeZone::daysFromCivil (tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday);
+  if (period == 'W')
+    return TimeZone::floorDiv (days + 4, 7);  // 1970-01-01 was a Thursday.
+
+  return days;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The number of the first period that starts at or after the given time, so
+// that 'start of period < t' is the same as 'period < ceiling (t)'.
+int Histogram::ceiling (time_t t, char period)
+{
+  int p = Histogram::period (t, period);
+  return epoch (p, period) < t ? p + 1 : p;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The local midnight that starts the given period.
+time_t Histogram::epoch (int number, char period)
+{
+  int y = 0;
+  int m = 1;
+  int d = 1;
+
+  switch (period)
+  {
+  case 'Y': y = number;                                                   break;
+  case 'M': y = TimeZone::floorDiv (number, 12); m = number - y * 12 + 1; break;
+  case 'W': TimeZone::civilFromDays (number * 7 - 4, y, m, d);           break;
+  default:  TimeZone::civilFromDays (number, y, m, d);                   break;
+  }
+
+  return TimeZone::fromLocal (y, m, d, 0, 0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_HISTOGRAM
+#define INCLUDED_HISTOGRAM
+
+#include <vector>
+#include <time.h>
+
+// Histogram counts events and intervals over a dense range of calendar
+// periods: days (D), Sunday-based weeks (W), months (M) or years (Y), each
+// numbered consecutively in local time.  An interval is recorded as a +1/-1
+// pair in a difference array and a single prefix sum resolves all of them, so
+// the cost is proportional to intervals plus periods, rather than intervals
+// times periods.
+class Histogram
+{
+public:
+  Histogram ();
+  Histogram (char, int, int);
+  void reset (char, int, int);
+
+  void add (int, int count = 1);
+  void add (int, int, int);
+  void resolve ();
+
+  int operator[] (int) const;
+  int first () const;
+  int last () const;
+
+  static int period (time_t, char);
+  static int ceiling (time_t, char);
+  static time_t epoch (int, char);
+
+private:
+  char _period;
+  int _first;
+  int _last;
+  bool _resolved;
+  std::vector <int> _counts;
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
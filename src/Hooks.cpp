@@ -36,6 +36,8 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <sys/types.h>
+#include <atomic>
+#include <thread>
 #include <Context.h>
 #include <JSON.h>
 #include <Timer.h>
@@ -49,13 +51,17 @@ extern Context context;
 Hooks::Hooks ()
 : _enabled (true)
 , _debug (0)
+, _parallel (1)
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 void Hooks::initialize ()
 {
+  Profiler::Span span ("Hooks::initialize");
+
   _debug = context.config.getInteger ("debug.hooks");
+  _parallel = context.config.getInteger ("hooks.parallel");
 
   // Scan <rc.data.location>/hooks
   Directory d (context.config.get ("data.location"));
@@ -116,24 +122,29 @@ void Hooks::onLaunch ()
   if (! _enabled)
     return;
 
+  Profiler::Span span ("Hooks::onLaunch");
+
   context.timer_hooks.start ();
 
   std::vector <std::string> matchingScripts = scripts ("on-launch");
   if (matchingScripts.size ())
   {
-    for (auto& script : matchingScripts)
-    {
-      std::vector <std::string> input;
-      std::vector <std::string> output;
-      int status = callHookScript (script, input, output);
+    // The scripts cannot affect each other, so they may run concurrently.
+    std::vector <std::string> input;
+    std::vector <std::vector <std::string>> outputs;
+    std::vector <int> statuses;
+    callHookScripts (matchingScripts, input, outputs, statuses);
 
+    // Results are processed in script order, as if run sequentially.
+    for (unsigned int i = 0; i < statuses.size (); ++i)
+    {
       std::vector <std::string> outputJSON;
       std::vector <std::string> outputFeedback;
-      separateOutput (output, outputJSON, outputFeedback);
+      separateOutput (outputs[i], outputJSON, outputFeedback);
 
       assertNTasks (outputJSON, 0);
 
-      if (status == 0)
+      if (statuses[i] == 0)
       {
         for (auto& message : outputFeedback)
           context.footnote (message);
@@ -169,6 +180,8 @@ void Hooks::onExit ()
   if (! _enabled)
     return;
 
+  Profiler::Span span ("Hooks::onExit");
+
   context.timer_hooks.start ();
 
   std::vector <std::string> matchingScripts = scripts ("on-exit");
@@ -183,19 +196,22 @@ void Hooks::onExit ()
     for (auto& t : tasks)
       input.push_back (t.composeJSON ());
 
-    // Call the hook scripts, with the invariant input.
-    for (auto& script : matchingScripts)
-    {
-      std::vector <std::string> output;
-      int status = callHookScript (script, input, output);
+    // Call the hook scripts, with the invariant input.  The scripts cannot
+    // affect each other, so they may run concurrently.
+    std::vector <std::vector <std::string>> outputs;
+    std::vector <int> statuses;
+    callHookScripts (matchingScripts, input, outputs, statuses);
 
+    // Results are processed in script order, as if run sequentially.
+    for (unsigned int i = 0; i < statuses.size (); ++i)
+    {
       std::vector <std::string> outputJSON;
       std::vector <std::string> outputFeedback;
-      separateOutput (output, outputJSON, outputFeedback);
+      separateOutput (outputs[i], outputJSON, outputFeedback);
 
       assertNTasks (outputJSON, 0);
 
-      if (status == 0)
+      if (statuses[i] == 0)
       {
         for (auto& message : outputFeedback)
           context.footnote (message);
@@ -231,6 +247,8 @@ void Hooks::onAdd (Task& task)
   if (! _enabled)
     return;
 
+  Profiler::Span span ("Hooks::onAdd");
+
   context.timer_hooks.start ();
 
   std::vector <std::string> matchingScripts = scripts ("on-add");
@@ -297,6 +315,8 @@ void Hooks::onModify (const Task& before, Task& after)
   if (! _enabled)
     return;
 
+  Profiler::Span span ("Hooks::onModify");
+
   context.timer_hooks.start ();
 
   std::vector <std::string> matchingScripts = scripts ("on-modify");
@@ -558,6 +578,7 @@ int Hooks::callHookScript (
   // Measure time for each hook if running in debug
   int status;
   std::string outputStr;
+  Profiler::Span span ("Hooks::execute");
   if (_debug >= 2)
   {
     Timer timer_per_hook("Hooks::execute (" + script + ")");
@@ -567,6 +588,7 @@ int Hooks::callHookScript (
   }
   else
     status = execute (script, args, inputStr, outputStr);
+  span.stop ();
 
   split (output, outputStr, '\n');
 
@@ -585,3 +607,126 @@ int Hooks::callHookScript (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Runs a set of scripts that all receive the same input, and whose output
+// does not feed into the next script.  Up to rc.hooks.parallel scripts run
+// concurrently.  No script is started after one earlier in the list has
+// failed, although scripts that were already running are allowed to finish.
+// Outputs and statuses are returned in script order, up to and including the
+// first failing script, so the caller sees exactly what the sequential path
+// would have reported.
+void Hooks::callHookScripts (
+  const std::vector <std::string>& scripts,
+  const std::vector <std::string>& input,
+  std::vector <std::vector <std::string>>& outputs,
+  std::vector <int>& statuses)
+{
+  unsigned int count = scripts.size ();
+  outputs.resize (count);
+  statuses.resize (count, -1);
+
+  if (_parallel <= 1 || count < 2)
+  {
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      statuses[i] = callHookScript (scripts[i], input, outputs[i]);
+      if (statuses[i] != 0)
+      {
+        outputs.resize (i + 1);
+        statuses.resize (i + 1);
+        break;
+      }
+    }
+
+    return;
+  }
+
+  // Everything that touches the context is done here, not in the workers.
+  std::string inputStr;
+  for (auto& i : input)
+    inputStr += i + "\n";
+
+  std::vector <std::string> args;
+  buildHookScriptArgs (args);
+
+  std::vector <std::string> outputStr (count);
+  std::vector <std::string> errors (count);
+  std::vector <unsigned long> elapsed (count, 0);
+  std::atomic <unsigned int> next (0);
+  std::atomic <unsigned int> failed (count);
+
+  auto worker = [&] ()
+  {
+    unsigned int i;
+    while ((i = next++) < count && i < failed)
+    {
+      Profiler::Span span ("Hooks::execute");
+      unsigned long start = Timer::now ();
+      try
+      {
+        statuses[i] = execute (scripts[i], args, inputStr, outputStr[i]);
+      }
+
+      catch (const std::string& error)
+      {
+        errors[i] = error;
+      }
+
+      elapsed[i] = Timer::now () - start;
+
+      // Record the earliest failing script.
+      if (statuses[i] != 0 || errors[i] != "")
+      {
+        unsigned int earliest = failed;
+        while (i < earliest && ! failed.compare_exchange_weak (earliest, i))
+          ;
+      }
+    }
+  };
+
+  std::vector <std::thread> workers;
+  for (unsigned int t = 0; t < std::min ((unsigned int) _parallel, count); ++t)
+    workers.push_back (std::thread (worker));
+
+  for (auto& w : workers)
+    w.join ();
+
+  for (unsigned int i = 0; i < count; ++i)
+  {
+    if (_debug >= 1)
+      context.debug ("Hook: Calling " + scripts[i]);
+
+    if (_debug >= 2)
+    {
+      context.debug ("Hook: input");
+      for (auto& line : input)
+        context.debug ("  " + line);
+    }
+
+    if (errors[i] != "")
+      throw errors[i];
+
+    split (outputs[i], outputStr[i], '\n');
+
+    if (_debug >= 2)
+    {
+      context.debug ("Hook: output");
+      for (auto& line : outputs[i])
+        if (line != "")
+          context.debug ("  " + line);
+
+      context.debug (format ("Hook: Completed with status {1} in {2} sec", statuses[i], elapsed[i] / 1000000.0));
+      context.debug (" "); // Blank line
+    }
+
+    // Scripts after the first failure are not reported, as they would not
+    // have run sequentially.
+    if (statuses[i] != 0)
+    {
+      outputs.resize (i + 1);
+      statuses.resize (i + 1);
+      return;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -58,10 +58,12 @@ private:
   void assertFeedback (const std::vector <std::string>&) const;
   std::vector <std::string>& buildHookScriptArgs (std::vector <std::string>&);
   int callHookScript (const std::string&, const std::vector <std::string>&, std::vector <std::string>&);
+  void callHookScripts (const std::vector <std::string>&, const std::vector <std::string>&, std::vector <std::vector <std::string>>&, std::vector <int>&);
 
 private:
   bool                      _enabled;
   int                       _debug;
+  int                       _parallel;
   std::vector <std::string> _scripts;
 };
 
@@ -29,8 +29,10 @@
 #include <sstream>
 #include <iomanip>
 #include <stdlib.h>
+#include <limits.h>
 #include <assert.h>
 #include <Lexer.h>
+#include <TimeZone.h>
 #include <util.h>
 #ifdef PRODUCT_TASKWARRIOR
 #include <Dates.h>
@@ -118,6 +120,43 @@ int ISO8601d::minimumMatchLength = 3;
 bool ISO8601d::isoEnabled = true;
 bool ISO8601p::isoEnabled = true;
 
+////////////////////////////////////////////////////////////////////////////////
+// Appends a non-negative number, zero-padded to width.  Cheaper than a
+// stringstream with setw/setfill.
+static void appendNumber (std::string& output, int value, int width)
+{
+  if (value < 0)
+  {
+    output += std::to_string (value);
+    return;
+  }
+
+  char buffer[16];
+  int length = 0;
+  do
+  {
+    buffer[length++] = '0' + (value % 10);
+    value /= 10;
+  }
+  while (value);
+
+  while (length < width)
+    buffer[length++] = '0';
+
+  while (length)
+    output += buffer[--length];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Two ASCII digits, without a branch per character.  Any non-digit sets 'bad'.
+static inline int digits2 (const char* s, unsigned int& bad)
+{
+  unsigned int tens  = s[0] - '0';
+  unsigned int units = s[1] - '0';
+  bad |= (tens > 9) | (units > 9);
+  return (tens * 10) + units;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ISO8601d::ISO8601d ()
 {
@@ -145,15 +184,7 @@ ISO8601d::ISO8601d (const time_t t)
 ISO8601d::ISO8601d (const int m, const int d, const int y)
 {
   clear ();
-
-  // Error if not valid.
-  struct tm t {};
-  t.tm_isdst = -1;   // Requests that mktime determine summer time effect.
-  t.tm_mday  = d;
-  t.tm_mon   = m - 1;
-  t.tm_year  = y - 1900;
-
-  _date = mktime (&t);
+  _date = TimeZone::fromLocal (y, m, d, 0, 0, 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -161,18 +192,7 @@ ISO8601d::ISO8601d (const int m,  const int d,  const int y,
                     const int hr, const int mi, const int se)
 {
   clear ();
-
-  // Error if not valid.
-  struct tm t {};
-  t.tm_isdst = -1;   // Requests that mktime determine summer time effect.
-  t.tm_mday  = d;
-  t.tm_mon   = m - 1;
-  t.tm_year  = y - 1900;
-  t.tm_hour  = hr;
-  t.tm_min   = mi;
-  t.tm_sec   = se;
-
-  _date = mktime (&t);
+  _date = TimeZone::fromLocal (y, m, d, hr, mi, se);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -230,11 +250,23 @@ bool ISO8601d::parse (
   std::string::size_type& start,
   const std::string& format /* = "" */)
 {
+  // Epoch and compact UTC timestamps are what the data files, the JSON
+  // parser and hooks carry, so they are recognized in place first.
+  if (start == 0 && parse_fast (input, format))
+  {
+    start = input.length ();
+    return true;
+  }
+
   auto i = start;
   Nibbler n (input.substr (i));
 
+  // Epoch and all the ISO forms begin with a digit, so names and words skip
+  // straight to the formatted and named parses.
+  bool digit = i < input.length () && Lexer::isDigit (input[i]);
+
   // Parse epoch first, as it's the most common scenario.
-  if (parse_epoch (n))
+  if (digit && parse_epoch (n))
   {
     // ::validate and ::resolve are not needed in this case.
     start = n.cursor ();
@@ -255,15 +287,16 @@ bool ISO8601d::parse (
   // Allow parse_date_time and parse_date_time_ext regardless of
   // ISO8601d::isoEnabled setting, because these formats are relied upon by
   // the 'import' command, JSON parser and hook system.
-  else if (parse_date_time     (n)   || // Strictest first.
-           parse_date_time_ext (n)   ||
-           (ISO8601d::isoEnabled &&
-            (parse_date_time     (n) ||
-             parse_date_time_ext (n) ||
-             parse_date_ext      (n) ||
-             parse_time_utc_ext  (n) ||
-             parse_time_off_ext  (n) ||
-             parse_time_ext      (n)))) // Time last, as it is the most permissive.
+  else if (digit &&
+           (parse_date_time     (n)   || // Strictest first.
+            parse_date_time_ext (n)   ||
+            (ISO8601d::isoEnabled &&
+             (parse_date_time     (n) ||
+              parse_date_time_ext (n) ||
+              parse_date_ext      (n) ||
+              parse_time_utc_ext  (n) ||
+              parse_time_off_ext  (n) ||
+              parse_time_ext      (n))))) // Time last, as it is the most permissive.
   {
     // Check the values and determine time_t.
     if (validate ())
@@ -297,6 +330,7 @@ void ISO8601d::clear ()
   _offset          = 0;
   _utc             = false;
   _date            = 0;
+  _localKnown      = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -663,6 +697,71 @@ bool ISO8601d::parse_epoch (Nibbler& n)
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Recognizes exactly an epoch (as parse_epoch) or, when no format takes
+// precedence, exactly 'YYYYMMDDThhmmssZ' (as parse_date_time + validate +
+// resolve), directly from the input and without allocating.  Anything else,
+// including out-of-range values, is left to the general grammar.
+bool ISO8601d::parse_fast (const std::string& input, const std::string& format)
+{
+  const char* s = input.data ();
+  auto length = input.length ();
+
+  if (length == 9 || length == 10)
+  {
+    long long epoch = 0;
+    unsigned int bad = 0;
+    for (unsigned int i = 0; i < length; ++i)
+    {
+      unsigned int digit = s[i] - '0';
+      bad |= digit > 9;
+      epoch = (epoch * 10) + digit;
+    }
+
+    if (! bad && epoch >= 315532800 && epoch <= INT_MAX)
+    {
+      _date = static_cast <time_t> (epoch);
+      return true;
+    }
+  }
+
+  else if (length == 16 &&
+           format == ""  &&
+           s[8]  == 'T'  &&
+           s[15] == 'Z')
+  {
+    unsigned int bad = 0;
+    int year   = (digits2 (s,      bad) * 100) + digits2 (s + 2, bad);
+    int month  =  digits2 (s +  4, bad);
+    int day    =  digits2 (s +  6, bad);
+    int hour   =  digits2 (s +  9, bad);
+    int minute =  digits2 (s + 11, bad);
+    int second =  digits2 (s + 13, bad);
+    int seconds = (((hour * 60) + minute) * 60) + second;
+
+    if (! bad                                            &&
+        year   >= 1900 && year   <= 2200                     &&
+        month  >= 1    && month  <= 12                       &&
+        day    >= 1    && day    <= daysInMonth (month, year) &&
+        minute <  60   && second <  60                       &&
+        seconds <= 86400)
+    {
+      _year    = year;
+      _month   = month;
+      _day     = day;
+      _seconds = seconds;
+      _utc     = true;
+
+      // As timegm computes it.
+      _date = static_cast <time_t> (TimeZone::daysFromCivil (year, month, day)) * 86400
+            + seconds;
+      return true;
+    }
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool ISO8601d::parse_date_time (Nibbler& n)
 {
@@ -1020,7 +1119,24 @@ void ISO8601d::resolve ()
   t.tm_min = (seconds % 3600) / 60;
   t.tm_sec = seconds % 60;
 
-  _date = utc ? timegm (&t) : mktime (&t);
+  _date = utc ? timegm (&t)
+              : TimeZone::fromLocal (t.tm_year + 1900, t.tm_mon + 1, t.tm_mday,
+                                     t.tm_hour, t.tm_min, t.tm_sec);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The accessors all decompose _date into local time, so the decomposition is
+// kept until _date changes.
+const struct tm& ISO8601d::local () const
+{
+  if (! _localKnown || _localDate != _date)
+  {
+    TimeZone::toLocal (_date, _local);
+    _localDate  = _date;
+    _localKnown = true;
+  }
+
+  return _local;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1060,7 +1176,7 @@ std::string ISO8601d::toISO () const
 // 1998-01-19T07:00:00 =  YYYY-MM-DDThh:mm:ss
 std::string ISO8601d::toISOLocalExtended () const
 {
-  struct tm* t = localtime (&_date);
+  const struct tm* t = &local ();
 
   std::stringstream iso;
   iso << std::setw (4) << std::setfill ('0') << t->tm_year + 1900
@@ -1087,7 +1203,7 @@ double ISO8601d::toJulian () const
 ////////////////////////////////////////////////////////////////////////////////
 void ISO8601d::toMDY (int& m, int& d, int& y) const
 {
-  struct tm* t = localtime (&_date);
+  const struct tm* t = &local ();
 
   m = t->tm_mon + 1;
   d = t->tm_mday;
@@ -1098,37 +1214,41 @@ void ISO8601d::toMDY (int& m, int& d, int& y) const
 const std::string ISO8601d::toString (
   const std::string& format /*= "m/d/Y" */) const
 {
-  std::stringstream formatted;
+  // Decompose once, rather than once per format character.
+  const struct tm& t = local ();
+
+  std::string formatted;
+  formatted.reserve (format.length () * 2);
   for (unsigned int i = 0; i < format.length (); ++i)
   {
     int c = format[i];
     switch (c)
     {
-    case 'm': formatted                                        << this->month ();         break;
-    case 'M': formatted << std::setw (2) << std::setfill ('0') << this->month ();         break;
-    case 'd': formatted                                        << this->day ();           break;
-    case 'D': formatted << std::setw (2) << std::setfill ('0') << this->day ();           break;
-    case 'y': formatted << std::setw (2) << std::setfill ('0') << (this->year () % 100);  break;
-    case 'Y': formatted                                        << this->year ();          break;
-    case 'a': formatted                                        << ISO8601d::dayNameShort (dayOfWeek ()); break;
-    case 'A': formatted                                        << ISO8601d::dayName (dayOfWeek ());      break;
-    case 'b': formatted                                        << ISO8601d::monthNameShort (month ());   break;
-    case 'B': formatted                                        << ISO8601d::monthName (month ());        break;
-    case 'v': formatted                                        << ISO8601d::weekOfYear (ISO8601d::dayOfWeek (ISO8601d::weekstart)); break;
-    case 'V': formatted << std::setw (2) << std::setfill ('0') << ISO8601d::weekOfYear (ISO8601d::dayOfWeek (ISO8601d::weekstart)); break;
-    case 'h': formatted                                        << this->hour ();          break;
-    case 'H': formatted << std::setw (2) << std::setfill ('0') << this->hour ();          break;
-    case 'n': formatted                                        << this->minute ();        break;
-    case 'N': formatted << std::setw (2) << std::setfill ('0') << this->minute ();        break;
-    case 's': formatted                                        << this->second ();        break;
-    case 'S': formatted << std::setw (2) << std::setfill ('0') << this->second ();        break;
-    case 'j': formatted                                        << this->dayOfYear ();     break;
-    case 'J': formatted << std::setw (3) << std::setfill ('0') << this->dayOfYear ();     break;
-    default:  formatted                                        << static_cast <char> (c); break;
+    case 'm': appendNumber (formatted, t.tm_mon + 1,          0); break;
+    case 'M': appendNumber (formatted, t.tm_mon + 1,          2); break;
+    case 'd': appendNumber (formatted, t.tm_mday,             0); break;
+    case 'D': appendNumber (formatted, t.tm_mday,             2); break;
+    case 'y': appendNumber (formatted, (t.tm_year + 1900) % 100, 2); break;
+    case 'Y': appendNumber (formatted, t.tm_year + 1900,      0); break;
+    case 'a': formatted += ISO8601d::dayNameShort (t.tm_wday);    break;
+    case 'A': formatted += ISO8601d::dayName (t.tm_wday);         break;
+    case 'b': formatted += ISO8601d::monthNameShort (t.tm_mon + 1); break;
+    case 'B': formatted += ISO8601d::monthName (t.tm_mon + 1);    break;
+    case 'v': appendNumber (formatted, ISO8601d::weekOfYear (ISO8601d::dayOfWeek (ISO8601d::weekstart)), 0); break;
+    case 'V': appendNumber (formatted, ISO8601d::weekOfYear (ISO8601d::dayOfWeek (ISO8601d::weekstart)), 2); break;
+    case 'h': appendNumber (formatted, t.tm_hour,             0); break;
+    case 'H': appendNumber (formatted, t.tm_hour,             2); break;
+    case 'n': appendNumber (formatted, t.tm_min,              0); break;
+    case 'N': appendNumber (formatted, t.tm_min,              2); break;
+    case 's': appendNumber (formatted, t.tm_sec,              0); break;
+    case 'S': appendNumber (formatted, t.tm_sec,              2); break;
+    case 'j': appendNumber (formatted, t.tm_yday + 1,         0); break;
+    case 'J': appendNumber (formatted, t.tm_yday + 1,         3); break;
+    default:  formatted += static_cast <char> (c);                break;
     }
   }
 
-  return formatted.str ();
+  return formatted;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1428,8 +1548,7 @@ int ISO8601d::length (const std::string& format)
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::month () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_mon + 1;
+  return local ().tm_mon + 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1441,21 +1560,19 @@ int ISO8601d::week () const
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::day () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_mday;
+  return local ().tm_mday;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::year () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_year + 1900;
+  return local ().tm_year + 1900;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::weekOfYear (int weekStart) const
 {
-  struct tm* t = localtime (&_date);
+  const struct tm* t = &local ();
   char   weekStr[3];
 
   if (weekStart == 0)
@@ -1476,36 +1593,31 @@ int ISO8601d::weekOfYear (int weekStart) const
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::dayOfWeek () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_wday;
+  return local ().tm_wday;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::dayOfYear () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_yday + 1;
+  return local ().tm_yday + 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::hour () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_hour;
+  return local ().tm_hour;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::minute () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_min;
+  return local ().tm_min;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 int ISO8601d::second () const
 {
-  struct tm* t = localtime (&_date);
-  return t->tm_sec;
+  return local ().tm_sec;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1797,8 +1909,31 @@ ISO8601p::operator time_t () const
 //
 bool ISO8601p::parse (const std::string& input, std::string::size_type& start)
 {
-  // Attempt and ISO parse first.
+  // Static and so preserved between calls.
+  static std::vector <std::string> units;
+  static std::string initials;
+  if (units.size () == 0)
+  {
+    for (unsigned int i = 0; i < NUM_DURATIONS; i++)
+    {
+      units.push_back (durations[i].unit);
+      if (initials.find (durations[i].unit[0]) == std::string::npos)
+        initials += durations[i].unit[0];
+    }
+  }
+
+  // A duration begins with 'P', a unit, or a signed or unsigned number, so
+  // anything else is rejected before copying the input.
   auto original_start = start;
+  char first = original_start < input.length () ? input[original_start] : '\0';
+  if (first != 'P'           &&
+      first != '+'           &&
+      first != '-'           &&
+      ! Lexer::isDigit (first) &&
+      initials.find (first) == std::string::npos)
+    return false;
+
+  // Attempt and ISO parse first.
   Nibbler n (input.substr (original_start));
   n.save ();
 
@@ -1818,12 +1953,6 @@ bool ISO8601p::parse (const std::string& input, std::string::size_type& start)
   // Attempt a legacy format parse next.
   n.restore ();
 
-  // Static and so preserved between calls.
-  static std::vector <std::string> units;
-  if (units.size () == 0)
-    for (unsigned int i = 0; i < NUM_DURATIONS; i++)
-      units.push_back (durations[i].unit);
-
   std::string number;
   std::string unit;
 
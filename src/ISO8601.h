@@ -111,6 +111,7 @@ private:
   void clear ();
   bool parse_formatted     (Nibbler&, const std::string&);
   bool parse_named         (Nibbler&);
+  bool parse_fast          (const std::string&, const std::string&);
   bool parse_epoch         (Nibbler&);
   bool parse_date_time     (Nibbler&);
   bool parse_date_time_ext (Nibbler&);
@@ -121,6 +122,7 @@ private:
   bool parse_time_off_ext  (Nibbler&);
   bool validate ();
   void resolve ();
+  const struct tm& local () const;
   std::string dump () const;
 
 public:
@@ -134,6 +136,11 @@ public:
   int _offset;
   bool _utc;
   time_t _date;
+
+private:
+  mutable struct tm _local;       // _localDate in local time
+  mutable time_t _localDate;
+  mutable bool _localKnown;
 };
 
 // Period
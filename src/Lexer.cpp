@@ -28,6 +28,7 @@
 #include <Lexer.h>
 #include <algorithm>
 #include <ctype.h>
+#include <string.h>
 #include <ISO8601.h>
 #include <utf8.h>
 
@@ -38,6 +39,67 @@ std::string Lexer::dateFormat = "";
 std::string::size_type Lexer::minimumMatchLength = 3;
 std::map <std::string, std::string> Lexer::attributes;
 
+// The recognizers that can possibly succeed on a token, keyed by its first
+// byte.  Every token is otherwise offered to up to eighteen recognizers in
+// turn, most of which reject it on that first byte anyway.
+enum
+{
+  firstString       = 1 << 0,
+  firstDate         = 1 << 1,
+  firstDuration     = 1 << 2,
+  firstURL          = 1 << 3,
+  firstPair         = 1 << 4,
+  firstUUID         = 1 << 5,
+  firstSet          = 1 << 6,
+  firstDOM          = 1 << 7,
+  firstHexNumber    = 1 << 8,
+  firstNumber       = 1 << 9,
+  firstSeparator    = 1 << 10,
+  firstTag          = 1 << 11,
+  firstPath         = 1 << 12,
+  firstSubstitution = 1 << 13,
+  firstPattern      = 1 << 14,
+  firstOperator     = 1 << 15,
+  firstIdentifier   = 1 << 16
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The classification uses the same predicates as the recognizers, applied to
+// the byte as they see it.  Date and month names may be localized, so any
+// UTF-8 byte may begin a date.  Attribute names are identifiers.
+static const std::vector <unsigned int>& firstByteCandidates ()
+{
+  // Static and so preserved between calls.
+  static std::vector <unsigned int> candidates;
+  if (candidates.size () == 0)
+  {
+    for (int b = 0; b < 256; ++b)
+    {
+      int c = static_cast <char> (b);
+      unsigned int set = 0;
+
+      if (c == '\'' || c == '"')                     set |= firstString;
+      if (Lexer::isAlpha (c) || Lexer::isDigit (c))  set |= firstDate | firstDuration;
+      if (b >= 0x80)                                 set |= firstDate;
+      if (c == 'h' || c == 'H')                      set |= firstURL;
+      if (Lexer::isIdentifierStart (c))              set |= firstPair | firstDOM | firstIdentifier;
+      if (Lexer::isHexDigit (c))                     set |= firstUUID;
+      if (Lexer::isDigit (c))                        set |= firstSet | firstDOM | firstNumber;
+      if (c == '0')                                  set |= firstHexNumber;
+      if (c == '-')                                  set |= firstSeparator;
+      if (c == '+' || c == '-')                      set |= firstTag;
+      if (c == '/')                                  set |= firstPath | firstSubstitution | firstPattern;
+      if (c == '_'                         ||
+          Lexer::isSingleCharOperator (c)  ||
+          (c && strchr ("=!<>o|&ax", c)))
+        set |= firstOperator;
+
+      candidates.push_back (set);
+    }
+  }
+
+  return candidates;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 Lexer::Lexer (const std::string& text)
@@ -65,6 +127,14 @@ bool Lexer::token (std::string& token, Lexer::Type& type)
   if (isEOS ())
     return false;
 
+  // Only the recognizers that can match the first byte are consulted.  A
+  // custom date format that does not begin with a digit could begin with
+  // anything.
+  auto candidates = firstByteCandidates ()[static_cast <unsigned char> (_text[_cursor])];
+  if (Lexer::dateFormat != "" &&
+      ! strchr ("mMdDyYhHnNsSvV", Lexer::dateFormat[0]))
+    candidates |= firstDate;
+
   // The sequence is specific, and must follow these rules:
   //   - date < duration < uuid < identifier
   //   - dom < uuid
@@ -75,24 +145,24 @@ bool Lexer::token (std::string& token, Lexer::Type& type)
   //   - path < substitution < pattern
   //   - set < number
   //   - word last
-  if (isString       (token, type, "'\"") ||
-      isDate         (token, type)        ||
-      isDuration     (token, type)        ||
-      isURL          (token, type)        ||
-      isPair         (token, type)        ||
-      isUUID         (token, type, true)  ||
-      isSet          (token, type)        ||
-      isDOM          (token, type)        ||
-      isHexNumber    (token, type)        ||
-      isNumber       (token, type)        ||
-      isSeparator    (token, type)        ||
-      isTag          (token, type)        ||
-      isPath         (token, type)        ||
-      isSubstitution (token, type)        ||
-      isPattern      (token, type)        ||
-      isOperator     (token, type)        ||
-      isIdentifier   (token, type)        ||
-      isWord         (token, type))
+  if (((candidates & firstString)       && isString       (token, type, "'\"")) ||
+      ((candidates & firstDate)         && isDate         (token, type))        ||
+      ((candidates & firstDuration)     && isDuration     (token, type))        ||
+      ((candidates & firstURL)          && isURL          (token, type))        ||
+      ((candidates & firstPair)         && isPair         (token, type))        ||
+      ((candidates & firstUUID)         && isUUID         (token, type, true))  ||
+      ((candidates & firstSet)          && isSet          (token, type))        ||
+      ((candidates & firstDOM)          && isDOM          (token, type))        ||
+      ((candidates & firstHexNumber)    && isHexNumber    (token, type))        ||
+      ((candidates & firstNumber)       && isNumber       (token, type))        ||
+      ((candidates & firstSeparator)    && isSeparator    (token, type))        ||
+      ((candidates & firstTag)          && isTag          (token, type))        ||
+      ((candidates & firstPath)         && isPath         (token, type))        ||
+      ((candidates & firstSubstitution) && isSubstitution (token, type))        ||
+      ((candidates & firstPattern)      && isPattern      (token, type))        ||
+      ((candidates & firstOperator)     && isOperator     (token, type))        ||
+      ((candidates & firstIdentifier)   && isIdentifier   (token, type))        ||
+      isWord (token, type))
     return true;
 
   return false;
@@ -559,10 +629,11 @@ bool Lexer::isDate (std::string& token, Lexer::Type& type)
   // Try an ISO date parse.
   std::size_t iso_i = 0;
   ISO8601d iso;
-  if (iso.parse (_text.substr (_cursor), iso_i, Lexer::dateFormat))
+  if (_cursor == 0 ? iso.parse (_text, iso_i, Lexer::dateFormat)
+                   : iso.parse (_text.substr (_cursor), iso_i, Lexer::dateFormat))
   {
     type = Lexer::Type::date;
-    token = _text.substr (_cursor, iso_i);
+    token.assign (_text, _cursor, iso_i);
     _cursor += iso_i;
     return true;
   }
@@ -587,10 +658,11 @@ bool Lexer::isDuration (std::string& token, Lexer::Type& type)
 
   marker = 0;
   ISO8601p iso;
-  if (iso.parse (_text.substr (_cursor), marker))
+  if (_cursor == 0 ? iso.parse (_text, marker)
+                   : iso.parse (_text.substr (_cursor), marker))
   {
     type = Lexer::Type::duration;
-    token = _text.substr (_cursor, marker);
+    token.assign (_text, _cursor, marker);
     _cursor += marker;
     return true;
   }
@@ -633,7 +705,7 @@ bool Lexer::isUUID (std::string& token, Lexer::Type& type, bool endBoundary)
        isWhitespace (_text[marker + i]) ||
        isSingleCharOperator (_text[marker + i])))
   {
-    token = _text.substr (_cursor, i);
+    token.assign (_text, _cursor, i);
     type = Lexer::Type::uuid;
     _cursor += i;
     return true;
@@ -660,7 +732,7 @@ bool Lexer::isHexNumber (std::string& token, Lexer::Type& type)
 
     if (marker - _cursor > 2)
     {
-      token = _text.substr (_cursor, marker - _cursor);
+      token.assign (_text, _cursor, marker - _cursor);
       type = Lexer::Type::hex;
       _cursor = marker;
       return true;
@@ -732,7 +804,7 @@ bool Lexer::isNumber (std::string& token, Lexer::Type& type)
         ! isSingleCharOperator (_text[marker]))
       return false;
 
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     type = Lexer::Type::number;
     _cursor = marker;
     return true;
@@ -754,7 +826,7 @@ bool Lexer::isInteger (std::string& token, Lexer::Type& type)
     while (isDigit (_text[marker]))
       utf8_next_char (_text, marker);
 
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     type = Lexer::Type::number;
     _cursor = marker;
     return true;
@@ -808,7 +880,7 @@ bool Lexer::isURL (std::string& token, Lexer::Type& type)
              ! isWhitespace (_text[marker]))
         utf8_next_char (_text, marker);
 
-      token = _text.substr (_cursor, marker - _cursor);
+      token.assign (_text, _cursor, marker - _cursor);
       type = Lexer::Type::url;
       _cursor = marker;
       return true;
@@ -831,10 +903,10 @@ bool Lexer::isPair (std::string& token, Lexer::Type& type)
   if (isIdentifier (ignoredToken, ignoredType))
   {
     // Look for a valid separator.
-    std::string separator = _text.substr (_cursor, 2);
-    if (separator == "::" || separator == ":=")
+    if (_text[_cursor] == ':' &&
+        (_text[_cursor + 1] == ':' || _text[_cursor + 1] == '='))
       _cursor += 2;
-    else if (separator[0] == ':' || separator[0] == '=')
+    else if (_text[_cursor] == ':' || _text[_cursor] == '=')
       _cursor++;
     else
     {
@@ -848,7 +920,7 @@ bool Lexer::isPair (std::string& token, Lexer::Type& type)
         isEOS ()                                       ||
         isWhitespace (_text[_cursor]))
     {
-      token = _text.substr (marker, _cursor - marker);
+      token.assign (_text, marker, _cursor - marker);
       type = Lexer::Type::pair;
       return true;
     }
@@ -903,7 +975,7 @@ bool Lexer::isSet (std::string& token, Lexer::Type& type)
        isWhitespace (_text[_cursor]) ||
        isHardBoundary (_text[_cursor], _text[_cursor + 1])))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::set;
     return true;
   }
@@ -940,7 +1012,7 @@ bool Lexer::isTag (std::string& token, Lexer::Type& type)
       while (isIdentifierNext (_text[marker]))
           utf8_next_char (_text, marker);
 
-      token = _text.substr (_cursor, marker - _cursor);
+      token.assign (_text, _cursor, marker - _cursor);
       type = Lexer::Type::tag;
       _cursor = marker;
       return true;
@@ -986,7 +1058,7 @@ bool Lexer::isPath (std::string& token, Lexer::Type& type)
       slashCount > 3)
   {
     type = Lexer::Type::path;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
@@ -1015,7 +1087,7 @@ bool Lexer::isSubstitution (std::string& token, Lexer::Type& type)
       if (_text[_cursor] == '\0' ||
           isWhitespace (_text[_cursor]))
       {
-        token = _text.substr (marker, _cursor - marker);
+        token.assign (_text, marker, _cursor - marker);
         type = Lexer::Type::substitution;
         return true;
       }
@@ -1038,7 +1110,7 @@ bool Lexer::isPattern (std::string& token, Lexer::Type& type)
       (isEOS () ||
        isWhitespace (_text[_cursor])))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::pattern;
     return true;
   }
@@ -1057,38 +1129,38 @@ bool Lexer::isOperator (std::string& token, Lexer::Type& type)
 {
   std::size_t marker = _cursor;
 
-  if (_eos - marker >= 8 && _text.substr (marker, 8) == "_hastag_")
+  if (_eos - marker >= 8 && _text.compare (marker, 8, "_hastag_") == 0)
   {
     marker += 8;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
 
-  else if (_eos - marker >= 7 && _text.substr (marker, 7) == "_notag_")
+  else if (_eos - marker >= 7 && _text.compare (marker, 7, "_notag_") == 0)
   {
     marker += 7;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
 
-  else if (_eos - marker >= 5 && _text.substr (marker, 5) == "_neg_")
+  else if (_eos - marker >= 5 && _text.compare (marker, 5, "_neg_") == 0)
   {
     marker += 5;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
 
-  else if (_eos - marker >= 5 && _text.substr (marker, 5) == "_pos_")
+  else if (_eos - marker >= 5 && _text.compare (marker, 5, "_pos_") == 0)
   {
     marker += 5;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
@@ -1098,7 +1170,7 @@ bool Lexer::isOperator (std::string& token, Lexer::Type& type)
   {
     marker += 3;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
@@ -1108,7 +1180,7 @@ bool Lexer::isOperator (std::string& token, Lexer::Type& type)
   {
     marker += 2;
     type = Lexer::Type::op;
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     _cursor = marker;
     return true;
   }
@@ -1171,7 +1243,7 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
   if (isLiteral ("rc.", false, false) &&
       isWord (partialToken, partialType))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::dom;
     return true;
   }
@@ -1185,7 +1257,7 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
                 "system.version",
                 "system.os"}, false, true))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::dom;
     return true;
   }
@@ -1213,7 +1285,7 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
       isLiteral (".",    false, false) &&
       isWord    (partialToken, partialType))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::dom;
     return true;
   }
@@ -1223,7 +1295,7 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
   // [prefix]attribute
   if (isOneOf (attributes, false, true))
   {
-    token = _text.substr (marker, _cursor - marker);
+    token.assign (_text, marker, _cursor - marker);
     type = Lexer::Type::dom;
     return true;
   }
@@ -1242,14 +1314,14 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
                     "julian",
                     "hour", "minute", "second"}, false, true))
       {
-        token = _text.substr (marker, _cursor - marker);
+        token.assign (_text, marker, _cursor - marker);
         type = Lexer::Type::dom;
         return true;
       }
     }
     else
     {
-      token = _text.substr (marker, _cursor - marker);
+      token.assign (_text, marker, _cursor - marker);
       type = Lexer::Type::dom;
       return true;
     }
@@ -1267,13 +1339,13 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
       {
         if (isLiteral ("description", false, true))
         {
-          token = _text.substr (marker, _cursor - marker);
+          token.assign (_text, marker, _cursor - marker);
           type = Lexer::Type::dom;
           return true;
         }
         else if (isLiteral ("entry", false, true))
         {
-          token = _text.substr (marker, _cursor - marker);
+          token.assign (_text, marker, _cursor - marker);
           type = Lexer::Type::dom;
           return true;
         }
@@ -1284,7 +1356,7 @@ bool Lexer::isDOM (std::string& token, Lexer::Type& type)
                            "julian",
                            "hour", "minute", "second"}, false, true))
         {
-          token = _text.substr (marker, _cursor - marker);
+          token.assign (_text, marker, _cursor - marker);
           type = Lexer::Type::dom;
           return true;
         }
@@ -1310,7 +1382,7 @@ bool Lexer::isIdentifier (std::string& token, Lexer::Type& type)
     while (isIdentifierNext (_text[marker]))
       utf8_next_char (_text, marker);
 
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     type = Lexer::Type::identifier;
     _cursor = marker;
     return true;
@@ -1333,7 +1405,7 @@ bool Lexer::isWord (std::string& token, Lexer::Type& type)
 
   if (marker > _cursor)
   {
-    token = _text.substr (_cursor, marker - _cursor);
+    token.assign (_text, _cursor, marker - _cursor);
     type = Lexer::Type::word;
     _cursor = marker;
     return true;
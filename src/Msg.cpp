@@ -28,6 +28,63 @@
 #include <Msg.h>
 #include <Lexer.h>
 #include <text.h>
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#ifdef HAVE_LIBZ
+////////////////////////////////////////////////////////////////////////////////
+static std::string zlibDeflate (const std::string& input)
+{
+  uLongf size = compressBound (input.length ());
+  std::string output (size, '\0');
+  if (compress2 ((Bytef*) &output[0], &size,
+                 (const Bytef*) input.data (), input.length (),
+                 Z_DEFAULT_COMPRESSION) != Z_OK)
+    throw std::string ("ERROR: Could not compress message payload");
+
+  output.resize (size);
+  return output;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Anything following the end of the compressed stream, such as the trailing
+// newline of a serialized message, is ignored.  A small payload can inflate to
+// an enormous one, so the output is capped at 'limit' bytes, unless zero.
+static std::string zlibInflate (const std::string& input, size_t limit)
+{
+  z_stream stream {};
+  if (inflateInit (&stream) != Z_OK)
+    throw std::string ("ERROR: Could not decompress message payload");
+
+  stream.next_in  = (Bytef*) input.data ();
+  stream.avail_in = input.length ();
+
+  std::string output;
+  char buffer[65536];
+  int status;
+  do
+  {
+    stream.next_out  = (Bytef*) buffer;
+    stream.avail_out = sizeof (buffer);
+    status = inflate (&stream, Z_NO_FLUSH);
+    output.append (buffer, sizeof (buffer) - stream.avail_out);
+
+    if (limit && output.size () > limit)
+    {
+      inflateEnd (&stream);
+      throw std::string ("ERROR: Decompressed message payload exceeds the limit");
+    }
+  }
+  while (status == Z_OK);
+
+  inflateEnd (&stream);
+  if (status != Z_STREAM_END)
+    throw std::string ("ERROR: Malformed compressed message payload");
+
+  return output;
+}
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 Msg::Msg ()
@@ -79,20 +136,46 @@ void Msg::all (std::vector <std::string>& names) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Payload compression is negotiated by the peers.  Each side lists what it can
+// decode in the 'accept-compression' header, and a compressed payload is marked
+// by the 'compression' header.  zlib is the only method, when available.
+bool Msg::supports (const std::string& method)
+{
+#ifdef HAVE_LIBZ
+  return method == "zlib";
+#else
+  return false;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A 'compression' header naming an unsupported method is an error, as the
+// peer could not decode the payload.
 std::string Msg::serialize () const
 {
-  std::string output;
+  std::string method = get ("compression");
+  bool compress = method != "";
+  if (compress && ! supports (method))
+    throw std::string ("ERROR: Unsupported message compression '") + method + "'";
 
+  std::string output;
   for (auto& i : _header)
     output += i.first + ": " + i.second + "\n";
 
-  output += "\n" + _payload + "\n";
+  output += "\n";
+#ifdef HAVE_LIBZ
+  if (compress)
+    output += zlibDeflate (_payload);
+  else
+#endif
+    output += _payload;
+  output += "\n";
 
   return output;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-bool Msg::parse (const std::string& input)
+bool Msg::parse (const std::string& input, size_t limit /* = 0 */)
 {
   _header.clear ();
   _payload = "";
@@ -116,6 +199,17 @@ bool Msg::parse (const std::string& input)
   // Parse payload.
   _payload = input.substr (separator + 2);
 
+  std::string method = get ("compression");
+  if (method != "")
+  {
+    if (! supports (method))
+      throw std::string ("ERROR: Unsupported message compression '") + method + "'";
+
+#ifdef HAVE_LIBZ
+    _payload = zlibInflate (_payload, limit);
+#endif
+  }
+
   return true;
 }
 
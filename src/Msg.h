@@ -43,8 +43,9 @@ public:
   std::string getPayload () const;
 
   void all (std::vector <std::string>&) const;
+  static bool supports (const std::string&);
   std::string serialize () const;
-  bool parse (const std::string&);
+  bool parse (const std::string&, size_t limit = 0);
 
 private:
   std::map <std::string, std::string> _header;
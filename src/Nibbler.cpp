@@ -449,7 +449,7 @@ bool Nibbler::getNumber (double &result)
 bool Nibbler::getLiteral (const std::string& literal)
 {
   if (_cursor < _length &&
-      _input->find (literal, _cursor) == _cursor)
+      _input->compare (_cursor, literal.length (), literal) == 0)
   {
     _cursor += literal.length ();
     return true;
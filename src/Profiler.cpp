@@ -0,0 +1,291 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Profiler.h>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <string.h>
+#include <unistd.h>
+#include <JSON.h>
+#include <text.h>
+
+std::atomic <int> Profiler::_format (Profiler::none);
+
+////////////////////////////////////////////////////////////////////////////////
+// Spans are recorded per thread, in the order they were opened, so a span's
+// parent always precedes it.  Only the first span on a thread takes the lock.
+namespace
+{
+  struct Event
+  {
+    const char* name;
+    int         parent;
+    uint64_t    start;
+    uint64_t    end;
+  };
+
+  struct Thread
+  {
+    int                 id;
+    int                 current;
+    std::vector <Event> events;
+  };
+
+  std::mutex                              threadsLock;
+  std::vector <std::unique_ptr <Thread>>  threads;
+  thread_local Thread*                    local = NULL;
+  uint64_t                                origin = 0;
+
+  // Spans of the same name under the same parent are combined.
+  struct Node
+  {
+    const char*        name;
+    unsigned long      calls;
+    uint64_t           total;
+    uint64_t           children_total;
+    std::vector <int>  children;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void aggregate (const Thread& thread, uint64_t until, std::vector <Node>& nodes)
+{
+  nodes.clear ();
+  nodes.push_back (Node {"", 0, 0, 0, {}});
+
+  std::vector <int> nodeOf (thread.events.size ());
+  for (unsigned int i = 0; i < thread.events.size (); ++i)
+  {
+    auto& event = thread.events[i];
+    int parent = event.parent == -1 ? 0 : nodeOf[event.parent];
+
+    int node = -1;
+    for (auto child : nodes[parent].children)
+      if (strcmp (nodes[child].name, event.name) == 0)
+        node = child;
+
+    if (node == -1)
+    {
+      node = nodes.size ();
+      nodes.push_back (Node {event.name, 0, 0, 0, {}});
+      nodes[parent].children.push_back (node);
+    }
+
+    // A span that is still open ends now.
+    uint64_t elapsed = (event.end ? event.end : until) - event.start;
+    nodes[node].calls++;
+    nodes[node].total += elapsed;
+    nodes[parent].children_total += elapsed;
+    nodeOf[i] = node;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void renderTree (
+  std::stringstream& out,
+  const std::vector <Node>& nodes,
+  int node,
+  int depth)
+{
+  for (auto child : nodes[node].children)
+  {
+    auto& n = nodes[child];
+    out << std::left  << std::setw (40) << (std::string (depth * 2, ' ') + n.name)
+        << std::right << std::setw (8)  << n.calls << " x"
+        << std::setw (12) << n.total / 1000 << " us"
+        << std::setw (12) << (n.total - n.children_total) / 1000 << " us self\n";
+    renderTree (out, nodes, child, depth + 1);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void renderJSON (
+  std::stringstream& out,
+  const std::vector <Node>& nodes,
+  int node)
+{
+  out << '[';
+  bool first = true;
+  for (auto child : nodes[node].children)
+  {
+    auto& n = nodes[child];
+    if (! first)
+      out << ',';
+    first = false;
+
+    out << "{\"name\":\""     << json::encode (n.name) << "\""
+        << ",\"calls\":"      << n.calls
+        << ",\"total\":"      << n.total / 1000
+        << ",\"self\":"       << (n.total - n.children_total) / 1000
+        << ",\"children\":";
+    renderJSON (out, nodes, child);
+    out << '}';
+  }
+  out << ']';
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Recording starts afresh whenever the profiler is enabled.
+void Profiler::enable (Format format)
+{
+  std::lock_guard <std::mutex> lock (threadsLock);
+  for (auto& thread : threads)
+  {
+    thread->events.clear ();
+    thread->current = -1;
+  }
+
+  origin = now ();
+  _format = format;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Profiler::Format Profiler::parse (const std::string& value)
+{
+  if (value == "" || value == "none" || value == "off" || value == "no")
+    return none;
+
+  if (value == "json")
+    return json;
+
+  if (value == "trace")
+    return trace;
+
+  return tree;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// All threads are expected to have finished by the time this is called.
+std::string Profiler::render ()
+{
+  std::lock_guard <std::mutex> lock (threadsLock);
+
+  uint64_t until = now ();
+
+  std::stringstream out;
+  std::vector <Node> nodes;
+  if (_format == tree)
+  {
+    for (auto& thread : threads)
+    {
+      if (! thread->events.size ())
+        continue;
+
+      aggregate (*thread, until, nodes);
+      out << "Profile thread " << thread->id << "\n";
+      renderTree (out, nodes, 0, 1);
+    }
+  }
+  else if (_format == json)
+  {
+    out << "{\"threads\":[";
+    bool first = true;
+    for (auto& thread : threads)
+    {
+      if (! thread->events.size ())
+        continue;
+
+      if (! first)
+        out << ',';
+      first = false;
+
+      aggregate (*thread, until, nodes);
+      out << "{\"thread\":" << thread->id << ",\"spans\":";
+      renderJSON (out, nodes, 0);
+      out << '}';
+    }
+    out << "]}\n";
+  }
+  else if (_format == trace)
+  {
+    // Complete events, with times in microseconds since the profiler started.
+    out << "{\"traceEvents\":[";
+    bool first = true;
+    for (auto& thread : threads)
+    {
+      for (auto& event : thread->events)
+      {
+        if (! first)
+          out << ",\n";
+        first = false;
+
+        uint64_t end = event.end ? event.end : until;
+        out << "{\"name\":\"" << json::encode (event.name) << "\""
+            << ",\"ph\":\"X\""
+            << ",\"ts\":"  << format ((event.start - origin) / 1000.0)
+            << ",\"dur\":" << format ((end - event.start) / 1000.0)
+            << ",\"pid\":" << getpid ()
+            << ",\"tid\":" << thread->id
+            << '}';
+      }
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}\n";
+  }
+
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int Profiler::open (const char* name)
+{
+  if (! local)
+  {
+    std::lock_guard <std::mutex> lock (threadsLock);
+    threads.push_back (std::unique_ptr <Thread> (new Thread {(int) threads.size (), -1, {}}));
+    local = threads.back ().get ();
+  }
+
+  local->events.push_back (Event {name, local->current, now (), 0});
+  local->current = local->events.size () - 1;
+  return local->current;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A span opened before the profiler was last enabled was discarded.
+void Profiler::close (int index)
+{
+  if (index >= (int) local->events.size ())
+    return;
+
+  auto& event = local->events[index];
+  event.end = now ();
+  local->current = event.parent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Nanoseconds on a monotonic clock.
+uint64_t Profiler::now ()
+{
+  return std::chrono::duration_cast <std::chrono::nanoseconds> (
+           std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,91 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_PROFILER
+#define INCLUDED_PROFILER
+
+#include <string>
+#include <atomic>
+#include <stdint.h>
+
+// Profiler records nested, named spans of time on each thread, and renders
+// them as a tree, as JSON or in the Chrome trace event format.  It is enabled
+// by rc.profile, and when it is not, a span costs one test of a flag.
+class Profiler
+{
+public:
+  enum Format {none, tree, json, trace};
+
+  class Span
+  {
+  public:
+    explicit Span (const char* name)
+    : _event (Profiler::enabled () ? Profiler::open (name) : -1)
+    {
+    }
+
+    ~Span ()
+    {
+      stop ();
+    }
+
+    Span (const Span&) = delete;
+    Span& operator= (const Span&) = delete;
+
+    // Ends the span before the end of its scope.
+    void stop ()
+    {
+      if (_event != -1)
+      {
+        Profiler::close (_event);
+        _event = -1;
+      }
+    }
+
+  private:
+    int _event;
+  };
+
+  static void enable (Format);
+  static Format parse (const std::string&);
+  static std::string render ();
+
+  static bool enabled ()
+  {
+    return _format.load (std::memory_order_relaxed) != none;
+  }
+
+private:
+  static int open (const char*);
+  static void close (int);
+  static uint64_t now ();
+
+private:
+  static std::atomic <int> _format;
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Recurrence.h>
+#include <algorithm>
+#include <stdlib.h>
+#include <time.h>
+#include <Lexer.h>
+#include <TimeZone.h>
+#include <text.h>
+#include <i18n.h>
+
+// Average step lengths, in seconds, used to estimate how many steps fit in a
+// span.  Actual steps deviate from the average by less than 'slack' in total.
+static const time_t averageMonth = 2629746;  // 30.436875 days
+static const time_t averageYear  = 31556952; // 365.2425 days
+static const time_t averageWeekday = 120960; // 7 days per 5 steps
+static const time_t slack = 4 * 86400;
+
+// The Gregorian calendar repeats every 400 years.
+static const long cycleMonths = 4800;
+
+////////////////////////////////////////////////////////////////////////////////
+// The named periods overlap with the numeric forms, so they are tested in a
+// fixed order.  A period that is not recognized here is taken as a duration.
+Recurrence::Recurrence (const std::string& period)
+: _period (period)
+, _unit (Unit::months)
+, _count (0)
+, _leap (false)
+, _seconds (0)
+{
+  auto length = period.length ();
+
+  if (period == "monthly" ||
+      period == "P1M")
+    _count = 1;
+
+  else if (period == "weekdays")
+    _unit = Unit::weekdays;
+
+  else if (length                     &&
+           Lexer::isDigit (period[0]) &&
+           period[length - 1] == 'm')
+    _count = strtol (period.substr (0, length - 1).c_str (), NULL, 10);
+
+  else if (length > 2                                         &&
+           period[0] == 'P'                                   &&
+           Lexer::isAllDigits (period.substr (1, length - 2)) &&
+           period[length - 1] == 'M')
+    _count = strtol (period.substr (1, length - 2).c_str (), NULL, 10);
+
+  else if (period == "quarterly")
+    _count = 3;
+
+  else if (length                     &&
+           Lexer::isDigit (period[0]) &&
+           period[length - 1] == 'q')
+    _count = 3 * strtol (period.substr (0, length - 1).c_str (), NULL, 10);
+
+  else if (period == "semiannual")
+    _count = 6;
+
+  else if (period == "bimonthly")
+    _count = 2;
+
+  else if (period == "biannual" ||
+           period == "biyearly" ||
+           period == "P2Y")
+  {
+    _unit = Unit::years;
+    _count = 2;
+  }
+
+  else if (period == "annual" ||
+           period == "yearly" ||
+           period == "P1Y")
+  {
+    _unit = Unit::years;
+    _count = 1;
+    _leap = true;
+  }
+
+  else
+  {
+    // Anything else is a fixed duration.  An invalid period is only reported
+    // when a step is actually needed.
+    std::string::size_type idx = 0;
+    ISO8601p p;
+    if (p.parse (period, idx))
+    {
+      _unit = Unit::seconds;
+      _seconds = (time_t) p;
+    }
+    else
+      _unit = Unit::invalid;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A period such as "0d" would repeat the same instance forever.
+bool Recurrence::advances () const
+{
+  switch (_unit)
+  {
+  case Unit::months:
+  case Unit::years:    return _count > 0;
+  case Unit::seconds:  return _seconds > 0;
+  case Unit::weekdays:
+  case Unit::invalid:  return true;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ISO8601d Recurrence::next (const ISO8601d& current) const
+{
+  time_t epoch = current.toEpoch ();
+  struct tm t;
+  TimeZone::toLocal (epoch, t);
+
+  int m = t.tm_mon + 1;
+  int d = t.tm_mday;
+  int y = t.tm_year + 1900;
+
+  switch (_unit)
+  {
+  // Months vary in length, so the day is reduced to fit, if necessary.
+  case Unit::months:
+    m += _count;
+    y += (m - 1) / 12;
+    m = (m - 1) % 12 + 1;
+
+    while (! ISO8601d::valid (m, d, y))
+      --d;
+
+    return ISO8601d (m, d, y, t.tm_hour, t.tm_min, t.tm_sec);
+
+  case Unit::years:
+    y += _count;
+
+    // If the due data just happens to be 2/29 in a leap year, then simply
+    // incrementing y is going to create an invalid date.
+    if (_leap && m == 2 && d == 29)
+      d = 28;
+
+    return ISO8601d (m, d, y, t.tm_hour, t.tm_min, t.tm_sec);
+
+  case Unit::weekdays:
+    {
+      int days;
+           if (t.tm_wday == 5) days = 3;
+      else if (t.tm_wday == 6) days = 2;
+      else                     days = 1;
+
+      return ISO8601d (epoch + days * 86400);
+    }
+
+  case Unit::seconds:
+    return ISO8601d (epoch + _seconds);
+
+  case Unit::invalid:
+    break;
+  }
+
+  throw std::string (format (STRING_TASK_VALID_RECUR, _period));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Equivalent to calling next 'steps' times, but in constant time where the
+// calendar allows it.
+ISO8601d Recurrence::advance (const ISO8601d& from, long steps) const
+{
+  if (steps <= 0)
+    return from;
+
+  if (_unit == Unit::seconds)
+    return ISO8601d (from.toEpoch () + steps * _seconds);
+
+  if (_unit == Unit::invalid || ! jumps (from))
+  {
+    ISO8601d i = from;
+    while (steps--)
+      i = next (i);
+
+    return i;
+  }
+
+  time_t epoch = from.toEpoch ();
+  struct tm t;
+  TimeZone::toLocal (epoch, t);
+
+  if (_unit == Unit::months)
+  {
+    // The day only ever decreases, to fit the shortest month visited so far,
+    // and a full calendar cycle visits every month that will ever be visited.
+    int d = t.tm_mday;
+    long limit = std::min (steps, cycleMonths);
+    for (long i = 1; i <= limit && d > 28; ++i)
+    {
+      long index = t.tm_mon + i * _count;
+      d = std::min (d, ISO8601d::daysInMonth (index % 12 + 1,
+                                              t.tm_year + 1900 + index / 12));
+    }
+
+    long index = t.tm_mon + steps * _count;
+    return ISO8601d (index % 12 + 1, d, t.tm_year + 1900 + index / 12,
+                     t.tm_hour, t.tm_min, t.tm_sec);
+  }
+
+  if (_unit == Unit::years)
+  {
+    // Only the first step can start on 2/29, after which the date is valid in
+    // every year.
+    ISO8601d first = next (from);
+    epoch = first.toEpoch ();
+    TimeZone::toLocal (epoch, t);
+    return ISO8601d (t.tm_mon + 1, t.tm_mday,
+                     t.tm_year + 1900 + (steps - 1) * _count,
+                     t.tm_hour, t.tm_min, t.tm_sec);
+  }
+
+  // Weekdays: step to a Monday, after which every five steps span one week.
+  int dow = t.tm_wday;
+  long days = 0;
+  while (steps > 0 && dow != 1)
+  {
+    int step = dow == 5 ? 3 : dow == 6 ? 2 : 1;
+    days += step;
+    dow = (dow + step) % 7;
+    --steps;
+  }
+
+  days += 7 * (steps / 5) + steps % 5;
+  return ISO8601d (epoch + days * 86400);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns the number of instances, starting at 'start', that are no later than
+// 't'.  That is also the index of the first instance after 't'.
+long Recurrence::count (const ISO8601d& start, const ISO8601d& t) const
+{
+  if (start > t)
+    return 0;
+
+  time_t span = t.toEpoch () - start.toEpoch ();
+  if (_unit == Unit::seconds && _seconds > 0)
+    return span / _seconds + 1;
+
+  // Jump to an instance that cannot be later than 't', then step past it.
+  long steps = 0;
+  if (span > slack && jumps (start))
+  {
+    time_t average = _unit == Unit::months ? _count * averageMonth
+                   : _unit == Unit::years  ? _count * averageYear
+                   :                         averageWeekday;
+    steps = (span - slack) / average;
+  }
+
+  ISO8601d i = advance (start, steps);
+  while (! (i > t))
+  {
+    i = next (i);
+    ++steps;
+  }
+
+  return steps;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Daylight saving transitions skip or repeat local times near midnight, and
+// stepping across one can shift the time, or even the day, of every later
+// instance.  Jumping would miss that, so only instances in the middle of the
+// day are jumped, and the others are stepped, exactly as before.
+bool Recurrence::jumps (const ISO8601d& from) const
+{
+  if (_unit == Unit::seconds)
+    return true;
+
+  time_t epoch = from.toEpoch ();
+  struct tm t;
+  TimeZone::toLocal (epoch, t);
+  return t.tm_hour >= 4 && t.tm_hour < 22;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef INCLUDED_RECURRENCE
+#define INCLUDED_RECURRENCE
+
+#include <string>
+#include <ISO8601.h>
+
+// Recurrence is a 'recur' period, parsed once.  It steps from one instance of
+// a recurring task to the next, and can also jump directly to the nth
+// instance, so that generating the newest instances of an old recurring task
+// does not mean walking its entire history.
+class Recurrence
+{
+public:
+  explicit Recurrence (const std::string&);
+
+  bool advances () const;
+  ISO8601d next (const ISO8601d&) const;
+  ISO8601d advance (const ISO8601d&, long) const;
+  long count (const ISO8601d&, const ISO8601d&) const;
+
+private:
+  bool jumps (const ISO8601d&) const;
+
+private:
+  enum class Unit { months, years, weekdays, seconds, invalid };
+
+  std::string _period;
+  Unit        _unit;
+  int         _count;    // Months or years per step
+  bool        _leap;     // Step from Feb 29 to Feb 28
+  time_t      _seconds;  // Seconds per step
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
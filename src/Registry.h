@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_REGISTRY
+#define INCLUDED_REGISTRY
+
+#include <map>
+#include <string>
+#include <vector>
+#include <functional>
+
+// Registry maps names to objects that are only constructed when first used.
+// Registering a name is cheap, which keeps the startup path from paying for
+// the construction of every Command and Column when a command needs only one
+// or two of them.
+template <class T>
+class Registry
+{
+public:
+  typedef std::function <T* ()> Creator;
+  typedef typename std::map <std::string, T*>::const_iterator const_iterator;
+
+  Registry () = default;
+  Registry (const Registry&) = delete;
+  Registry& operator= (const Registry&) = delete;
+
+  ~Registry ()
+  {
+    clear ();
+  }
+
+  void add (const std::string& name, Creator creator)
+  {
+    _creators[name] = creator;
+  }
+
+  bool has (const std::string& name) const
+  {
+    return _creators.find (name) != _creators.end ();
+  }
+
+  // Returns NULL for an unregistered name.
+  T* operator[] (const std::string& name)
+  {
+    auto object = _objects.find (name);
+    if (object != _objects.end ())
+      return object->second;
+
+    auto creator = _creators.find (name);
+    if (creator == _creators.end ())
+      return NULL;
+
+    T* t = creator->second ();
+    _objects[name] = t;
+    return t;
+  }
+
+  std::vector <std::string> names () const
+  {
+    std::vector <std::string> all;
+    for (auto& creator : _creators)
+      all.push_back (creator.first);
+
+    return all;
+  }
+
+  // Iteration visits every registered object, so it constructs them all.
+  const_iterator begin ()
+  {
+    if (_objects.size () != _creators.size ())
+      for (auto& creator : _creators)
+        (*this)[creator.first];
+
+    return _objects.begin ();
+  }
+
+  const_iterator end () const
+  {
+    return _objects.end ();
+  }
+
+  size_t size () const
+  {
+    return _creators.size ();
+  }
+
+  void clear ()
+  {
+    for (auto& object : _objects)
+      delete object.second;
+
+    _objects.clear ();
+    _creators.clear ();
+  }
+
+private:
+  std::map <std::string, Creator> _creators;
+  std::map <std::string, T*>      _objects;
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
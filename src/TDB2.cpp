@@ -27,12 +27,16 @@
 #include <cmake.h>
 #include <TDB2.h>
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <list>
 #include <set>
+#include <unordered_set>
 #include <stdlib.h>
 #include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
 #include <Context.h>
 #include <Color.h>
 #include <ISO8601.h>
@@ -43,6 +47,9 @@
 
 extern Context context;
 
+// Read once per file access.
+static const Config::Key locking = Config::key ("locking");
+
 bool TDB2::debug_mode = false;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +60,7 @@ TF2::TF2 ()
 , _loaded_lines (false)
 , _has_ids (false)
 , _auto_dep_scan (false)
+, _indexed (false)
 {
 }
 
@@ -123,13 +131,13 @@ bool TF2::get (const std::string& uuid, Task& task)
   if (! _loaded_tasks)
     load_tasks ();
 
-  if (_tasks_map.size () > 0 && uuid.size () == 36)
+  if (_indexed && uuid.size () == 36)
   {
-    // Fast lookup, same result as below. Only used during "task import".
-    auto i = _tasks_map.find (uuid);
-    if (i != _tasks_map.end ())
+    // Fast lookup, same result as below.  Only used for bulk updates.
+    auto i = _tasks_index.find (uuid);
+    if (i != _tasks_index.end ())
     {
-      task = i->second;
+      task = _tasks[i->second];
       return true;
     }
   }
@@ -155,6 +163,9 @@ bool TF2::has (const std::string& uuid)
   if (! _loaded_tasks)
     load_tasks ();
 
+  if (_indexed)
+    return _tasks_index.find (uuid) != _tasks_index.end ();
+
   for (auto& i : _tasks)
     if (i.get ("uuid") == uuid)
       return true;
@@ -169,8 +180,8 @@ void TF2::add_task (Task& task)
   _added_tasks.push_back (task);     // For commit/synch
 
   // For faster lookup
-  if (context.cli2.getCommand () == "import")
-    _tasks_map.insert (std::pair<std::string, Task> (task.get("uuid"), task));
+  if (_indexed)
+    _tasks_index.emplace (task.get ("uuid"), _tasks.size () - 1);
 
   Task::status status = task.getStatus ();
   if (task.id == 0 &&
@@ -192,14 +203,18 @@ bool TF2::modify_task (const Task& task)
 {
   std::string uuid = task.get ("uuid");
 
-  if (context.cli2.getCommand () == "import")
+  if (_indexed)
   {
-    // Update map used for faster lookup
-    auto i = _tasks_map.find (uuid);
-    if (i != _tasks_map.end ())
-    {
-      i->second = task;
-    }
+    auto i = _tasks_index.find (uuid);
+    if (i == _tasks_index.end ())
+      return false;
+
+    // Modify in-place.
+    _tasks[i->second] = task;
+    _modified_tasks.push_back (task);
+    _dirty = true;
+
+    return true;
   }
 
   for (auto& i : _tasks)
@@ -230,6 +245,7 @@ void TF2::add_line (const std::string& line)
 void TF2::clear_tasks ()
 {
   _tasks.clear ();
+  _tasks_index.clear ();
   _dirty = true;
 }
 
@@ -253,8 +269,7 @@ void TF2::commit ()
     {
       if (_file.open ())
       {
-        if (context.config.getBoolean ("locking"))
-          _file.lock ();
+        lock ();
 
         // Write out all the added tasks.
         _file.append (std::string(""));  // Seek to end of file
@@ -275,8 +290,7 @@ void TF2::commit ()
     {
       if (_file.open ())
       {
-        if (context.config.getBoolean ("locking"))
-          _file.lock ();
+        lock ();
 
         // Truncate the file and rewrite.
         _file.truncate ();
@@ -297,6 +311,24 @@ void TF2::commit ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Locks the open file, if locking is enabled.  A file that was replaced while
+// waiting for the lock, as TDB2::compact_backlog does, is reopened, so that
+// nothing is written to the file that is no longer in place.
+void TF2::lock ()
+{
+  if (context.config.getBoolean (locking))
+  {
+    while (_file.lock () &&
+           _file.replaced ())
+    {
+      _file.close ();
+      if (! _file.open ())
+        break;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Load a single Task object, handle necessary plumbing work
 Task TF2::load_task (const std::string& line)
@@ -364,6 +396,7 @@ void TF2::load_gc (Task& task)
 ////////////////////////////////////////////////////////////////////////////////
 void TF2::load_tasks (bool from_gc /* = false */)
 {
+  Profiler::Span span ("TF2::load_tasks");
   context.timer_load.start ();
 
   if (! _loaded_lines)
@@ -391,9 +424,6 @@ void TF2::load_tasks (bool from_gc /* = false */)
         load_gc (task);
       else
         _tasks.push_back (task);
-
-      if (context.cli2.getCommand () == "import")  // For faster lookup only
-        _tasks_map.insert (std::pair<std::string, Task> (task.get("uuid"), task));
     }
 
     // TDB2::gc() calls this after loading both pending and completed
@@ -416,8 +446,7 @@ void TF2::load_lines ()
 {
   if (_file.open ())
   {
-    if (context.config.getBoolean ("locking"))
-      _file.lock ();
+    lock ();
 
     _file.read (_lines);
     _file.close ();
@@ -425,6 +454,23 @@ void TF2::load_lines ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Index the loaded tasks by UUID.  From then on, lookups and modifications by
+// full UUID are constant time, and add_task keeps the index current.  Where
+// a UUID occurs twice, the first occurrence wins, as it does for a scan.
+void TF2::index ()
+{
+  if (! _loaded_tasks)
+    load_tasks ();
+
+  _tasks_index.clear ();
+  _tasks_index.reserve (_tasks.size ());
+  for (size_t i = 0; i < _tasks.size (); ++i)
+    _tasks_index.emplace (_tasks[i].get ("uuid"), i);
+
+  _indexed = true;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string TF2::uuid (int id)
 {
@@ -496,6 +542,9 @@ void TF2::clear ()
   _added_lines.clear ();
   _I2U.clear ();
   _U2I.clear ();
+
+  _indexed = false;
+  _tasks_index.clear ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -713,6 +762,8 @@ void TDB2::update (
 ////////////////////////////////////////////////////////////////////////////////
 void TDB2::commit ()
 {
+  Profiler::Span span ("TDB2::commit");
+
   // Ignore harmful signals.
   signal (SIGHUP,    SIG_IGN);
   signal (SIGINT,    SIG_IGN);
@@ -726,11 +777,16 @@ void TDB2::commit ()
 
   gather_changes ();
 
+  bool backlog_grew = backlog._added_lines.size () > 0;
+
   pending.commit ();
   completed.commit ();
   undo.commit ();
   backlog.commit ();
 
+  if (backlog_grew && context.config.getBoolean ("backlog.compact"))
+    compact_backlog ();
+
   // Restore signal handling.
   signal (SIGHUP,    SIG_DFL);
   signal (SIGINT,    SIG_DFL);
@@ -742,6 +798,97 @@ void TDB2::commit ()
   context.timer_commit.stop ();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Every backlog.data entry is a complete task, so only the latest entry for
+// each UUID needs to be uploaded.  Entries are kept in the order of their last
+// modification, and the sync key line keeps its position.  Returns the number
+// of entries removed.
+//
+// The file is locked from the read until the compacted copy is renamed into
+// place, so an entry appended by another process is never lost, and a crash
+// leaves either the old or the new file.
+int TDB2::compact_backlog ()
+{
+  File& file = backlog._file;
+  if (! file.exists () ||
+      ! file.open ())
+    return 0;
+
+  backlog.lock ();
+
+  std::vector <std::string> lines;
+  file.read (lines);
+
+  // Walk backwards, keeping the first (latest) entry seen for each UUID.
+  std::unordered_set <std::string> seen;
+  std::vector <bool> keep (lines.size (), true);
+  int removed = 0;
+  for (int i = (int) lines.size () - 1; i >= 0; --i)
+  {
+    const std::string& line = lines[i];
+    if (line[0] != '{')
+      continue;
+
+    std::string uuid;
+    auto att = line.find ("\"uuid\":\"");
+    if (att != std::string::npos)
+      uuid = line.substr (att + 8, 36);
+    else
+      uuid = Task (line).get ("uuid");
+
+    if (uuid != "" &&
+        ! seen.insert (uuid).second)
+    {
+      keep[i] = false;
+      ++removed;
+    }
+  }
+
+  if (removed)
+  {
+    std::vector <std::string> compacted;
+    compacted.reserve (lines.size () - removed);
+    for (unsigned int i = 0; i < lines.size (); ++i)
+      if (keep[i])
+        compacted.push_back (lines[i]);
+
+    std::string temporary = file._data + "." + format ((int) getpid ());
+    std::ofstream out (temporary.c_str (), std::ios::trunc);
+    if (out.good ())
+    {
+      chmod (temporary.c_str (), file.mode () & 07777);
+      for (auto& line : compacted)
+        out << line << "\n";
+      out.close ();
+    }
+
+    if (out.good () &&
+        rename (temporary.c_str (), file._data.c_str ()) == 0)
+    {
+      backlog._lines = compacted;
+      backlog._loaded_lines = true;
+      context.debug (format ("TDB2::compact_backlog removed {1} superseded entries", removed));
+    }
+    else
+    {
+      unlink (temporary.c_str ());
+      removed = 0;
+    }
+  }
+
+  file.close ();
+  return removed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Prepares for a bulk update, such as an import or a sync, by indexing the
+// pending and completed tasks by UUID.  Must follow any gc.
+void TDB2::index ()
+{
+  pending.index ();
+  completed.index ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void TDB2::gather_changes ()
 {
@@ -1226,6 +1373,7 @@ void TDB2::show_diff (
 // - waiting task in pending that needs to be un-waited
 void TDB2::gc ()
 {
+  Profiler::Span span ("TDB2::gc");
   context.timer_gc.start ();
   unsigned long load_start = context.timer_load.total ();
 
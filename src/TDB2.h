@@ -58,11 +58,13 @@ public:
   void clear_tasks ();
   void clear_lines ();
   void commit ();
+  void lock ();
 
   Task load_task (const std::string&);
   void load_gc (Task&);
   void load_tasks (bool from_gc = false);
   void load_lines ();
+  void index ();
 
   // ID <--> UUID mapping.
   std::string uuid (int);
@@ -83,10 +85,11 @@ public:
   bool _auto_dep_scan;
   std::vector <Task> _tasks;
 
-  // _tasks_map was introduced mainly for speeding up "task import".
-  // Iterating over all _tasks for each imported task is slow, making use of
-  // appropriate data structures is fast.
-  std::unordered_map <std::string, Task> _tasks_map;
+  // _tasks_index was introduced mainly for speeding up "task import" and
+  // "task sync".  Iterating over all _tasks for each imported task is slow,
+  // making use of appropriate data structures is fast.
+  bool _indexed;
+  std::unordered_map <std::string, size_t> _tasks_index; // UUID -> _tasks offset
 
   std::vector <Task> _added_tasks;
   std::vector <Task> _modified_tasks;
@@ -111,6 +114,8 @@ public:
   void add (Task&, bool add_to_backlog = true);
   void modify (Task&, bool add_to_backlog = true);
   void commit ();
+  int  compact_backlog ();
+  void index ();
   void get_changes (std::vector <Task>&);
   void revert ();
   void gc ();
@@ -424,10 +424,10 @@ void TLSClient::send (const std::string& data)
     {
       status = gnutls_record_send (_session, packet.c_str () + total, remaining);
     }
-    while (errno == GNUTLS_E_INTERRUPTED ||
-           errno == GNUTLS_E_AGAIN);
+    while (status == GNUTLS_E_INTERRUPTED ||
+           status == GNUTLS_E_AGAIN);
 
-    if (status == -1)
+    if (status < 0)
       break;
 
     total     += (unsigned int) status;
@@ -453,9 +453,8 @@ void TLSClient::recv (std::string& data)
   {
     received = gnutls_record_recv (_session, header, 4);
   }
-  while (received > 0 &&
-         (errno == GNUTLS_E_INTERRUPTED ||
-          errno == GNUTLS_E_AGAIN));
+  while (received == GNUTLS_E_INTERRUPTED ||
+         received == GNUTLS_E_AGAIN);
 
   int total = received;
 
@@ -481,9 +480,8 @@ void TLSClient::recv (std::string& data)
     {
       received = gnutls_record_recv (_session, buffer, MAX_BUF - 1);
     }
-    while (received > 0 &&
-           (errno == GNUTLS_E_INTERRUPTED ||
-            errno == GNUTLS_E_AGAIN));
+    while (received == GNUTLS_E_INTERRUPTED ||
+           received == GNUTLS_E_AGAIN);
 
     // Other end closed the connection.
     if (received == 0)
@@ -502,9 +500,12 @@ void TLSClient::recv (std::string& data)
     else if (received < 0)
       throw std::string (gnutls_strerror (received));
 
-    buffer [received] = '\0';
-    data += buffer;
-    total += received;
+    // Payloads may be compressed, so do not stop at an embedded NUL.
+    if (received > 0)
+    {
+      data.append (buffer, received);
+      total += received;
+    }
 
     // Stop at defined limit.
     if (_limit && total > _limit)
@@ -36,6 +36,7 @@
 #endif
 #include <cfloat>
 #include <algorithm>
+#include <unordered_map>
 #include <Lexer.h>
 #ifdef PRODUCT_TASKWARRIOR
 #include <Context.h>
@@ -63,6 +64,10 @@ extern Context context;
 extern Task& contextTask;
 
 static const float epsilon = 0.000001;
+
+// Read once per task.
+static const Config::Key jsonDependsArray = Config::key ("json.depends.array");
+static const Config::Key urgencyInherit   = Config::key ("urgency.inherit");
 #endif
 
 std::string Task::defaultProject  = "";
@@ -88,6 +93,60 @@ std::map <std::string, std::vector <std::string>> Task::customOrder;
 
 static const std::string dummy ("");
 
+// Virtual tags that depend only on the task itself, and the time, and are
+// therefore cached by the task.  The names map to bits in the cache.  READY,
+// BLOCKED and BLOCKING also depend on other tasks, and are not cached.
+enum
+{
+  vtDue, vtDueToday, vtYesterday, vtTomorrow, vtOverdue, vtWeek,
+  vtMonth, vtYear, vtActive, vtScheduled, vtChild, vtUntil, vtAnnotated,
+  vtTagged, vtParent, vtWaiting, vtPending, vtCompleted, vtDeleted, vtUDA,
+  vtOrphan, vtProject, vtPriority
+};
+
+static const std::unordered_map <std::string, int> virtualTags =
+{
+#ifdef PRODUCT_TASKWARRIOR
+  {"DUE",       vtDue},
+  {"DUETODAY",  vtDueToday},
+  {"TODAY",     vtDueToday},
+  {"YESTERDAY", vtYesterday},
+  {"TOMORROW",  vtTomorrow},
+  {"OVERDUE",   vtOverdue},
+  {"WEEK",      vtWeek},
+  {"MONTH",     vtMonth},
+  {"YEAR",      vtYear},
+#endif
+  {"ACTIVE",    vtActive},
+  {"SCHEDULED", vtScheduled},
+  {"CHILD",     vtChild},
+  {"UNTIL",     vtUntil},
+  {"ANNOTATED", vtAnnotated},
+  {"TAGGED",    vtTagged},
+  {"PARENT",    vtParent},
+  {"WAITING",   vtWaiting},
+  {"PENDING",   vtPending},
+  {"COMPLETED", vtCompleted},
+  {"DELETED",   vtDeleted},
+#ifdef PRODUCT_TASKWARRIOR
+  {"UDA",       vtUDA},
+  {"ORPHAN",    vtOrphan},
+#endif
+  {"PROJECT",   vtProject},
+  {"PRIORITY",  vtPriority},
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The time at which the command runs, which all date comparisons use.
+static time_t commandTime ()
+{
+#ifdef PRODUCT_TASKWARRIOR
+  return context.snapshot.now;
+#else
+  return time (NULL);
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Task::Task ()
 : data ()
@@ -97,6 +156,11 @@ Task::Task ()
 , is_blocked (false)
 , is_blocking (false)
 , annotation_count (0)
+, _virtual_known (0)
+, _virtual_value (0)
+, _virtual_time (0)
+, _tags_split (false)
+, _tags ()
 {
 }
 
@@ -134,6 +198,10 @@ Task::Task (const std::string& input)
   is_blocked       = false;
   is_blocking      = false;
   annotation_count = 0;
+  _virtual_known   = 0;
+  _virtual_value   = 0;
+  _virtual_time    = 0;
+  _tags_split      = false;
 
   parse (input);
 }
@@ -147,6 +215,10 @@ Task::Task (const json::object* obj)
   is_blocked       = false;
   is_blocking      = false;
   annotation_count = 0;
+  _virtual_known   = 0;
+  _virtual_value   = 0;
+  _virtual_time    = 0;
+  _tags_split      = false;
 
   parseJSON (obj);
 }
@@ -281,6 +353,7 @@ time_t Task::get_date (const std::string& name) const
 void Task::set (const std::string& name, const std::string& value)
 {
   data[name] = json::decode (value);
+  invalidateTags ();
 
   recalc_urgency = true;
 }
@@ -289,6 +362,7 @@ void Task::set (const std::string& name, const std::string& value)
 void Task::set (const std::string& name, int value)
 {
   data[name] = format (value);
+  invalidateTags ();
 
   recalc_urgency = true;
 }
@@ -297,7 +371,10 @@ void Task::set (const std::string& name, int value)
 void Task::remove (const std::string& name)
 {
   if (data.erase (name))
+  {
+    invalidateTags ();
     recalc_urgency = true;
+  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -323,8 +400,8 @@ Task::dateState Task::getDateState (const std::string& name) const
   if (value.length ())
   {
     ISO8601d reference (value);
-    ISO8601d now;
-    ISO8601d today ("today");
+    ISO8601d now (context.snapshot.now);
+    ISO8601d& today = context.snapshot.today;
 
     if (reference < today)
       return dateBeforeToday;
@@ -337,12 +414,10 @@ Task::dateState Task::getDateState (const std::string& name) const
         return dateLaterToday;
     }
 
-    int imminentperiod = context.config.getInteger ("due");
-    if (imminentperiod == 0)
+    if (context.snapshot.imminent == 0)
       return dateAfterToday;
 
-    ISO8601d imminentDay = today + imminentperiod * 86400;
-    if (reference < imminentDay)
+    if (reference < context.snapshot.imminentDay)
       return dateAfterToday;
   }
 
@@ -357,7 +432,7 @@ bool Task::is_ready () const
   return getStatus () == Task::pending &&
          ! is_blocked                  &&
          (! has ("scheduled")          ||
-          ISO8601d ("now").operator> (get_date ("scheduled")));
+          context.snapshot.now > get_date ("scheduled"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -391,7 +466,7 @@ bool Task::is_dueyesterday () const
     if (status != Task::completed &&
         status != Task::deleted)
     {
-      if (ISO8601d ("yesterday").sameDay (get_date ("due")))
+      if (context.snapshot.yesterday.sameDay (get_date ("due")))
         return true;
     }
   }
@@ -429,7 +504,7 @@ bool Task::is_duetomorrow () const
     if (status != Task::completed &&
         status != Task::deleted)
     {
-      if (ISO8601d ("tomorrow").sameDay (get_date ("due")))
+      if (context.snapshot.tomorrow.sameDay (get_date ("due")))
         return true;
     }
   }
@@ -448,8 +523,8 @@ bool Task::is_dueweek () const
         status != Task::deleted)
     {
       ISO8601d due (get_date ("due"));
-      if (due >= ISO8601d ("socw") &&
-          due <= ISO8601d ("eocw"))
+      if (due >= context.snapshot.socw &&
+          due <= context.snapshot.eocw)
         return true;
     }
   }
@@ -468,8 +543,8 @@ bool Task::is_duemonth () const
         status != Task::deleted)
     {
       ISO8601d due (get_date ("due"));
-      if (due >= ISO8601d ("socm") &&
-          due <= ISO8601d ("eocm"))
+      if (due >= context.snapshot.socm &&
+          due <= context.snapshot.eocm)
         return true;
     }
   }
@@ -487,9 +562,8 @@ bool Task::is_dueyear () const
     if (status != Task::completed &&
         status != Task::deleted)
     {
-      ISO8601d now;
       ISO8601d due (get_date ("due"));
-      if (now.year () == due.year ())
+      if (context.snapshot.year == due.year ())
         return true;
     }
   }
@@ -500,9 +574,9 @@ bool Task::is_dueyear () const
 ////////////////////////////////////////////////////////////////////////////////
 bool Task::is_udaPresent () const
 {
-  for (auto& col : context.columns)
-    if (col.second->is_uda () &&
-        has (col.first))
+  for (auto& name : context.columns.names ())
+    if (has (name) &&
+        context.columns[name]->is_uda ())
       return true;
 
   return false;
@@ -513,7 +587,7 @@ bool Task::is_orphanPresent () const
 {
   for (auto& att : data)
     if (att.first.compare (0, 11, "annotation_", 11) != 0)
-      if (context.columns.find (att.first) == context.columns.end ())
+      if (! context.columns.has (att.first))
         return true;
 
   return false;
@@ -611,6 +685,7 @@ void Task::parse (const std::string& input)
     parseLegacy (input);
   }
 
+  invalidateTags ();
   recalc_urgency = true;
 }
 
@@ -899,7 +974,7 @@ std::string Task::composeJSON (bool decorate /*= false*/) const
     // Dependencies are an array by default.
     else if (i.first == "depends"
 #ifdef PRODUCT_TASKWARRIOR
-             && context.config.getBoolean ("json.depends.array")
+             && context.config.getBoolean (jsonDependsArray)
 #endif
             )
     {
@@ -1000,6 +1075,7 @@ void Task::addAnnotation (const std::string& description)
 
   data[key] = json::decode (description);
   ++annotation_count;
+  invalidateTags ();
   recalc_urgency = true;
 }
 
@@ -1019,6 +1095,7 @@ void Task::removeAnnotations ()
       i++;
   }
 
+  invalidateTags ();
   recalc_urgency = true;
 }
 
@@ -1042,6 +1119,7 @@ void Task::setAnnotations (const std::map <std::string, std::string>& annotation
     data.insert (anno);
 
   annotation_count = annotations.size ();
+  invalidateTags ();
   recalc_urgency = true;
 }
 
@@ -1152,10 +1230,8 @@ void Task::getDependencies (std::vector <std::string>& all) const
 ////////////////////////////////////////////////////////////////////////////////
 int Task::getTagCount () const
 {
-  std::vector <std::string> tags;
-  split (tags, get ("tags"), ',');
-
-  return (int) tags.size ();
+  splitTags ();
+  return (int) _tags.size ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1180,45 +1256,93 @@ bool Task::hasTag (const std::string& tag) const
     if (tag == "UNBLOCKED") return !is_blocked;
     if (tag == "BLOCKING")  return is_blocking;
 #ifdef PRODUCT_TASKWARRIOR
+    if (tag == "LATEST")    return id == context.tdb2.latest_id ();
     if (tag == "READY")     return is_ready ();
-    if (tag == "DUE")       return is_due ();
-    if (tag == "DUETODAY")  return is_duetoday ();
-    if (tag == "TODAY")     return is_duetoday ();
-    if (tag == "YESTERDAY") return is_dueyesterday ();
-    if (tag == "TOMORROW")  return is_duetomorrow ();
-    if (tag == "OVERDUE")   return is_overdue ();
-    if (tag == "WEEK")      return is_dueweek ();
-    if (tag == "MONTH")     return is_duemonth ();
-    if (tag == "YEAR")      return is_dueyear ();
 #endif
-    if (tag == "ACTIVE")    return has ("start");
-    if (tag == "SCHEDULED") return has ("scheduled");
-    if (tag == "CHILD")     return has ("parent");
-    if (tag == "UNTIL")     return has ("until");
-    if (tag == "ANNOTATED") return hasAnnotations ();
-    if (tag == "TAGGED")    return has ("tags");
-    if (tag == "PARENT")    return has ("mask");
-    if (tag == "WAITING")   return get ("status") == "waiting";
-    if (tag == "PENDING")   return get ("status") == "pending";
-    if (tag == "COMPLETED") return get ("status") == "completed";
-    if (tag == "DELETED")   return get ("status") == "deleted";
+
+    // The rest depend only on this task, and are cached.
+    auto virt = virtualTags.find (tag);
+    if (virt != virtualTags.end ())
+      return virtualTag (virt->second);
+  }
+
+  // Concrete tags.
+  splitTags ();
+  return std::find (_tags.begin (), _tags.end (), tag) != _tags.end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Evaluates one of the cached virtual tags, at most once per command.
+bool Task::virtualTag (int tag) const
+{
+  time_t now = commandTime ();
+  if (now != _virtual_time)
+  {
+    _virtual_known = 0;
+    _virtual_time = now;
+  }
+
+  unsigned int bit = 1u << tag;
+  if (! (_virtual_known & bit))
+  {
+    bool value = false;
+    switch (tag)
+    {
 #ifdef PRODUCT_TASKWARRIOR
-    if (tag == "UDA")       return is_udaPresent ();
-    if (tag == "ORPHAN")    return is_orphanPresent ();
-    if (tag == "LATEST")    return id == context.tdb2.latest_id ();
+    case vtDue:       value = is_due ();                     break;
+    case vtDueToday:  value = is_duetoday ();                break;
+    case vtYesterday: value = is_dueyesterday ();            break;
+    case vtTomorrow:  value = is_duetomorrow ();             break;
+    case vtOverdue:   value = is_overdue ();                 break;
+    case vtWeek:      value = is_dueweek ();                 break;
+    case vtMonth:     value = is_duemonth ();                break;
+    case vtYear:      value = is_dueyear ();                 break;
+    case vtUDA:       value = is_udaPresent ();              break;
+    case vtOrphan:    value = is_orphanPresent ();           break;
 #endif
-    if (tag == "PROJECT")   return has ("project");
-    if (tag == "PRIORITY")  return has ("priority");
+    case vtActive:    value = has ("start");                 break;
+    case vtScheduled: value = has ("scheduled");             break;
+    case vtChild:     value = has ("parent");                break;
+    case vtUntil:     value = has ("until");                 break;
+    case vtAnnotated: value = hasAnnotations ();             break;
+    case vtTagged:    value = has ("tags");                  break;
+    case vtParent:    value = has ("mask");                  break;
+    case vtWaiting:   value = get ("status") == "waiting";   break;
+    case vtPending:   value = get ("status") == "pending";   break;
+    case vtCompleted: value = get ("status") == "completed"; break;
+    case vtDeleted:   value = get ("status") == "deleted";   break;
+    case vtProject:   value = has ("project");               break;
+    case vtPriority:  value = has ("priority");              break;
+    }
+
+    if (value)
+      _virtual_value |= bit;
+    else
+      _virtual_value &= ~bit;
+
+    _virtual_known |= bit;
   }
 
-  // Concrete tags.
-  std::vector <std::string> tags;
-  split (tags, get ("tags"), ',');
+  return (_virtual_value & bit) != 0;
+}
 
-  if (std::find (tags.begin (), tags.end (), tag) != tags.end ())
-    return true;
+////////////////////////////////////////////////////////////////////////////////
+// Splits the concrete tags, once per change to the task.
+void Task::splitTags () const
+{
+  if (_tags_split)
+    return;
 
-  return false;
+  _tags.clear ();
+  split (_tags, get ("tags"), ',');
+  _tags_split = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Task::invalidateTags ()
+{
+  _virtual_known = 0;
+  _tags_split = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1280,7 +1404,7 @@ void Task::getUDAOrphans (std::vector <std::string>& names) const
 {
   for (auto& it : data)
     if (it.first.compare (0, 11, "annotation_", 11) != 0)
-      if (context.columns.find (it.first) == context.columns.end ())
+      if (! context.columns.has (it.first))
         names.push_back (it.first);
 }
 
@@ -1779,7 +1903,7 @@ float Task::urgency_c () const
     }
   }
 
-  if (is_blocking && context.config.getBoolean ("urgency.inherit"))
+  if (is_blocking && context.config.getBoolean (urgencyInherit))
   {
     float prev = value;
     value = std::max (value, urgency_inherit ());
@@ -1850,7 +1974,7 @@ float Task::urgency_active () const
 float Task::urgency_scheduled () const
 {
   if (has ("scheduled") &&
-      get_date ("scheduled") < time (NULL))
+      get_date ("scheduled") < commandTime ())
     return 1.0;
 
   return 0.0;
@@ -1912,7 +2036,7 @@ float Task::urgency_due () const
 {
   if (has ("due"))
   {
-    ISO8601d now;
+    ISO8601d now (commandTime ());
     ISO8601d due (get_date ("due"));
 
     // Map a range of 21 days to the value 0.2 - 1.0
@@ -1930,7 +2054,7 @@ float Task::urgency_age () const
 {
   assert (has ("entry"));
 
-  ISO8601d now;
+  ISO8601d now (commandTime ());
   ISO8601d entry (get_date ("entry"));
   int age = (now - entry) / 86400;  // in days
 
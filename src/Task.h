@@ -169,6 +169,17 @@ private:
   void validate_before (const std::string&, const std::string&);
   const std::string encode (const std::string&) const;
   const std::string decode (const std::string&) const;
+  bool virtualTag (int) const;
+  void splitTags () const;
+  void invalidateTags ();
+
+  // Tag state derived from 'data', computed on demand.  Virtual tags are
+  // cached as bits, and forgotten when the time snapshot is retaken.
+  mutable unsigned int _virtual_known;
+  mutable unsigned int _virtual_value;
+  mutable time_t _virtual_time;
+  mutable bool _tags_split;
+  mutable std::vector <std::string> _tags;
 
 public:
   float urgency_project () const;
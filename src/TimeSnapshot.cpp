@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <TimeSnapshot.h>
+#include <TimeZone.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Until the first take, only 'now' is meaningful.
+TimeSnapshot::TimeSnapshot ()
+: revision (0)
+, now (time (NULL))
+, imminent (0)
+{
+  TimeZone::toLocal (now, local);
+  year = local.tm_year + 1900;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Named dates are resolved against 'now', so it is set first.  The period is
+// the number of days within which a due date is imminent.
+void TimeSnapshot::take (int imminentPeriod)
+{
+  ++revision;
+  now   = time (NULL);
+  TimeZone::toLocal (now, local);
+  year  = local.tm_year + 1900;
+
+  today     = ISO8601d ("today");
+  yesterday = ISO8601d ("yesterday");
+  tomorrow  = ISO8601d ("tomorrow");
+  socw      = ISO8601d ("socw");
+  eocw      = ISO8601d ("eocw");
+  socm      = ISO8601d ("socm");
+  eocm      = ISO8601d ("eocm");
+
+  imminent    = imminentPeriod;
+  imminentDay = today + imminent * 86400;
+}
+
+////////////////////////////////////////////////////////////////////////////////
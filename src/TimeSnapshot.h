@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TIMESNAPSHOT
+#define INCLUDED_TIMESNAPSHOT
+
+#include <time.h>
+#include <ISO8601.h>
+
+// The moment a command runs, and the dates derived from it that tasks are
+// compared against.  It is taken once per command, so every task in a report
+// is judged against the same time, and the named dates are only resolved once.
+class TimeSnapshot
+{
+public:
+  TimeSnapshot ();
+  void take (int);
+
+  int       revision;     // Incremented by each take
+  time_t    now;
+  struct tm local;        // 'now' in local time
+  ISO8601d  today;
+  ISO8601d  yesterday;
+  ISO8601d  tomorrow;
+  ISO8601d  socw;
+  ISO8601d  eocw;
+  ISO8601d  socm;
+  ISO8601d  eocm;
+  int       year;
+  int       imminent;     // rc.due, in days
+  ISO8601d  imminentDay;  // Start of the day after the imminent period
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,242 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+
+#include <cmake.h>
+#include <TimeZone.h>
+#include <unordered_map>
+
+// The offsets in effect during one UTC day.  Without a transition that day,
+// 'transition' is the start of the next day, and 'after' equals 'before'.
+struct Offsets
+{
+  time_t transition;
+  long   before;
+  long   after;
+  int    dstBefore;
+  int    dstAfter;
+  int    calm;        // No transition within two days: 1, 0, or -1 if unknown
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Built on first use, because the global Context converts times while it is
+// constructed, which may be before this file's statics are.
+static std::unordered_map <long long, Offsets>& table ()
+{
+  static std::unordered_map <long long, Offsets> offsets;
+  return offsets;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static long long dayOf (time_t t)
+{
+  return t / 86400 - (t % 86400 < 0 ? 1 : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The UTC offset and summer time flag that the C library applies at 't'.
+static void probe (time_t t, long& offset, int& dst)
+{
+  struct tm local;
+  if (! localtime_r (&t, &local))
+  {
+    offset = 0;
+    dst    = 0;
+    return;
+  }
+
+  long long wall = (long long) TimeZone::daysFromCivil (local.tm_year + 1900,
+                                                        local.tm_mon + 1,
+                                                        local.tm_mday) * 86400
+                 + (local.tm_hour * 3600)
+                 + (local.tm_min  *   60)
+                 +  local.tm_sec;
+
+  offset = (long) (wall - t);
+  dst    = local.tm_isdst;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Offsets only change at transitions, which are months apart, so probing both
+// ends of the day finds any transition, and a binary search over the day then
+// finds its exact second.
+static Offsets& day (long long index)
+{
+  auto found = table ().find (index);
+  if (found != table ().end ())
+    return found->second;
+
+  time_t start = (time_t) index * 86400;
+  time_t end   = start + 86399;
+
+  Offsets entry;
+  entry.calm = -1;
+  probe (start, entry.before, entry.dstBefore);
+  probe (end,   entry.after,  entry.dstAfter);
+
+  if (entry.before    == entry.after &&
+      entry.dstBefore == entry.dstAfter)
+  {
+    entry.transition = end + 1;
+  }
+  else
+  {
+    time_t low  = start;
+    time_t high = end;
+    while (high - low > 1)
+    {
+      time_t middle = low + (high - low) / 2;
+      long offset;
+      int dst;
+      probe (middle, offset, dst);
+      if (offset == entry.before && dst == entry.dstBefore)
+        low = middle;
+      else
+        high = middle;
+    }
+
+    entry.transition = high;
+  }
+
+  return table ()[index] = entry;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// True if the whole day is spent at the given offset.
+static bool steady (long long index, long offset)
+{
+  const Offsets& entry = day (index);
+  return entry.before    == offset      &&
+         entry.after     == offset      &&
+         entry.dstBefore == entry.dstAfter;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A day is calm when it and the two days either side are spent at one offset.
+// UTC offsets are less than a day, so a local time that reads as a time on a
+// calm day, taken as UTC, exists exactly once, at that offset.
+static bool calm (long long index, Offsets& entry)
+{
+  if (entry.calm == -1)
+  {
+    entry.calm = 1;
+    for (long long i = index - 2; i <= index + 2; ++i)
+      if (! steady (i, entry.before))
+        entry.calm = 0;
+  }
+
+  return entry.calm == 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Equivalent to localtime_r, except that tm_gmtoff and tm_zone are not set.
+void TimeZone::toLocal (time_t t, struct tm& local)
+{
+  const Offsets& entry = day (dayOf (t));
+  bool after = t >= entry.transition;
+
+  time_t wall = t + (after ? entry.after : entry.before);
+  long long days = dayOf (wall);
+  int seconds = (int) (wall - days * 86400);
+
+  int y, m, d;
+  civilFromDays ((int) days, y, m, d);
+
+  local = {};
+  local.tm_year  = y - 1900;
+  local.tm_mon   = m - 1;
+  local.tm_mday  = d;
+  local.tm_hour  = seconds / 3600;
+  local.tm_min   = (seconds % 3600) / 60;
+  local.tm_sec   = seconds % 60;
+  local.tm_wday  = (int) (((days % 7) + 11) % 7);  // 1970-01-01 was a Thursday.
+  local.tm_yday  = (int) days - daysFromCivil (y, 1, 1);
+  local.tm_isdst = after ? entry.dstAfter : entry.dstBefore;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Equivalent to mktime with tm_isdst = -1, including the normalization of
+// out-of-range fields.  A local time near a transition may not exist, or may
+// exist twice, so it is left to mktime to decide.
+time_t TimeZone::fromLocal (int y, int m, int d, int hour, int minute, int second)
+{
+  y += floorDiv (m - 1, 12);
+  m -= floorDiv (m - 1, 12) * 12;
+
+  time_t wall = ((time_t) daysFromCivil (y, m, 1) + d - 1) * 86400
+              + ((time_t) hour * 3600)
+              + ((time_t) minute * 60)
+              + second;
+
+  long long index = dayOf (wall);
+  Offsets& entry = day (index);
+  if (calm (index, entry))
+    return wall - entry.before;
+
+  struct tm local {};
+  local.tm_isdst = -1;
+  local.tm_year  = y - 1900;
+  local.tm_mon   = m - 1;
+  local.tm_mday  = d;
+  local.tm_hour  = hour;
+  local.tm_min   = minute;
+  local.tm_sec   = second;
+  return mktime (&local);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Days since 1970-01-01 of a proleptic Gregorian date.
+int TimeZone::daysFromCivil (int y, int m, int d)
+{
+  y -= m <= 2;
+  int era = (y >= 0 ? y : y - 399) / 400;
+  int yoe = y - era * 400;
+  int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Inverse of daysFromCivil.
+void TimeZone::civilFromDays (int days, int& y, int& m, int& d)
+{
+  days += 719468;
+  int era = (days >= 0 ? days : days - 146096) / 146097;
+  int doe = days - era * 146097;
+  int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp + (mp < 10 ? 3 : -9);
+  y = yoe + era * 400 + (m <= 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Floor division, for periods before the epoch.
+int TimeZone::floorDiv (int a, int b)
+{
+  return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+////////////////////////////////////////////////////////////////////////////////
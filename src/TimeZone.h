@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+
+#ifndef INCLUDED_TIMEZONE
+#define INCLUDED_TIMEZONE
+
+#include <time.h>
+
+// Conversions between time_t and local civil time for the process time zone,
+// without a libc call per conversion.  The UTC offsets in effect are learned
+// from localtime_r once for each day of the timeline that is visited, along
+// with the instant of any transition on that day, after which conversions are
+// arithmetic.  Local times close to a transition, which may be skipped or
+// repeated, are still resolved by mktime.
+//
+// Like localtime, which it replaces, this is not for concurrent use.
+class TimeZone
+{
+public:
+  static void toLocal (time_t, struct tm&);
+  static time_t fromLocal (int, int, int, int, int, int);
+
+  static int daysFromCivil (int, int, int);
+  static void civilFromDays (int, int&, int&, int&);
+  static int floorDiv (int, int);
+};
+
+#endif
+////////////////////////////////////////////////////////////////////////////////
@@ -41,6 +41,15 @@ std::string Variant::dateFormat = "";
 bool Variant::searchCaseSensitive = true;
 bool Variant::searchUsingRegex = true;
 
+////////////////////////////////////////////////////////////////////////////////
+// True if Lexer::dequote would modify the string, in which case an operator
+// must work on a copy.
+static bool quoted (const std::string& input)
+{
+  return (input[0] == '\'' || input[0] == '"') &&
+         input[input.length () - 1] == input[0];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 Variant::Variant ()
 : _type (type_boolean)
@@ -51,6 +60,8 @@ Variant::Variant ()
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -64,6 +75,23 @@ Variant::Variant (const Variant& other)
 , _date (other._date)
 , _duration (other._duration)
 , _source (other._source)
+, _precast (other._precast)
+, _precast_value (other._precast_value)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Variant::Variant (Variant&& other)
+: _type (other._type)
+, _bool (other._bool)
+, _integer (other._integer)
+, _real (other._real)
+, _string (std::move (other._string))
+, _date (other._date)
+, _duration (other._duration)
+, _source (std::move (other._source))
+, _precast (other._precast)
+, _precast_value (other._precast_value)
 {
 }
 
@@ -77,6 +105,8 @@ Variant::Variant (const bool value)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -90,6 +120,8 @@ Variant::Variant (const int value)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -103,6 +135,8 @@ Variant::Variant (const double value)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -116,6 +150,8 @@ Variant::Variant (const std::string& value)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -129,6 +165,8 @@ Variant::Variant (const char* value)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
 }
 
@@ -142,6 +180,8 @@ Variant::Variant (const time_t value, const enum type new_type)
 , _date (0)
 , _duration (0)
 , _source ("")
+, _precast (type_string)
+, _precast_value (0)
 {
   switch (new_type)
   {
@@ -177,6 +217,28 @@ Variant& Variant::operator= (const Variant& other)
     _date     = other._date;
     _duration = other._duration;
     _source   = other._source;
+    _precast  = other._precast;
+    _precast_value = other._precast_value;
+  }
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Variant& Variant::operator= (Variant&& other)
+{
+  if (this != &other)
+  {
+    _type     = other._type;
+    _bool     = other._bool;
+    _integer  = other._integer;
+    _real     = other._real;
+    _string   = std::move (other._string);
+    _date     = other._date;
+    _duration = other._duration;
+    _source   = std::move (other._source);
+    _precast  = other._precast;
+    _precast_value = other._precast_value;
   }
 
   return *this;
@@ -185,6 +247,10 @@ Variant& Variant::operator= (const Variant& other)
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator&& (const Variant& other) const
 {
+  // The common case, needing neither copies nor casts.
+  if (_type == type_boolean && other._type == type_boolean)
+    return _bool && other._bool;
+
   Variant left (*this);
   Variant right (other);
 
@@ -203,6 +269,10 @@ bool Variant::operator&& (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator|| (const Variant& other) const
 {
+  // The common case, needing neither copies nor casts.
+  if (_type == type_boolean && other._type == type_boolean)
+    return _bool || other._bool;
+
   Variant left (*this);
   Variant right (other);
 
@@ -221,6 +291,9 @@ bool Variant::operator|| (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator_xor (const Variant& other) const
 {
+  if (_type == type_boolean && other._type == type_boolean)
+    return _bool != other._bool;
+
   Variant left (*this);
   Variant right (other);
 
@@ -240,6 +313,27 @@ bool Variant::operator_xor (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator< (const Variant& other) const
 {
+  // Like types need neither copies nor casts.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer < other._integer;
+    case type_real:     return _real < other._real;
+    case type_date:     return ! trivial () && ! other.trivial () && _date < other._date;
+    case type_duration: return ! trivial () && ! other.trivial () && _duration < other._duration;
+    default:            break;
+    }
+  }
+
+  // Nor does a date or duration against a string cast to it in advance.
+  enum type kind;
+  bool trivial_value;
+  time_t left_value;
+  time_t right_value;
+  if (precastOperands (other, kind, trivial_value, left_value, right_value))
+    return ! trivial_value && left_value < right_value;
+
   Variant left (*this);
   Variant right (other);
 
@@ -375,6 +469,27 @@ bool Variant::operator< (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator<= (const Variant& other) const
 {
+  // Like types need neither copies nor casts.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer <= other._integer;
+    case type_real:     return _real <= other._real;
+    case type_date:     return ! trivial () && ! other.trivial () && _date <= other._date;
+    case type_duration: return ! trivial () && ! other.trivial () && _duration <= other._duration;
+    default:            break;
+    }
+  }
+
+  // Nor does a date or duration against a string cast to it in advance.
+  enum type kind;
+  bool trivial_value;
+  time_t left_value;
+  time_t right_value;
+  if (precastOperands (other, kind, trivial_value, left_value, right_value))
+    return ! trivial_value && left_value <= right_value;
+
   Variant left (*this);
   Variant right (other);
 
@@ -510,6 +625,27 @@ bool Variant::operator<= (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator> (const Variant& other) const
 {
+  // Like types need neither copies nor casts.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer > other._integer;
+    case type_real:     return _real > other._real;
+    case type_date:     return ! trivial () && ! other.trivial () && _date > other._date;
+    case type_duration: return ! trivial () && ! other.trivial () && _duration > other._duration;
+    default:            break;
+    }
+  }
+
+  // Nor does a date or duration against a string cast to it in advance.
+  enum type kind;
+  bool trivial_value;
+  time_t left_value;
+  time_t right_value;
+  if (precastOperands (other, kind, trivial_value, left_value, right_value))
+    return ! trivial_value && left_value > right_value;
+
   Variant left (*this);
   Variant right (other);
 
@@ -645,6 +781,27 @@ bool Variant::operator> (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator>= (const Variant& other) const
 {
+  // Like types need neither copies nor casts.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer >= other._integer;
+    case type_real:     return _real >= other._real;
+    case type_date:     return ! trivial () && ! other.trivial () && _date >= other._date;
+    case type_duration: return ! trivial () && ! other.trivial () && _duration >= other._duration;
+    default:            break;
+    }
+  }
+
+  // Nor does a date or duration against a string cast to it in advance.
+  enum type kind;
+  bool trivial_value;
+  time_t left_value;
+  time_t right_value;
+  if (precastOperands (other, kind, trivial_value, left_value, right_value))
+    return ! trivial_value && left_value >= right_value;
+
   Variant left (*this);
   Variant right (other);
 
@@ -780,6 +937,39 @@ bool Variant::operator>= (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator== (const Variant& other) const
 {
+  // Like types need neither copies nor casts, unless quoted.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer == other._integer;
+    case type_real:     return _real == other._real;
+    case type_date:     return ! trivial () && ! other.trivial () && _date == other._date;
+    case type_duration: return _duration == other._duration;
+    case type_string:
+      if (quoted (_string) || quoted (other._string))
+        break;
+
+      // Status is always compared caseless.
+      if (_source == "status")
+        return compare (_string, other._string, false);
+
+      return _string == other._string;
+
+    default:
+      break;
+    }
+  }
+
+  // Nor does a date or duration against a string cast to it in advance.  As
+  // below, only dates treat a zero value as unequal to everything.
+  enum type kind;
+  bool trivial_value;
+  time_t left_value;
+  time_t right_value;
+  if (precastOperands (other, kind, trivial_value, left_value, right_value))
+    return (kind == type_duration || ! trivial_value) && left_value == right_value;
+
   Variant left (*this);
   Variant right (other);
 
@@ -986,6 +1176,33 @@ bool Variant::operator_nomatch (const Variant& other, const Task& task) const
 //
 bool Variant::operator_partial (const Variant& other) const
 {
+  // Like types need neither copies nor casts, unless quoted.
+  if (_type == other._type)
+  {
+    switch (_type)
+    {
+    case type_integer:  return _integer == other._integer;
+    case type_real:     return _real == other._real;
+    case type_duration: return _duration == other._duration;
+    case type_date:     return ISO8601d (_date).sameDay (ISO8601d (other._date));
+    case type_string:
+      if (quoted (_string) || quoted (other._string))
+        break;
+
+      // Status is always compared caseless.
+      if (_source == "status")
+        return compare (_string, other._string, false);
+
+      if (_string.length () == 0 || other._string.length () == 0)
+        return _string.length () == other._string.length ();
+
+      return _string.compare (0, other._string.length (), other._string) == 0;
+
+    default:
+      break;
+    }
+  }
+
   Variant left (*this);
   Variant right (other);
 
@@ -1164,6 +1381,9 @@ bool Variant::operator_nopartial (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator_hastag (const Variant& other, const Task& task) const
 {
+  if (other._type == type_string && ! quoted (other._string))
+    return task.hasTag (other._string);
+
   Variant right (other);
   right.cast (type_string);
   Lexer::dequote (right._string);
@@ -1179,6 +1399,9 @@ bool Variant::operator_notag (const Variant& other, const Task& task) const
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::operator! () const
 {
+  if (_type == type_boolean)
+    return ! _bool;
+
   Variant left (*this);
 
   if (left._type == type_string)
@@ -1191,6 +1414,8 @@ bool Variant::operator! () const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator^= (const Variant& other)
 {
+  _precast = type_string;
+
   switch (_type)
   {
   case type_boolean:
@@ -1248,6 +1473,8 @@ Variant Variant::operator^ (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator-= (const Variant& other)
 {
+  _precast = type_string;
+
   Variant right (other);
 
   switch (_type)
@@ -1328,6 +1555,8 @@ Variant Variant::operator- (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator+= (const Variant& other)
 {
+  _precast = type_string;
+
   Variant right (other);
 
   if (right._type == type_string)
@@ -1429,6 +1658,8 @@ Variant Variant::operator+ (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator*= (const Variant& other)
 {
+  _precast = type_string;
+
   Variant right (other);
 
   if (right._type == type_string)
@@ -1543,6 +1774,8 @@ Variant Variant::operator* (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator/= (const Variant& other)
 {
+  _precast = type_string;
+
   Variant right (other);
 
   switch (_type)
@@ -1669,6 +1902,8 @@ Variant Variant::operator/ (const Variant& other) const
 ////////////////////////////////////////////////////////////////////////////////
 Variant& Variant::operator%= (const Variant& other)
 {
+  _precast = type_string;
+
   Variant right (other);
 
   switch (_type)
@@ -1864,6 +2099,15 @@ void Variant::cast (const enum type new_type)
 
   case type_string:
     Lexer::dequote (_string);
+    if (new_type == _precast)
+    {
+      if (new_type == type_date)
+        _date = _precast_value;
+      else
+        _duration = _precast_value;
+      break;
+    }
+
     switch (new_type)
     {
     case type_boolean:
@@ -1945,6 +2189,39 @@ void Variant::cast (const enum type new_type)
   }
 
   _type = new_type;
+  _precast = type_string;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Casts a string to a date or duration now, and keeps the result for later
+// casts of this value, so that a literal compared against many tasks is only
+// parsed once.
+void Variant::precast (const enum type new_type)
+{
+  if (_type != type_string ||
+      (new_type != type_date && new_type != type_duration))
+    return;
+
+  // An empty string is trivial, and must compare as one, so it is left as is.
+  std::string value = _string;
+  Lexer::dequote (value);
+  if (value == "")
+    return;
+
+  // A string that fails to cast is left to fail when, and if, it is cast.
+  Variant cast (*this);
+  try
+  {
+    cast.cast (new_type);
+  }
+
+  catch (const std::string&)
+  {
+    return;
+  }
+
+  _precast       = new_type;
+  _precast_value = new_type == type_date ? cast._date : cast._duration;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1965,6 +2242,42 @@ bool Variant::trivial () const
   return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Recognizes a date or duration compared with a string already precast to the
+// same type, and yields the two values in operand order, the type, and whether
+// the date or duration is trivial.  A precast string is never trivial.
+bool Variant::precastOperands (
+  const Variant& other,
+  enum type& kind,
+  bool& trivial_value,
+  time_t& left_value,
+  time_t& right_value) const
+{
+  if ((_type == type_date || _type == type_duration) &&
+      other._type == type_string &&
+      other._precast == _type)
+  {
+    kind          = _type;
+    trivial_value = trivial ();
+    left_value    = _type == type_date ? _date : _duration;
+    right_value   = other._precast_value;
+    return true;
+  }
+
+  if ((other._type == type_date || other._type == type_duration) &&
+      _type == type_string &&
+      _precast == other._type)
+  {
+    kind          = other._type;
+    trivial_value = other.trivial ();
+    left_value    = _precast_value;
+    right_value   = other._type == type_date ? other._date : other._duration;
+    return true;
+  }
+
+  return false;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 bool Variant::get_bool () const
 {
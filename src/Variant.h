@@ -44,6 +44,7 @@ public:
 
   Variant ();
   Variant (const Variant&);
+  Variant (Variant&&);
   Variant (const bool);
   Variant (const int);
   Variant (const double);
@@ -55,6 +56,7 @@ public:
   const std::string& source () const;
 
   Variant& operator= (const Variant&);
+  Variant& operator= (Variant&&);
 
   bool operator&& (const Variant&) const;
   bool operator|| (const Variant&) const;
@@ -95,6 +97,7 @@ public:
   void sqrt ();
 
   void cast (const enum type);
+  void precast (const enum type);
   int type ();
   bool trivial () const;
 
@@ -105,6 +108,9 @@ public:
   time_t             get_date () const;
   time_t             get_duration () const;
 
+private:
+  bool precastOperands (const Variant&, enum type&, bool&, time_t&, time_t&) const;
+
 private:
   enum type   _type;
   bool        _bool;
@@ -115,6 +121,11 @@ private:
   time_t      _duration;
 
   std::string _source;
+
+  // The result of casting this string to _precast, resolved in advance.  A
+  // _precast of type_string means there is none.
+  enum type   _precast;
+  time_t      _precast_value;
 };
 
 #endif
@@ -112,6 +112,7 @@ ViewTask::~ViewTask ()
 std::string ViewTask::render (std::vector <Task>& data, std::vector <int>& sequence)
 {
   context.timer_render.start ();
+  Profiler::Span span ("ViewTask::render");
 
   bool const obfuscate           = context.config.getBoolean ("obfuscate");
   bool const print_empty_columns = context.config.getBoolean ("print.empty.columns");
@@ -119,6 +120,7 @@ std::string ViewTask::render (std::vector <Task>& data, std::vector <int>& seque
   std::vector <bool> nonempty_sort;
 
   // Determine minimal, ideal column widths.
+  Profiler::Span measure ("ViewTask::measure");
   std::vector <int> minimal;
   std::vector <int> ideal;
 
@@ -181,6 +183,8 @@ std::string ViewTask::render (std::vector <Task>& data, std::vector <int>& seque
     _sort = nonempty_sort;
   }
 
+  measure.stop ();
+
   int all_extra = _left_margin
                 + (2 * _extra_padding)
                 + ((_columns.size () - 1) * _intra_padding);
@@ -26,6 +26,8 @@
 
 #include <cmake.h>
 #include <ColTypeDate.h>
+#include <map>
+#include <unordered_map>
 #include <Context.h>
 #include <ISO8601.h>
 #include <text.h>
@@ -33,8 +35,18 @@
 
 extern Context context;
 
+// Formatted cells, shared by all date columns.  Keyed first by date format or
+// style, then by epoch.  The same date is formatted by measure and render, and
+// often by several columns.
+static std::map <std::string, std::unordered_map <time_t, std::string>> formatCells;
+static std::map <std::string, std::unordered_map <time_t, std::string>> styleCells;
+static const unsigned int cellsLimit = 65536;
+
 ////////////////////////////////////////////////////////////////////////////////
 ColumnTypeDate::ColumnTypeDate ()
+: _dateformat ("")
+, _dateformat_report ("")
+, _dateformat_revision (0)
 {
   _name      = "";
   _type      = "date";
@@ -74,39 +86,23 @@ void ColumnTypeDate::measure (Task& task, unsigned int& minimum, unsigned int& m
     if (_style == "default" ||
         _style == "formatted")
     {
-      // Determine the output date format, which uses a hierarchy of definitions.
-      //   rc.report.<report>.dateformat
-      //   rc.dateformat.report
-      //   rc.dateformat.
-      std::string format = context.config.get ("report." + _report + ".dateformat");
-      if (format == "")
-        format = context.config.get ("dateformat.report");
-      if (format == "")
-        format = context.config.get ("dateformat");
-
-      minimum = maximum = ISO8601d::length (format);
+      minimum = maximum = ISO8601d::length (dateFormat ());
     }
     else if (_style == "countdown")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now > date)
         minimum = maximum = ISO8601p (now - date).formatVague ().length ();
     }
-    else if (_style == "julian")
-    {
-      minimum = maximum = format (date.toJulian (), 13, 12).length ();
-    }
-    else if (_style == "epoch")
-    {
-      minimum = maximum = date.toEpochString ().length ();
-    }
-    else if (_style == "iso")
+    else if (_style == "julian" ||
+             _style == "epoch"  ||
+             _style == "iso")
     {
-      minimum = maximum = date.toISO ().length ();
+      minimum = maximum = formatted (date.toEpoch ()).length ();
     }
     else if (_style == "age")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now > date)
         minimum = maximum = ISO8601p (now - date).formatVague ().length ();
       else
@@ -114,7 +110,7 @@ void ColumnTypeDate::measure (Task& task, unsigned int& minimum, unsigned int& m
     }
     else if (_style == "relative")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now < date)
         minimum = maximum = ISO8601p (date - now).formatVague ().length ();
       else
@@ -122,7 +118,7 @@ void ColumnTypeDate::measure (Task& task, unsigned int& minimum, unsigned int& m
     }
     else if (_style == "remaining")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (date > now)
         minimum = maximum = ISO8601p (date - now).formatVague ().length ();
     }
@@ -144,39 +140,24 @@ void ColumnTypeDate::render (
 
     if (_style == "default" ||
         _style == "formatted")
-    {
-      // Determine the output date format, which uses a hierarchy of definitions.
-      //   rc.report.<report>.dateformat
-      //   rc.dateformat.report
-      //   rc.dateformat
-      std::string format = context.config.get ("report." + _report + ".dateformat");
-      if (format == "")
-      {
-        format = context.config.get ("dateformat.report");
-        if (format == "")
-          format = context.config.get ("dateformat");
-      }
-
-      renderStringLeft (lines, width, color, date.toString (format));
-    }
+      renderStringLeft (lines, width, color, formatted (date.toEpoch ()));
     else if (_style == "countdown")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now > date)
         renderStringRight (lines, width, color, ISO8601p (now - date).formatVague ());
     }
     else if (_style == "julian")
-      renderStringRight (lines, width, color, format (date.toJulian (), 13, 12));
+      renderStringRight (lines, width, color, formatted (date.toEpoch ()));
 
     else if (_style == "epoch")
-      renderStringRight (lines, width, color, date.toEpochString ());
+      renderStringRight (lines, width, color, formatted (date.toEpoch ()));
 
     else if (_style == "iso")
-      renderStringLeft (lines, width, color, date.toISO ());
-
+      renderStringLeft (lines, width, color, formatted (date.toEpoch ()));
     else if (_style == "age")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now > date)
         renderStringLeft (lines, width, color, ISO8601p (now - date).formatVague ());
       else
@@ -184,7 +165,7 @@ void ColumnTypeDate::render (
     }
     else if (_style == "relative")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (now < date)
         renderStringLeft (lines, width, color, ISO8601p (date - now).formatVague ());
       else
@@ -193,7 +174,7 @@ void ColumnTypeDate::render (
 
     else if (_style == "remaining")
     {
-      ISO8601d now;
+      ISO8601d now (context.snapshot.now);
       if (date > now)
         renderStringRight (lines, width, color, ISO8601p (date - now).formatVague ());
     }
@@ -201,3 +182,71 @@ void ColumnTypeDate::render (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Determine the output date format, which uses a hierarchy of definitions.
+//   rc.report.<report>.dateformat
+//   rc.dateformat.report
+//   rc.dateformat
+// Resolved once per report and configuration, not once per cell.
+const std::string& ColumnTypeDate::dateFormat ()
+{
+  if (_dateformat_revision != context.config.revision () ||
+      _dateformat_report != _report)
+  {
+    _dateformat = context.config.get ("report." + _report + ".dateformat");
+    if (_dateformat == "")
+    {
+      _dateformat = context.config.get ("dateformat.report");
+      if (_dateformat == "")
+        _dateformat = context.config.get ("dateformat");
+    }
+
+    _dateformat_report = _report;
+    _dateformat_revision = context.config.revision ();
+  }
+
+  return _dateformat;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The date rendered in one of the absolute styles.
+const std::string& ColumnTypeDate::formatted (time_t epoch)
+{
+  bool byFormat = _style == "default" || _style == "formatted";
+  auto& cache = byFormat ? formatCells[dateFormat ()] : styleCells[_style];
+
+  auto cell = cache.find (epoch);
+  if (cell != cache.end ())
+    return cell->second;
+
+  if (cache.size () >= cellsLimit)
+    cache.clear ();
+
+  ISO8601d date (epoch);
+  std::string value;
+  if (byFormat)
+    value = date.toString (dateFormat ());
+  else if (_style == "julian")
+    value = format (date.toJulian (), 13, 12);
+  else if (_style == "epoch")
+    value = date.toEpochString ();
+  else
+    value = date.toISO ();
+
+  return cache[epoch] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The number of formatted cells held, across all date columns.
+unsigned int ColumnTypeDate::cachedCells ()
+{
+  unsigned int count = 0;
+  for (auto& cells : formatCells)
+    count += cells.second.size ();
+
+  for (auto& cells : styleCells)
+    count += cells.second.size ();
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -39,6 +39,17 @@ public:
   ColumnTypeDate ();
   virtual void measure (Task&, unsigned int&, unsigned int&);
   virtual void render (std::vector <std::string>&, Task&, int, Color&);
+
+  static unsigned int cachedCells ();
+
+private:
+  const std::string& dateFormat ();
+  const std::string& formatted (time_t);
+
+private:
+  std::string  _dateformat;
+  std::string  _dateformat_report;
+  unsigned int _dateformat_revision;
 };
 
 #endif
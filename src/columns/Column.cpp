@@ -27,6 +27,7 @@
 #include <cmake.h>
 #include <Column.h>
 #include <algorithm>
+#include <assert.h>
 #include <set>
 #include <Context.h>
 #include <ColDepends.h>
@@ -116,39 +117,64 @@ Column* Column::factory (const std::string& name, const std::string& report)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Bulk column instantiation.
-void Column::factory (std::map <std::string, Column*>& all)
+// Registers a built-in column under its name, without constructing it.  The
+// type is recorded separately, because the attribute types are needed for
+// parsing whether or not the column is ever used.
+template <class T>
+static void add (
+  Registry <Column>& all,
+  std::map <std::string, std::string>& types,
+  const std::string& name,
+  const std::string& type)
 {
-  Column* c;
+  types[name] = type;
+  all.add (name, [name, type] () -> Column*
+  {
+    Column* c = new T ();
+    assert (c->name () == name);
+    assert (c->type () == type);
+    return c;
+  });
+}
 
-  c = new ColumnDepends ();        all[c->_name] = c;
-  c = new ColumnDescription ();    all[c->_name] = c;
-  c = new ColumnDue ();            all[c->_name] = c;
-  c = new ColumnEnd ();            all[c->_name] = c;
-  c = new ColumnEntry ();          all[c->_name] = c;
-  c = new ColumnID ();             all[c->_name] = c;
-  c = new ColumnIMask ();          all[c->_name] = c;
-  c = new ColumnMask ();           all[c->_name] = c;
-  c = new ColumnModified ();       all[c->_name] = c;
-  c = new ColumnParent ();         all[c->_name] = c;
-  c = new ColumnProject ();        all[c->_name] = c;
-  c = new ColumnRecur ();          all[c->_name] = c;
-  c = new ColumnScheduled ();      all[c->_name] = c;
-  c = new ColumnStart ();          all[c->_name] = c;
-  c = new ColumnStatus ();         all[c->_name] = c;
-  c = new ColumnTags ();           all[c->_name] = c;
-  c = new ColumnUntil ();          all[c->_name] = c;
-  c = new ColumnUrgency ();        all[c->_name] = c;
-  c = new ColumnUUID ();           all[c->_name] = c;
-  c = new ColumnWait ();           all[c->_name] = c;
-
-  Column::uda (all);
+////////////////////////////////////////////////////////////////////////////////
+// Bulk column registration.  Columns are only constructed when first used.
+void Column::factory (
+  Registry <Column>& all,
+  std::map <std::string, std::string>& types)
+{
+  Profiler::Span span ("Column::factory");
+
+  add <ColumnDepends>     (all, types, "depends",     "string");
+  add <ColumnDescription> (all, types, "description", "string");
+  add <ColumnDue>         (all, types, "due",         "date");
+  add <ColumnEnd>         (all, types, "end",         "date");
+  add <ColumnEntry>       (all, types, "entry",       "date");
+  add <ColumnID>          (all, types, "id",          "numeric");
+  add <ColumnIMask>       (all, types, "imask",       "numeric");
+  add <ColumnMask>        (all, types, "mask",        "string");
+  add <ColumnModified>    (all, types, "modified",    "date");
+  add <ColumnParent>      (all, types, "parent",      "string");
+  add <ColumnProject>     (all, types, "project",     "string");
+  add <ColumnRecur>       (all, types, "recur",       "string");
+  add <ColumnScheduled>   (all, types, "scheduled",   "date");
+  add <ColumnStart>       (all, types, "start",       "date");
+  add <ColumnStatus>      (all, types, "status",      "string");
+  add <ColumnTags>        (all, types, "tags",        "string");
+  add <ColumnUntil>       (all, types, "until",       "date");
+  add <ColumnUrgency>     (all, types, "urgency",     "numeric");
+  add <ColumnUUID>        (all, types, "uuid",        "string");
+  add <ColumnWait>        (all, types, "wait",        "date");
+
+  Column::uda (all, types);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Column::uda (std::map <std::string, Column*>& all)
+void Column::uda (
+  Registry <Column>& all,
+  std::map <std::string, std::string>& types)
 {
-  // For each UDA, instantiate and initialize ColumnUDA().
+  // For each UDA, register a ColumnUDA().
   std::set <std::string> udas;
 
   for (auto& i : context.config)
@@ -164,11 +190,23 @@ void Column::uda (std::map <std::string, Column*>& all)
 
   for (auto& uda : udas)
   {
-    if (all.find (uda) != all.end ())
+    if (all.has (uda))
       throw format (STRING_UDA_COLLISION, uda);
 
-    Column* c = Column::uda (uda);
-    all[c->_name] = c;
+    // The type is validated here rather than in Column::uda, so that a bad
+    // definition is reported at startup, whether or not the column is used.
+    std::string type = context.config.get ("uda." + uda + ".type");
+    if (type == "")
+      context.error (format  (STRING_UDA_TYPE_MISSING, uda));
+
+    if (type != "string"   &&
+        type != "date"     &&
+        type != "duration" &&
+        type != "numeric")
+      context.error (STRING_UDA_TYPE);
+
+    types[uda] = type;
+    all.add (uda, [uda] () -> Column* { return Column::uda (uda); });
   }
 }
 
@@ -177,19 +215,9 @@ Column* Column::uda (const std::string& name)
 {
   ColumnUDA* c = new ColumnUDA ();
   c->_name = name;
+  c->_type = context.config.get ("uda." + name + ".type");
 
-  std::string key = "uda." + name + ".type";
-  c->_type = context.config.get (key);
-  if (c->_type == "")
-    context.error (format  (STRING_UDA_TYPE_MISSING, name));
-
-  if (c->_type != "string"   &&
-      c->_type != "date"     &&
-      c->_type != "duration" &&
-      c->_type != "numeric")
-    context.error (STRING_UDA_TYPE);
-
-  key = "uda." + name + ".label";
+  std::string key = "uda." + name + ".label";
   if (context.config.get (key) != "")
     c->_label = context.config.get (key);
 
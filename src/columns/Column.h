@@ -31,13 +31,14 @@
 #include <string>
 #include <Color.h>
 #include <Task.h>
+#include <Registry.h>
 
 class Column
 {
 public:
   static Column* factory (const std::string&, const std::string&);
-  static void factory (std::map <std::string, Column*>&);
-  static void uda (std::map <std::string, Column*>&);
+  static void factory (Registry <Column>&, std::map <std::string, std::string>&);
+  static void uda (Registry <Column>&, std::map <std::string, std::string>&);
   static Column* uda (const std::string&);
 
   Column ();
@@ -34,6 +34,7 @@
 #include <math.h>
 #include <Context.h>
 #include <Filter.h>
+#include <Histogram.h>
 #include <ISO8601.h>
 #include <main.h>
 #include <i18n.h>
@@ -153,9 +154,6 @@ public:
 private:
   void generateBars ();
   void optimizeGrid ();
-  ISO8601d quantize (const ISO8601d&, char);
-
-  ISO8601d increment (const ISO8601d&, char);
   ISO8601d decrement (const ISO8601d&, char);
   void maxima ();
   void yLabels (std::vector <int>&);
@@ -227,59 +225,75 @@ Chart::~Chart ()
 // and corresponding epoch.
 void Chart::scanForPeak (std::vector <Task>& tasks)
 {
-  std::map <time_t, int> pending;
+  // Each task is pending from the day of its entry up to its end, or now.
+  time_t now = time (NULL);
+  std::vector <std::pair <int, int>> spans;
+  int first = std::numeric_limits <int>::max ();
+  int last  = std::numeric_limits <int>::min ();
   for (auto& task : tasks)
   {
-    // The entry date is when the counting starts.
-    ISO8601d entry = ISO8601d (task.get_date ("entry"));
-
-    ISO8601d end;
-    if (task.has ("end"))
-      end = ISO8601d (task.get_date ("end"));
-
-    while (entry < end)
+    time_t entry = task.get_date ("entry");
+    time_t end = task.has ("end") ? task.get_date ("end") : now;
+    if (entry < end)
     {
-      time_t epoch = quantize (entry.toEpoch (), 'D').toEpoch ();
-      if (pending.find (epoch) != pending.end ())
-        ++pending[epoch];
-      else
-        pending[epoch] = 1;
-
-      entry = increment (entry, 'D');
+      int from = Histogram::period (entry, 'D');
+      int to   = Histogram::ceiling (end, 'D');
+      spans.push_back ({from, to});
+      first = std::min (first, from);
+      last  = std::max (last, to - 1);
     }
   }
 
+  Histogram pending ('D', first, last);
+  for (auto& span : spans)
+    pending.add (span.first, span.second, 1);
+
+  pending.resolve ();
+
   // Find the peak, peak date and current.
   _peak_count = 0;
-  for (auto& count : pending)
+  for (int day = first; day <= last; ++day)
   {
-    if (count.second > _peak_count)
+    int count = pending[day];
+    if (count)
     {
-      _peak_count = count.second;
-      _peak_epoch = count.first;
-    }
+      if (count > _peak_count)
+      {
+        _peak_count = count;
+        _peak_epoch = Histogram::epoch (day, 'D');
+      }
 
-    _current_count = count.second;
+      _current_count = count;
+    }
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Each task contributes an interval of periods to at most two of the pending,
+// started and done series, which are accumulated as histograms over the bars.
 void Chart::scan (std::vector <Task>& tasks)
 {
   generateBars ();
 
-  // Not quantized, so that "while (xxx < now)" is inclusive.
-  ISO8601d now;
+  // The bars cover consecutive periods, ending with the current one.
+  time_t now = time (NULL);
+  int last = Histogram::period (now, _period);
+  int first = last - _estimated_bars + 1;
+
+  // Not quantized, so that "period < now" is inclusive.
+  int current = Histogram::ceiling (now, _period);
+
+  Histogram added   (_period, first, last);
+  Histogram removed (_period, first, last);
+  Histogram pending (_period, first, last);
+  Histogram started (_period, first, last);
+  Histogram done    (_period, first, last);
 
-  time_t epoch;
   for (auto& task : tasks)
   {
     // The entry date is when the counting starts.
-    ISO8601d from = quantize (ISO8601d (task.get_date ("entry")), _period);
-    epoch = from.toEpoch ();
-
-    if (_bars.find (epoch) != _bars.end ())
-      ++_bars[epoch]._added;
+    int from = Histogram::period (task.get_date ("entry"), _period);
+    added.add (from);
 
     // e-->   e--s-->
     // ppp>   pppsss>
@@ -289,33 +303,12 @@ void Chart::scan (std::vector <Task>& tasks)
     {
       if (task.has ("start"))
       {
-        ISO8601d start = quantize (ISO8601d (task.get_date ("start")), _period);
-        while (from < start)
-        {
-          epoch = from.toEpoch ();
-          if (_bars.find (epoch) != _bars.end ())
-            ++_bars[epoch]._pending;
-          from = increment (from, _period);
-        }
-
-        while (from < now)
-        {
-          epoch = from.toEpoch ();
-          if (_bars.find (epoch) != _bars.end ())
-            ++_bars[epoch]._started;
-          from = increment (from, _period);
-        }
+        int start = Histogram::period (task.get_date ("start"), _period);
+        pending.add (from, start, 1);
+        started.add (std::max (from, start), current, 1);
       }
       else
-      {
-        while (from < now)
-        {
-          epoch = from.toEpoch ();
-          if (_bars.find (epoch) != _bars.end ())
-            ++_bars[epoch]._pending;
-          from = increment (from, _period);
-        }
-      }
+        pending.add (from, current, 1);
     }
 
     // e--C   e--s--C
@@ -323,35 +316,19 @@ void Chart::scan (std::vector <Task>& tasks)
     else if (status == Task::completed)
     {
       // Truncate history so it starts at 'earliest' for completed tasks.
-      ISO8601d end = quantize (ISO8601d (task.get_date ("end")), _period);
-      epoch = end.toEpoch ();
-
-      if (_bars.find (epoch) != _bars.end ())
-        ++_bars[epoch]._removed;
+      int end = Histogram::period (task.get_date ("end"), _period);
+      removed.add (end);
 
       // Maintain a running total of 'done' tasks that are off the left of the
       // chart.
-      if (end < _earliest)
+      if (end < first)
       {
         ++_carryover_done;
         continue;
       }
 
-      while (from < end)
-      {
-        epoch = from.toEpoch ();
-        if (_bars.find (epoch) != _bars.end ())
-          ++_bars[epoch]._pending;
-        from = increment (from, _period);
-      }
-
-      while (from < now)
-      {
-        epoch = from.toEpoch ();
-        if (_bars.find (epoch) != _bars.end ())
-          ++_bars[epoch]._done;
-        from = increment (from, _period);
-      }
+      pending.add (from, end, 1);
+      done.add (std::max (from, end), current, 1);
     }
 
     // e--D   e--s--D
@@ -359,24 +336,34 @@ void Chart::scan (std::vector <Task>& tasks)
     else if (status == Task::deleted)
     {
       // Skip old deleted tasks.
-      ISO8601d end = quantize (ISO8601d (task.get_date ("end")), _period);
-      epoch = end.toEpoch ();
-      if (_bars.find (epoch) != _bars.end ())
-        ++_bars[epoch]._removed;
+      int end = Histogram::period (task.get_date ("end"), _period);
+      removed.add (end);
 
-      if (end < _earliest)
+      if (end < first)
         continue;
 
-      while (from < end)
-      {
-        epoch = from.toEpoch ();
-        if (_bars.find (epoch) != _bars.end ())
-          ++_bars[epoch]._pending;
-        from = increment (from, _period);
-      }
+      pending.add (from, end, 1);
     }
   }
 
+  added.resolve ();
+  removed.resolve ();
+  pending.resolve ();
+  started.resolve ();
+  done.resolve ();
+
+  // The bars are epoch-ordered, so they correspond to consecutive periods.
+  int period = first;
+  for (auto& bar : _bars)
+  {
+    bar.second._added   = added[period];
+    bar.second._removed = removed[period];
+    bar.second._pending = pending[period];
+    bar.second._started = started[period];
+    bar.second._done    = done[period];
+    ++period;
+  }
+
   // Size the data.
   maxima ();
 }
@@ -589,69 +576,6 @@ void Chart::optimizeGrid ()
   }
 }
 
-////////////////////////////////////////////////////////////////////////////////
-ISO8601d Chart::quantize (const ISO8601d& input, char period)
-{
-  if (period == 'D') return input.startOfDay ();
-  if (period == 'W') return input.startOfWeek ();
-  if (period == 'M') return input.startOfMonth ();
-
-  return input;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-ISO8601d Chart::increment (const ISO8601d& input, char period)
-{
-  // Move to the next period.
-  int d = input.day ();
-  int m = input.month ();
-  int y = input.year ();
-
-  int days;
-
-  switch (period)
-  {
-  case 'D':
-    if (++d > ISO8601d::daysInMonth (m, y))
-    {
-      d = 1;
-
-      if (++m == 13)
-      {
-        m = 1;
-        ++y;
-      }
-    }
-    break;
-
-  case 'W':
-    d += 7;
-    days = ISO8601d::daysInMonth (m, y);
-    if (d > days)
-    {
-      d -= days;
-
-      if (++m == 13)
-      {
-        m = 1;
-        ++y;
-      }
-    }
-    break;
-
-  case 'M':
-    d = 1;
-    if (++m == 13)
-    {
-      m = 1;
-      ++y;
-    }
-    break;
-  }
-
-  return ISO8601d (m, d, y, 0, 0, 0);
-}
-
 ////////////////////////////////////////////////////////////////////////////////
 ISO8601d Chart::decrement (const ISO8601d& input, char period)
 {
@@ -338,7 +338,7 @@ int CmdCalendar::execute (std::string& output)
     {
       // Assert that 'report' is a valid report.
       std::string report = context.config.get ("calendar.details.report");
-      if (context.commands.find (report) == context.commands.end ())
+      if (! context.commands.has (report))
         throw std::string (STRING_ERROR_DETAILS);
 
       // TODO Fix this:  cal      --> task
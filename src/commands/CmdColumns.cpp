@@ -62,9 +62,7 @@ int CmdColumns::execute (std::string& output)
     throw std::string (STRING_CMD_COLUMNS_ARGS);
 
   // Include all columns in the table.
-  std::vector <std::string> names;
-  for (auto& col : context.columns)
-    names.push_back (col.first);
+  std::vector <std::string> names = context.columns.names ();
 
   std::sort (names.begin (), names.end ());
 
@@ -146,9 +144,7 @@ CmdCompletionColumns::CmdCompletionColumns ()
 int CmdCompletionColumns::execute (std::string& output)
 {
   // Include all columns.
-  std::vector <std::string> names;
-  for (auto& col : context.columns)
-    names.push_back (col.first);
+  std::vector <std::string> names = context.columns.names ();
 
   std::sort (names.begin (), names.end ());
 
@@ -58,6 +58,7 @@ CmdCustom::CmdCustom (
   _accepts_modifications = false;
   _accepts_miscellaneous = false;
   _category              = Category::report;
+  _compiled              = false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -66,30 +67,13 @@ int CmdCustom::execute (std::string& output)
   int rc = 0;
 
   // Load report configuration.
-  std::string reportColumns = context.config.get ("report." + _keyword + ".columns");
-  std::string reportLabels  = context.config.get ("report." + _keyword + ".labels");
-  std::string reportSort    = context.config.get ("report." + _keyword + ".sort");
-  std::string reportFilter  = context.config.get ("report." + _keyword + ".filter");
-
-  std::vector <std::string> columns;
-  split (columns, reportColumns, ',');
-  validateReportColumns (columns);
-
-  std::vector <std::string> labels;
-  split (labels, reportLabels, ',');
-
-  if (columns.size () != labels.size () && labels.size () != 0)
-    throw format (STRING_CMD_CUSTOM_MISMATCH, _keyword);
-
-  std::vector <std::string> sortOrder;
-  split (sortOrder, reportSort, ',');
-  if (sortOrder.size () != 0 &&
-      sortOrder[0] != "none")
-    validateSortColumns (sortOrder);
+  const Report& report = compileReport ();
+  const std::vector <std::string>& columns = report._columnNames;
+  const std::vector <std::string>& labels  = report._labelNames;
+  std::vector <std::string> sortOrder      = report._sortOrder;
 
   // Add the report filter to any existing filter.
-  if (reportFilter != "")
-    context.cli2.addFilter (reportFilter);
+  context.cli2.addFilter (report._filterLexemes);
 
   // Apply filter.
   handleRecurrence ();
@@ -119,7 +103,7 @@ int CmdCustom::execute (std::string& output)
 
     // Sort the tasks.
     if (sortOrder.size ())
-      sort_tasks (filtered, sequence, reportSort);
+      sort_tasks (filtered, sequence, report._sort);
   }
 
   // Configure the view.
@@ -150,17 +134,12 @@ int CmdCustom::execute (std::string& output)
   std::vector <std::string> sortColumns;
 
   // Add the break columns, if any.
-  for (auto& so : sortOrder)
+  if (sortOrder.size ())
   {
-    std::string name;
-    bool ascending;
-    bool breakIndicator;
-    context.decomposeSortField (so, name, ascending, breakIndicator);
-
-    if (breakIndicator)
+    for (auto& name : report._breakColumns)
       view.addBreak (name);
 
-    sortColumns.push_back (name);
+    sortColumns = report._sortColumns;
   }
 
   // Add the columns and labels.
@@ -239,6 +218,153 @@ int CmdCustom::execute (std::string& output)
   return rc;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Splits and validates the report definition, unless that was already done
+// for the current values of report.<name>.columns/labels/sort/filter, either
+// by an earlier execution or, if the configuration image is kept, by an
+// earlier command.
+const CmdCustom::Report& CmdCustom::compileReport ()
+{
+  std::string reportColumns = context.config.get ("report." + _keyword + ".columns");
+  std::string reportLabels  = context.config.get ("report." + _keyword + ".labels");
+  std::string reportSort    = context.config.get ("report." + _keyword + ".sort");
+  std::string reportFilter  = context.config.get ("report." + _keyword + ".filter");
+
+  if (_compiled                         &&
+      _report._columns == reportColumns &&
+      _report._labels  == reportLabels  &&
+      _report._sort    == reportSort    &&
+      _report._filter  == reportFilter)
+    return _report;
+
+  // The image may hold a report compiled from other settings, since
+  // overridden.
+  Report report;
+  std::vector <std::string> packed;
+  if (context.config.getDerived ("report." + _keyword, packed) &&
+      report.unpack (packed)           &&
+      report._columns == reportColumns &&
+      report._labels  == reportLabels  &&
+      report._sort    == reportSort    &&
+      report._filter  == reportFilter)
+  {
+    _report = report;
+    _compiled = true;
+    return _report;
+  }
+
+  report = Report ();
+  report._columns = reportColumns;
+  report._labels  = reportLabels;
+  report._sort    = reportSort;
+  report._filter  = reportFilter;
+
+  split (report._columnNames, reportColumns, ',');
+  validateReportColumns (report._columnNames);
+
+  split (report._labelNames, reportLabels, ',');
+
+  if (report._columnNames.size () != report._labelNames.size () &&
+      report._labelNames.size () != 0)
+    throw format (STRING_CMD_CUSTOM_MISMATCH, _keyword);
+
+  split (report._sortOrder, reportSort, ',');
+  if (report._sortOrder.size () != 0 &&
+      report._sortOrder[0] != "none")
+  {
+    validateSortColumns (report._sortOrder);
+
+    for (auto& so : report._sortOrder)
+    {
+      std::string name;
+      bool ascending;
+      bool breakIndicator;
+      context.decomposeSortField (so, name, ascending, breakIndicator);
+
+      if (breakIndicator)
+        report._breakColumns.push_back (name);
+
+      report._sortColumns.push_back (name);
+    }
+  }
+
+  std::string lexeme;
+  Lexer::Type type;
+  Lexer lex (reportFilter);
+  while (lex.token (lexeme, type))
+    report._filterLexemes.push_back (lexeme);
+
+  _report = report;
+  _compiled = true;
+  context.config.setDerived ("report." + _keyword, _report.pack ());
+  return _report;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Each list is preceded by its length.
+static void packList (
+  std::vector <std::string>& packed,
+  const std::vector <std::string>& list)
+{
+  packed.push_back (format ((int) list.size ()));
+  packed.insert (packed.end (), list.begin (), list.end ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static bool unpackList (
+  const std::vector <std::string>& packed,
+  size_t& cursor,
+  std::vector <std::string>& list)
+{
+  if (cursor >= packed.size ())
+    return false;
+
+  const char* start = packed[cursor].c_str ();
+  char* end;
+  unsigned long length = strtoul (start, &end, 10);
+  if (end == start || *end != '\0' || length > packed.size () - cursor - 1)
+    return false;
+
+  list.assign (packed.begin () + cursor + 1, packed.begin () + cursor + 1 + length);
+  cursor += length + 1;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The settings a report was compiled from, then the compiled lists.
+std::vector <std::string> CmdCustom::Report::pack () const
+{
+  std::vector <std::string> packed {_columns, _labels, _sort, _filter};
+  packList (packed, _columnNames);
+  packList (packed, _labelNames);
+  packList (packed, _sortOrder);
+  packList (packed, _sortColumns);
+  packList (packed, _breakColumns);
+  packList (packed, _filterLexemes);
+  return packed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool CmdCustom::Report::unpack (const std::vector <std::string>& packed)
+{
+  if (packed.size () < 4)
+    return false;
+
+  _columns = packed[0];
+  _labels  = packed[1];
+  _sort    = packed[2];
+  _filter  = packed[3];
+
+  size_t cursor = 4;
+  return unpackList (packed, cursor, _columnNames)   &&
+         unpackList (packed, cursor, _labelNames)    &&
+         unpackList (packed, cursor, _sortOrder)     &&
+         unpackList (packed, cursor, _sortColumns)   &&
+         unpackList (packed, cursor, _breakColumns)  &&
+         unpackList (packed, cursor, _filterLexemes) &&
+         cursor == packed.size ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void CmdCustom::validateReportColumns (std::vector <std::string>& columns)
 {
@@ -28,6 +28,7 @@
 #define INCLUDED_CMDCUSTOM
 
 #include <string>
+#include <vector>
 #include <Command.h>
 
 class CmdCustom : public Command
@@ -37,8 +38,35 @@ public:
   int execute (std::string&);
 
 private:
+  // A report definition, split and validated from report.<name>.columns,
+  // labels, sort and filter, and reused for as long as those are unchanged.
+  class Report
+  {
+  public:
+    std::vector <std::string> pack () const;
+    bool unpack (const std::vector <std::string>&);
+
+  public:
+    std::string               _columns;
+    std::string               _labels;
+    std::string               _sort;
+    std::string               _filter;
+
+    std::vector <std::string> _columnNames;
+    std::vector <std::string> _labelNames;
+    std::vector <std::string> _sortOrder;
+    std::vector <std::string> _sortColumns;
+    std::vector <std::string> _breakColumns;
+    std::vector <std::string> _filterLexemes;
+  };
+
+  const Report& compileReport ();
   void validateReportColumns (std::vector <std::string>&);
   void validateSortColumns (std::vector <std::string>&);
+
+private:
+  Report _report;
+  bool   _compiled;
 };
 
 #endif
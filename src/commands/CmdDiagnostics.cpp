@@ -44,6 +44,10 @@
 #include <gnutls/gnutls.h>
 #endif
 
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+
 
 extern Context context;
 
@@ -183,6 +187,14 @@ int CmdDiagnostics::execute (std::string& output)
 #elif defined LIBGNUTLS_VERSION
       << LIBGNUTLS_VERSION
 #endif
+#else
+      << "n/a"
+#endif
+      << "\n";
+
+  out << "       zlib: "
+#ifdef HAVE_LIBZ
+      << ZLIB_VERSION
 #else
       << "n/a"
 #endif
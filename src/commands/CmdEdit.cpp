@@ -285,9 +285,9 @@ std::string CmdEdit::formatTask (Task task, const std::string& dateformat)
 
   // UDAs
   std::vector <std::string> udas;
-  for (auto& col : context.columns)
-    if (context.config.get ("uda." + col.first + ".type") != "")
-      udas.push_back (col.first);
+  for (auto& name : context.columns.names ())
+    if (context.config.get ("uda." + name + ".type") != "")
+      udas.push_back (name);
 
   if (udas.size ())
   {
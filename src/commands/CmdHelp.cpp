@@ -67,9 +67,7 @@ int CmdHelp::execute (std::string& output)
   view.set (row, 2, STRING_CMD_HELP_USAGE_DESC);
 
   // Obsolete method of getting a list of all commands.
-  std::vector <std::string> all;
-  for (auto& cmd : context.commands)
-    all.push_back (cmd.first);
+  std::vector <std::string> all = context.commands.names ();
 
   // Sort alphabetically by usage.
   std::sort (all.begin (), all.end ());
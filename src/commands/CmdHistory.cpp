@@ -27,8 +27,11 @@
 #include <cmake.h>
 #include <CmdHistory.h>
 #include <sstream>
+#include <limits>
+#include <algorithm>
 #include <Context.h>
 #include <Filter.h>
+#include <Histogram.h>
 #include <ViewText.h>
 #include <main.h>
 #include <text.h>
@@ -37,6 +40,90 @@
 
 extern Context context;
 
+////////////////////////////////////////////////////////////////////////////////
+// Added, completed and deleted task counts for each month or year that has
+// any data.  Periods are numbered densely (see Histogram), so each task costs
+// a couple of localtime calls instead of ISO8601d quantization and map
+// lookups.
+class History
+{
+public:
+  History (char, std::vector <Task>&);
+
+public:
+  std::vector <int> _periods;    // Periods with data, in order
+  Histogram _added;              // Additions by period
+  Histogram _completed;          // Completions by period
+  Histogram _deleted;            // Deletions by period
+};
+
+////////////////////////////////////////////////////////////////////////////////
+History::History (char period, std::vector <Task>& tasks)
+{
+  struct Dates
+  {
+    Task::status status;
+    int entry;
+    int end;
+  };
+
+  // Number the periods first, to size the histograms.
+  std::vector <Dates> dates;
+  dates.reserve (tasks.size ());
+  int first = std::numeric_limits <int>::max ();
+  int last  = std::numeric_limits <int>::min ();
+  time_t now = time (NULL);
+  for (auto& task : tasks)
+  {
+    Dates d;
+    d.status = task.getStatus ();
+    d.entry = d.end = Histogram::period (task.get_date ("entry"), period);
+
+    // All deleted and completed tasks have an end date.
+    if (d.status == Task::deleted ||
+        d.status == Task::completed)
+      d.end = Histogram::period (task.has ("end") ? task.get_date ("end") : now, period);
+
+    first = std::min (first, std::min (d.entry, d.end));
+    last  = std::max (last,  std::max (d.entry, d.end));
+    dates.push_back (d);
+  }
+
+  Histogram groups (period, first, last);
+  _added.reset     (period, first, last);
+  _completed.reset (period, first, last);
+  _deleted.reset   (period, first, last);
+
+  for (auto& d : dates)
+  {
+    groups.add (d.entry);
+
+    // Every task has an entry date, but exclude templates.
+    if (d.status != Task::recurring)
+      _added.add (d.entry);
+
+    if (d.status == Task::deleted)
+    {
+      groups.add (d.end);
+      _deleted.add (d.end);
+    }
+    else if (d.status == Task::completed)
+    {
+      groups.add (d.end);
+      _completed.add (d.end);
+    }
+  }
+
+  groups.resolve ();
+  _added.resolve ();
+  _completed.resolve ();
+  _deleted.resolve ();
+
+  for (int p = first; p <= last; ++p)
+    if (groups[p])
+      _periods.push_back (p);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 CmdHistoryMonthly::CmdHistoryMonthly ()
 {
@@ -58,48 +145,13 @@ int CmdHistoryMonthly::execute (std::string& output)
 {
   int rc = 0;
 
-  std::map <time_t, int> groups;          // Represents any month with data
-  std::map <time_t, int> addedGroup;      // Additions by month
-  std::map <time_t, int> completedGroup;  // Completions by month
-  std::map <time_t, int> deletedGroup;    // Deletions by month
-
   // Apply filter.
   handleRecurrence ();
   Filter filter;
   std::vector <Task> filtered;
   filter.subset (filtered);
 
-  for (auto& task : filtered)
-  {
-    ISO8601d entry (task.get_date ("entry"));
-
-    ISO8601d end;
-    if (task.has ("end"))
-      end = ISO8601d (task.get_date ("end"));
-
-    time_t epoch = entry.startOfMonth ().toEpoch ();
-    groups[epoch] = 0;
-
-    // Every task has an entry date, but exclude templates.
-    if (task.getStatus () != Task::recurring)
-      ++addedGroup[epoch];
-
-    // All deleted tasks have an end date.
-    if (task.getStatus () == Task::deleted)
-    {
-      epoch = end.startOfMonth ().toEpoch ();
-      groups[epoch] = 0;
-      ++deletedGroup[epoch];
-    }
-
-    // All completed tasks have an end date.
-    else if (task.getStatus () == Task::completed)
-    {
-      epoch = end.startOfMonth ().toEpoch ();
-      groups[epoch] = 0;
-      ++completedGroup[epoch];
-    }
-  }
+  History history ('M', filtered);
 
   // Now build the view.
   ViewText view;
@@ -123,15 +175,15 @@ int CmdHistoryMonthly::execute (std::string& output)
 
   int priorYear = 0;
   int row = 0;
-  for (auto& i : groups)
+  for (auto& period : history._periods)
   {
     row = view.addRow ();
 
-    totalAdded     += addedGroup     [i.first];
-    totalCompleted += completedGroup [i.first];
-    totalDeleted   += deletedGroup   [i.first];
+    totalAdded     += history._added[period];
+    totalCompleted += history._completed[period];
+    totalDeleted   += history._deleted[period];
 
-    ISO8601d dt (i.first);
+    ISO8601d dt (Histogram::epoch (period, 'M'));
     int m, d, y;
     dt.toMDY (m, d, y);
 
@@ -144,23 +196,14 @@ int CmdHistoryMonthly::execute (std::string& output)
 
     int net = 0;
 
-    if (addedGroup.find (i.first) != addedGroup.end ())
-    {
-      view.set (row, 2, addedGroup[i.first]);
-      net +=addedGroup[i.first];
-    }
+    view.set (row, 2, history._added[period]);
+    net += history._added[period];
 
-    if (completedGroup.find (i.first) != completedGroup.end ())
-    {
-      view.set (row, 3, completedGroup[i.first]);
-      net -= completedGroup[i.first];
-    }
+    view.set (row, 3, history._completed[period]);
+    net -= history._completed[period];
 
-    if (deletedGroup.find (i.first) != deletedGroup.end ())
-    {
-      view.set (row, 4, deletedGroup[i.first]);
-      net -= deletedGroup[i.first];
-    }
+    view.set (row, 4, history._deleted[period]);
+    net -= history._deleted[period];
 
     Color net_color;
     if (context.color () && net)
@@ -223,10 +266,6 @@ CmdHistoryAnnual::CmdHistoryAnnual ()
 int CmdHistoryAnnual::execute (std::string& output)
 {
   int rc = 0;
-  std::map <time_t, int> groups;          // Represents any month with data
-  std::map <time_t, int> addedGroup;      // Additions by month
-  std::map <time_t, int> completedGroup;  // Completions by month
-  std::map <time_t, int> deletedGroup;    // Deletions by month
 
   // Apply filter.
   handleRecurrence ();
@@ -234,37 +273,7 @@ int CmdHistoryAnnual::execute (std::string& output)
   std::vector <Task> filtered;
   filter.subset (filtered);
 
-  for (auto& task : filtered)
-  {
-    ISO8601d entry (task.get_date ("entry"));
-
-    ISO8601d end;
-    if (task.has ("end"))
-      end = ISO8601d (task.get_date ("end"));
-
-    time_t epoch = entry.startOfYear ().toEpoch ();
-    groups[epoch] = 0;
-
-    // Every task has an entry date, but exclude templates.
-    if (task.getStatus () != Task::recurring)
-      ++addedGroup[epoch];
-
-    // All deleted tasks have an end date.
-    if (task.getStatus () == Task::deleted)
-    {
-      epoch = end.startOfYear ().toEpoch ();
-      groups[epoch] = 0;
-      ++deletedGroup[epoch];
-    }
-
-    // All completed tasks have an end date.
-    else if (task.getStatus () == Task::completed)
-    {
-      epoch = end.startOfYear ().toEpoch ();
-      groups[epoch] = 0;
-      ++completedGroup[epoch];
-    }
-  }
+  History history ('Y', filtered);
 
   // Now build the view.
   ViewText view;
@@ -287,15 +296,15 @@ int CmdHistoryAnnual::execute (std::string& output)
 
   int priorYear = 0;
   int row = 0;
-  for (auto& i : groups)
+  for (auto& period : history._periods)
   {
     row = view.addRow ();
 
-    totalAdded     += addedGroup     [i.first];
-    totalCompleted += completedGroup [i.first];
-    totalDeleted   += deletedGroup   [i.first];
+    totalAdded     += history._added[period];
+    totalCompleted += history._completed[period];
+    totalDeleted   += history._deleted[period];
 
-    ISO8601d dt (i.first);
+    ISO8601d dt (Histogram::epoch (period, 'Y'));
     int m, d, y;
     dt.toMDY (m, d, y);
 
@@ -307,23 +316,14 @@ int CmdHistoryAnnual::execute (std::string& output)
 
     int net = 0;
 
-    if (addedGroup.find (i.first) != addedGroup.end ())
-    {
-      view.set (row, 1, addedGroup[i.first]);
-      net +=addedGroup[i.first];
-    }
+    view.set (row, 1, history._added[period]);
+    net += history._added[period];
 
-    if (completedGroup.find (i.first) != completedGroup.end ())
-    {
-      view.set (row, 2, completedGroup[i.first]);
-      net -= completedGroup[i.first];
-    }
+    view.set (row, 2, history._completed[period]);
+    net -= history._completed[period];
 
-    if (deletedGroup.find (i.first) != deletedGroup.end ())
-    {
-      view.set (row, 3, deletedGroup[i.first]);
-      net -= deletedGroup[i.first];
-    }
+    view.set (row, 3, history._deleted[period]);
+    net -= history._deleted[period];
 
     Color net_color;
     if (context.color () && net)
@@ -385,10 +385,6 @@ CmdGHistoryMonthly::CmdGHistoryMonthly ()
 int CmdGHistoryMonthly::execute (std::string& output)
 {
   int rc = 0;
-  std::map <time_t, int> groups;          // Represents any month with data
-  std::map <time_t, int> addedGroup;      // Additions by month
-  std::map <time_t, int> completedGroup;  // Completions by month
-  std::map <time_t, int> deletedGroup;    // Deletions by month
 
   // Apply filter.
   handleRecurrence ();
@@ -396,37 +392,7 @@ int CmdGHistoryMonthly::execute (std::string& output)
   std::vector <Task> filtered;
   filter.subset (filtered);
 
-  for (auto& task : filtered)
-  {
-    ISO8601d entry (task.get_date ("entry"));
-
-    ISO8601d end;
-    if (task.has ("end"))
-      end = ISO8601d (task.get_date ("end"));
-
-    time_t epoch = entry.startOfMonth ().toEpoch ();
-    groups[epoch] = 0;
-
-    // Every task has an entry date, but exclude templates.
-    if (task.getStatus () != Task::recurring)
-      ++addedGroup[epoch];
-
-    // All deleted tasks have an end date.
-    if (task.getStatus () == Task::deleted)
-    {
-      epoch = end.startOfMonth ().toEpoch ();
-      groups[epoch] = 0;
-      ++deletedGroup[epoch];
-    }
-
-    // All completed tasks have an end date.
-    else if (task.getStatus () == Task::completed)
-    {
-      epoch = end.startOfMonth ().toEpoch ();
-      groups[epoch] = 0;
-      ++completedGroup[epoch];
-    }
-  }
+  History history ('M', filtered);
 
   int widthOfBar = context.getWidth () - 15;   // 15 == strlen ("2008 September ")
 
@@ -447,13 +413,13 @@ int CmdGHistoryMonthly::execute (std::string& output)
   // Determine the longest line, and the longest "added" line.
   int maxAddedLine = 0;
   int maxRemovedLine = 0;
-  for (auto& i : groups)
+  for (auto& period : history._periods)
   {
-    if (completedGroup[i.first] + deletedGroup[i.first] > maxRemovedLine)
-      maxRemovedLine = completedGroup[i.first] + deletedGroup[i.first];
+    if (history._completed[period] + history._deleted[period] > maxRemovedLine)
+      maxRemovedLine = history._completed[period] + history._deleted[period];
 
-    if (addedGroup[i.first] > maxAddedLine)
-      maxAddedLine = addedGroup[i.first];
+    if (history._added[period] > maxAddedLine)
+      maxAddedLine = history._added[period];
   }
 
   int maxLine = maxAddedLine + maxRemovedLine;
@@ -467,15 +433,15 @@ int CmdGHistoryMonthly::execute (std::string& output)
 
     int priorYear = 0;
     int row = 0;
-    for (auto& i : groups)
+    for (auto& period : history._periods)
     {
       row = view.addRow ();
 
-      totalAdded     += addedGroup[i.first];
-      totalCompleted += completedGroup[i.first];
-      totalDeleted   += deletedGroup[i.first];
+      totalAdded     += history._added[period];
+      totalCompleted += history._completed[period];
+      totalDeleted   += history._deleted[period];
 
-      ISO8601d dt (i.first);
+      ISO8601d dt (Histogram::epoch (period, 'M'));
       int m, d, y;
       dt.toMDY (m, d, y);
 
@@ -486,33 +452,33 @@ int CmdGHistoryMonthly::execute (std::string& output)
       }
       view.set (row, 1, ISO8601d::monthName(m));
 
-      unsigned int addedBar     = (widthOfBar *     addedGroup[i.first]) / maxLine;
-      unsigned int completedBar = (widthOfBar * completedGroup[i.first]) / maxLine;
-      unsigned int deletedBar   = (widthOfBar *   deletedGroup[i.first]) / maxLine;
+      unsigned int addedBar     = (widthOfBar *     history._added[period]) / maxLine;
+      unsigned int completedBar = (widthOfBar * history._completed[period]) / maxLine;
+      unsigned int deletedBar   = (widthOfBar *   history._deleted[period]) / maxLine;
 
       std::string bar = "";
       if (context.color ())
       {
         std::string aBar = "";
-        if (addedGroup[i.first])
+        if (history._added[period])
         {
-          aBar = format (addedGroup[i.first]);
+          aBar = format (history._added[period]);
           while (aBar.length () < addedBar)
             aBar = " " + aBar;
         }
 
         std::string cBar = "";
-        if (completedGroup[i.first])
+        if (history._completed[period])
         {
-          cBar = format (completedGroup[i.first]);
+          cBar = format (history._completed[period]);
           while (cBar.length () < completedBar)
             cBar = " " + cBar;
         }
 
         std::string dBar = "";
-        if (deletedGroup[i.first])
+        if (history._deleted[period])
         {
-          dBar = format (deletedGroup[i.first]);
+          dBar = format (history._deleted[period]);
           while (dBar.length () < deletedBar)
             dBar = " " + dBar;
         }
@@ -585,10 +551,6 @@ CmdGHistoryAnnual::CmdGHistoryAnnual ()
 int CmdGHistoryAnnual::execute (std::string& output)
 {
   int rc = 0;
-  std::map <time_t, int> groups;          // Represents any month with data
-  std::map <time_t, int> addedGroup;      // Additions by month
-  std::map <time_t, int> completedGroup;  // Completions by month
-  std::map <time_t, int> deletedGroup;    // Deletions by month
 
   // Apply filter.
   handleRecurrence ();
@@ -596,37 +558,7 @@ int CmdGHistoryAnnual::execute (std::string& output)
   std::vector <Task> filtered;
   filter.subset (filtered);
 
-  for (auto& task : filtered)
-  {
-    ISO8601d entry (task.get_date ("entry"));
-
-    ISO8601d end;
-    if (task.has ("end"))
-      end = ISO8601d (task.get_date ("end"));
-
-    time_t epoch = entry.startOfYear ().toEpoch ();
-    groups[epoch] = 0;
-
-    // Every task has an entry date, but exclude templates.
-    if (task.getStatus () != Task::recurring)
-      ++addedGroup[epoch];
-
-    // All deleted tasks have an end date.
-    if (task.getStatus () == Task::deleted)
-    {
-      epoch = end.startOfYear ().toEpoch ();
-      groups[epoch] = 0;
-      ++deletedGroup[epoch];
-    }
-
-    // All completed tasks have an end date.
-    else if (task.getStatus () == Task::completed)
-    {
-      epoch = end.startOfYear ().toEpoch ();
-      groups[epoch] = 0;
-      ++completedGroup[epoch];
-    }
-  }
+  History history ('Y', filtered);
 
   int widthOfBar = context.getWidth () - 5;   // 5 == strlen ("YYYY ")
 
@@ -646,13 +578,13 @@ int CmdGHistoryAnnual::execute (std::string& output)
   // Determine the longest line, and the longest "added" line.
   int maxAddedLine = 0;
   int maxRemovedLine = 0;
-  for (auto& i : groups)
+  for (auto& period : history._periods)
   {
-    if (completedGroup[i.first] + deletedGroup[i.first] > maxRemovedLine)
-      maxRemovedLine = completedGroup[i.first] + deletedGroup[i.first];
+    if (history._completed[period] + history._deleted[period] > maxRemovedLine)
+      maxRemovedLine = history._completed[period] + history._deleted[period];
 
-    if (addedGroup[i.first] > maxAddedLine)
-      maxAddedLine = addedGroup[i.first];
+    if (history._added[period] > maxAddedLine)
+      maxAddedLine = history._added[period];
   }
 
   int maxLine = maxAddedLine + maxRemovedLine;
@@ -666,15 +598,15 @@ int CmdGHistoryAnnual::execute (std::string& output)
 
     int priorYear = 0;
     int row = 0;
-    for (auto& i : groups)
+    for (auto& period : history._periods)
     {
       row = view.addRow ();
 
-      totalAdded     += addedGroup[i.first];
-      totalCompleted += completedGroup[i.first];
-      totalDeleted   += deletedGroup[i.first];
+      totalAdded     += history._added[period];
+      totalCompleted += history._completed[period];
+      totalDeleted   += history._deleted[period];
 
-      ISO8601d dt (i.first);
+      ISO8601d dt (Histogram::epoch (period, 'Y'));
       int m, d, y;
       dt.toMDY (m, d, y);
 
@@ -684,33 +616,33 @@ int CmdGHistoryAnnual::execute (std::string& output)
         priorYear = y;
       }
 
-      unsigned int addedBar     = (widthOfBar *     addedGroup[i.first]) / maxLine;
-      unsigned int completedBar = (widthOfBar * completedGroup[i.first]) / maxLine;
-      unsigned int deletedBar   = (widthOfBar *   deletedGroup[i.first]) / maxLine;
+      unsigned int addedBar     = (widthOfBar *     history._added[period]) / maxLine;
+      unsigned int completedBar = (widthOfBar * history._completed[period]) / maxLine;
+      unsigned int deletedBar   = (widthOfBar *   history._deleted[period]) / maxLine;
 
       std::string bar = "";
       if (context.color ())
       {
         std::string aBar = "";
-        if (addedGroup[i.first])
+        if (history._added[period])
         {
-          aBar = format (addedGroup[i.first]);
+          aBar = format (history._added[period]);
           while (aBar.length () < addedBar)
             aBar = " " + aBar;
         }
 
         std::string cBar = "";
-        if (completedGroup[i.first])
+        if (history._completed[period])
         {
-          cBar = format (completedGroup[i.first]);
+          cBar = format (history._completed[period]);
           while (cBar.length () < completedBar)
             cBar = " " + cBar;
         }
 
         std::string dBar = "";
-        if (deletedGroup[i.first])
+        if (history._deleted[period])
         {
-          dBar = format (deletedGroup[i.first]);
+          dBar = format (history._deleted[period]);
           while (dBar.length () < deletedBar)
             dBar = " " + dBar;
         }
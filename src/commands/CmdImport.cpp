@@ -60,6 +60,9 @@ int CmdImport::execute (std::string&)
   int rc = 0;
   int count = 0;
 
+  // Every imported task is looked up by UUID.
+  context.tdb2.index ();
+
   // Get filenames from command line arguments.
   std::vector <std::string> words = context.cli2.getWords ();
   if (! words.size () || (words.size () == 1 && words[0] == "-"))
@@ -362,7 +362,7 @@ int CmdInfo::execute (std::string& output)
     std::string type;
     for (auto& att: all)
     {
-      if (context.columns.find (att) != context.columns.end ())
+      if (context.columns.has (att))
       {
         Column* col = context.columns[att];
         if (col->is_uda ())
@@ -396,7 +396,7 @@ int CmdInfo::execute (std::string& output)
     for (auto& att : all)
     {
       if (att.substr (0, 11) != "annotation_" &&
-          context.columns.find (att) == context.columns.end ())
+          ! context.columns.has (att))
       {
          row = view.addRow ();
          view.set (row, 0, "[" + att);
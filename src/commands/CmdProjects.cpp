@@ -30,6 +30,7 @@
 #include <sstream>
 #include <Context.h>
 #include <Filter.h>
+#include <Aggregate.h>
 #include <ViewText.h>
 #include <text.h>
 #include <util.h>
@@ -75,33 +76,26 @@ int CmdProjects::execute (std::string& output)
 
   std::stringstream out;
 
-  // Scan all the tasks for their project name, building a map using project
-  // names as keys.
-  std::map <std::string, int> unique;
-  bool no_project = false;
-  std::string project;
-  for (auto& task : filtered)
-  {
-    if (task.getStatus () == Task::deleted)
-    {
-      --quantity;
-      continue;
-    }
-
-    // Increase the count for the project the task belongs to and all
-    // its super-projects
-    project = task.get ("project");
+  // Count the tasks in each project, and in all its super-projects, ignoring
+  // deleted tasks.
+  Aggregate aggregate (Aggregate::project);
+  aggregate.add (filtered);
 
-    std::vector <std::string> projects = extractParents (project);
-    projects.push_back (project);
+  // Each task has exactly one project, so this counts each deleted task once.
+  for (auto& group : aggregate.groups ())
+    quantity -= group.second._deleted;
 
-    for (auto& parent : projects)
-      unique[parent] += 1;
+  aggregate.rollUpProjects ();
 
-    if (project == "")
-      no_project = true;
+  std::map <std::string, int> unique;
+  for (auto& group : aggregate.groups ())
+  {
+    int count = group.second._count - group.second._deleted;
+    if (count)
+      unique[group.first] = count;
   }
 
+  bool no_project = unique.find ("") != unique.end ();
   if (unique.size ())
   {
     // Render a list of project names from the map.
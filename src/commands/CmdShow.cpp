@@ -77,6 +77,7 @@ int CmdShow::execute (std::string& output)
     " active.indicator"
     " allow.empty.filter"
     " avoidlastcolumn"
+    " backlog.compact"
     " bulk"
     " calendar.details"
     " calendar.details.report"
@@ -127,6 +128,7 @@ int CmdShow::execute (std::string& output)
     " color.until"
     " column.padding"
     " complete.all.tags"
+    " config.cache"
     " confirmation"
     " context"
     " data.location"
@@ -158,6 +160,7 @@ int CmdShow::execute (std::string& output)
     " fontunderline"
     " gc"
     " hooks"
+    " hooks.parallel"
     " hyphenate"
     " indent.annotation"
     " indent.report"
@@ -174,6 +177,8 @@ int CmdShow::execute (std::string& output)
     " nag"
     " obfuscate"
     " print.empty.columns"
+    " profile"
+    " profile.file"
     " recurrence"
     " recurrence.confirmation"
     " recurrence.indicator"
@@ -191,6 +196,9 @@ int CmdShow::execute (std::string& output)
     " taskd.ca"
     " taskd.certificate"
     " taskd.ciphers"
+    " taskd.compression"
+    " taskd.compression.upload"
+    " taskd.compression.limit"
     " taskd.credentials"
     " taskd.key"
     " taskd.trust"
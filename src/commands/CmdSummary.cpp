@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <Context.h>
 #include <Filter.h>
+#include <Aggregate.h>
 #include <ViewText.h>
 #include <ISO8601.h>
 #include <text.h>
@@ -71,64 +72,39 @@ int CmdSummary::execute (std::string& output)
   std::vector <Task> filtered;
   filter.subset (filtered);
 
-  // Generate unique list of project names from all pending tasks.
-  std::map <std::string, bool> allProjects;
-  for (auto& task : filtered)
-    if (showAllProjects || task.getStatus () == Task::pending)
-      allProjects[task.get ("project")] = false;
-
-  // Initialize counts, sum.
-  std::map <std::string, int> countPending;
-  std::map <std::string, int> countCompleted;
-  std::map <std::string, double> sumEntry;
-  std::map <std::string, int> counter;
+  // Accumulate counts and ages by project, in one pass.
   time_t now = time (NULL);
-
-  // Initialize counters.
-  for (auto& project : allProjects)
-  {
-    countPending   [project.first] = 0;
-    countCompleted [project.first] = 0;
-    sumEntry       [project.first] = 0.0;
-    counter        [project.first] = 0;
-  }
-
-  // Count the various tasks.
-  for (auto& task : filtered)
+  Aggregate aggregate (Aggregate::project, [now] (const Task& task, double& age)
   {
-    std::string project = task.get ("project");
-    std::vector <std::string> projects = extractParents (project);
-    projects.push_back (project);
-
-    for (auto& parent : projects)
-      ++counter[parent];
-
-    if (task.getStatus () == Task::pending ||
-        task.getStatus () == Task::waiting)
+    Task::status status = task.getStatus ();
+    time_t entry = strtol (task.get ("entry").c_str (), NULL, 10);
+    if (status == Task::pending ||
+        status == Task::waiting)
     {
-      for (auto& parent : projects)
-      {
-        ++countPending[parent];
-
-        time_t entry = strtol (task.get ("entry").c_str (), NULL, 10);
-        if (entry)
-          sumEntry[parent] = sumEntry[parent] + (double) (now - entry);
-      }
+      age = (double) (now - entry);
+      return entry != 0;
     }
 
-    else if (task.getStatus () == Task::completed)
+    if (status == Task::completed)
     {
-      for (auto& parent : projects)
-      {
-        ++countCompleted[parent];
-
-        time_t entry = strtol (task.get ("entry").c_str (), NULL, 10);
-        time_t end   = strtol (task.get ("end").c_str (), NULL, 10);
-        if (entry && end)
-          sumEntry[parent] = sumEntry[parent] + (double) (end - entry);
-      }
+      time_t end = strtol (task.get ("end").c_str (), NULL, 10);
+      age = (double) (end - entry);
+      return entry && end;
     }
-  }
+
+    return false;
+  });
+  aggregate.add (filtered);
+
+  // Generate unique list of project names from all pending tasks.
+  std::vector <std::string> allProjects;
+  for (auto& group : aggregate.groups ())
+    if (showAllProjects || group.second._pending)
+      allProjects.push_back (group.first);
+
+  // Parent projects include the tasks of their sub-projects.
+  aggregate.rollUpProjects ();
+  auto totals = aggregate.groups ();
 
   // Create a table for output.
   ViewText view;
@@ -152,11 +128,13 @@ int CmdSummary::execute (std::string& output)
 
   int barWidth = 30;
   std::vector <std::string> processed;
-  for (auto& i : allProjects)
+  for (auto& project : allProjects)
   {
-    if (showAllProjects || countPending[i.first] > 0)
+    const Aggregate::Totals& total = totals[project];
+    int p = total._pending + total._waiting;
+    if (showAllProjects || p > 0)
     {
-      const std::vector <std::string> parents = extractParents (i.first);
+      const std::vector <std::string> parents = extractParents (project);
       for (auto& parent : parents)
       {
         if (std::find (processed.begin (), processed.end (), parent)
@@ -169,16 +147,15 @@ int CmdSummary::execute (std::string& output)
       }
 
       int row = view.addRow ();
-      view.set (row, 0, (i.first == ""
+      view.set (row, 0, (project == ""
                           ? STRING_CMD_SUMMARY_NONE
-                          : indentProject (i.first, "  ", '.')));
+                          : indentProject (project, "  ", '.')));
 
-      view.set (row, 1, countPending[i.first]);
-      if (counter[i.first])
-        view.set (row, 2, ISO8601p ((int) (sumEntry[i.first] / (double)counter[i.first])).formatVague ());
+      view.set (row, 1, p);
+      if (total._count)
+        view.set (row, 2, ISO8601p ((int) (total._sum / (double) total._count)).formatVague ());
 
-      int c = countCompleted[i.first];
-      int p = countPending[i.first];
+      int c = total._completed;
       int completedBar = 0;
       if (c + p)
         completedBar = (c * barWidth) / (c + p);
@@ -201,7 +178,7 @@ int CmdSummary::execute (std::string& output)
       if (c + p)
         sprintf (percent, "%d%%", 100 * c / (c + p));
       view.set (row, 3, percent);
-      processed.push_back (i.first);
+      processed.push_back (project);
     }
   }
 
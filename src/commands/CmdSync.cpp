@@ -29,6 +29,8 @@
 #include <sstream>
 #include <inttypes.h>
 #include <signal.h>
+#include <thread>
+#include <JSON.h>
 #include <Context.h>
 #include <Filter.h>
 #include <Color.h>
@@ -38,6 +40,77 @@
 
 extern Context context;
 
+#ifdef HAVE_LIBGNUTLS
+// Below this many tasks, threads cost more than they save.
+static const size_t parallelMinimum = 2000;
+
+////////////////////////////////////////////////////////////////////////////////
+// The JSON of a large sync response is parsed in parallel.  Converting the JSON
+// to tasks may consult the task database, so it remains serial.  Any line that
+// fails is finally parsed by Task itself, which reports the error.
+static std::vector <Task> parseTasks (const std::vector <std::string>& lines)
+{
+  std::vector <json::value*> roots (lines.size (), nullptr);
+  auto parse = [&lines, &roots] (size_t from, size_t to)
+  {
+    for (auto i = from; i < to; ++i)
+    {
+      try
+      {
+        roots[i] = json::parse (lines[i]);
+      }
+      catch (const std::string&)
+      {
+      }
+    }
+  };
+
+  unsigned int threads = std::thread::hardware_concurrency ();
+  if (lines.size () < parallelMinimum || threads < 2)
+  {
+    parse (0, lines.size ());
+  }
+  else
+  {
+    size_t chunk = (lines.size () + threads - 1) / threads;
+    std::vector <std::thread> workers;
+    for (unsigned int i = 0; i < threads; ++i)
+      workers.push_back (std::thread (parse,
+                                      std::min (lines.size (), i * chunk),
+                                      std::min (lines.size (), (i + 1) * chunk)));
+
+    for (auto& worker : workers)
+      worker.join ();
+  }
+
+  std::vector <Task> tasks (lines.size ());
+  std::vector <bool> failed (lines.size (), false);
+  for (size_t i = 0; i < lines.size (); ++i)
+  {
+    try
+    {
+      if (roots[i] && roots[i]->type () == json::j_object)
+        tasks[i] = Task ((json::object*) roots[i]);
+      else
+        failed[i] = true;
+    }
+    catch (const std::string&)
+    {
+      failed[i] = true;
+    }
+
+    delete roots[i];
+    roots[i] = nullptr;
+  }
+
+  for (size_t i = 0; i < lines.size (); ++i)
+    if (failed[i])
+      tasks[i] = Task (lines[i]);
+
+  return tasks;
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 CmdSync::CmdSync ()
 {
@@ -138,19 +211,29 @@ int CmdSync::execute (std::string& output)
     auto all_tasks = context.tdb2.all_tasks ();
     for (auto& i : all_tasks)
     {
-      payload += i.composeJSON () + "\n";
+      payload += i.composeJSON ();
+      payload += '\n';
       ++upload_count;
     }
   }
   else
   {
-    std::vector <std::string> lines = context.tdb2.backlog.get_lines ();
+    // Superseded versions of a task need not be sent.
+    context.tdb2.compact_backlog ();
+
+    const std::vector <std::string>& lines = context.tdb2.backlog.get_lines ();
+    size_t size = 0;
+    for (auto& i : lines)
+      size += i.length () + 1;
+
+    payload.reserve (size);
     for (auto& i : lines)
     {
       if (i[0] == '{')
         ++upload_count;
 
-      payload += i + "\n";
+      payload += i;
+      payload += '\n';
     }
   }
 
@@ -167,6 +250,18 @@ int CmdSync::execute (std::string& output)
   if (first_time_init)
     request.set ("subtype", "init");
 
+  // Ask for a compressed response, which the server is free to ignore.  The
+  // upload can only be compressed when configured, because the client cannot
+  // learn what the server accepts before sending.
+  if (Msg::supports ("zlib") &&
+      context.config.getBoolean ("taskd.compression"))
+  {
+    request.set ("accept-compression", "zlib");
+
+    if (context.config.getBoolean ("taskd.compression.upload"))
+      request.set ("compression", "zlib");
+  }
+
   request.setPayload (payload);
 
   if (context.verbose ("sync"))
@@ -200,47 +295,14 @@ int CmdSync::execute (std::string& output)
       std::vector <std::string> lines;
       split (lines, payload, '\n');
 
-      // Load all tasks, but only if necessary.  There is always a sync key in
-      // the payload, so if there are two or more lines, then we have merging
-      // to perform, otherwise it's just a backlog.data update.
-      if (lines.size () > 1)
-        context.tdb2.all_tasks ();
-
+      // Separate the tasks from the sync key.  There is always a sync key in
+      // the payload, so any other line is a task to be merged.
+      std::vector <std::string> task_lines;
       std::string sync_key = "";
       for (auto& line : lines)
       {
         if (line[0] == '{')
-        {
-          ++download_count;
-
-          Task from_server (line);
-          std::string uuid = from_server.get ("uuid");
-
-          // Is it a new task from the server, or an update to an existing one?
-          Task dummy;
-          if (context.tdb2.get (uuid, dummy))
-          {
-            if (context.verbose ("sync"))
-              out << "  "
-                  << colorChanged.colorize (
-                       format (STRING_CMD_SYNC_MOD,
-                               uuid,
-                               from_server.get ("description")))
-                  << "\n";
-            context.tdb2.modify (from_server, false);
-          }
-          else
-          {
-            if (context.verbose ("sync"))
-              out << "  "
-                  << colorAdded.colorize (
-                       format (STRING_CMD_SYNC_ADD,
-                               uuid,
-                               from_server.get ("description")))
-                  << "\n";
-            context.tdb2.add (from_server, false);
-          }
-        }
+          task_lines.push_back (line);
         else if (line != "")
         {
           sync_key = line;
@@ -250,6 +312,43 @@ int CmdSync::execute (std::string& output)
         // Otherwise line is blank, so ignore it.
       }
 
+      // Merge the tasks as a batch: parse them all, then index the local tasks
+      // by UUID once, so that each add or modify is a constant time lookup
+      // rather than a scan of all tasks.
+      std::vector <Task> from_server = parseTasks (task_lines);
+      if (from_server.size ())
+        context.tdb2.index ();
+
+      for (auto& task : from_server)
+      {
+        ++download_count;
+        std::string uuid = task.get ("uuid");
+
+        // Is it a new task from the server, or an update to an existing one?
+        if (context.tdb2.has (uuid))
+        {
+          if (context.verbose ("sync"))
+            out << "  "
+                << colorChanged.colorize (
+                     format (STRING_CMD_SYNC_MOD,
+                             uuid,
+                             task.get ("description")))
+                << "\n";
+          context.tdb2.modify (task, false);
+        }
+        else
+        {
+          if (context.verbose ("sync"))
+            out << "  "
+                << colorAdded.colorize (
+                     format (STRING_CMD_SYNC_ADD,
+                             uuid,
+                             task.get ("description")))
+                << "\n";
+          context.tdb2.add (task, false);
+        }
+      }
+
       // Only update everything if there is a new sync_key.  No sync_key means
       // something horrible happened on the other end of the wire.
       if (sync_key != "")
@@ -378,7 +477,9 @@ bool CmdSync::send (
     client.recv (incoming);
     client.bye ();
 
-    response.parse (incoming);
+    // A compressed response may not inflate beyond the configured limit.
+    int limit = context.config.getInteger ("taskd.compression.limit");
+    response.parse (incoming, limit > 0 ? limit : 0);
     return true;
   }
 
@@ -31,6 +31,7 @@
 #include <stdlib.h>
 #include <Context.h>
 #include <Filter.h>
+#include <Aggregate.h>
 #include <ViewText.h>
 #include <text.h>
 #include <i18n.h>
@@ -73,20 +74,13 @@ int CmdTags::execute (std::string& output)
   std::vector <Task> filtered;
   filter.subset (tasks, filtered);
 
-  // Scan all the tasks for their project name, building a map using project
-  // names as keys.
-  std::map <std::string, int> unique;
-  for (auto& task : filtered)
-  {
-    std::vector <std::string> tags;
-    task.getTags (tags);
+  // Count the tasks carrying each tag.
+  Aggregate aggregate (Aggregate::tags);
+  aggregate.add (filtered);
 
-    for (auto& tag : tags)
-      if (unique.find (tag) != unique.end ())
-        unique[tag]++;
-      else
-        unique[tag] = 1;
-  }
+  std::map <std::string, int> unique;
+  for (auto& group : aggregate.groups ())
+    unique[group.first] = group.second._count;
 
   if (unique.size ())
   {
@@ -142,7 +142,7 @@ int CmdUDAs::execute (std::string& output)
   {
     for (auto& att : i.data)
       if (att.first.substr (0, 11) != "annotation_" &&
-          context.columns.find (att.first) == context.columns.end ())
+          ! context.columns.has (att.first))
         orphans[att.first]++;
   }
 
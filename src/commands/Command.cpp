@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <iostream>
+#include <assert.h>
 #include <vector>
 #include <stdlib.h>
 #include <text.h>
@@ -92,81 +93,95 @@
 extern Context context;
 
 ////////////////////////////////////////////////////////////////////////////////
-void Command::factory (std::map <std::string, Command*>& all)
+// Registers a built-in command under its keyword, without constructing it.
+template <class T>
+static void add (Registry <Command>& all, const std::string& keyword)
 {
-  Command* c;
-
-  c = new CmdAdd ();                all[c->keyword ()] = c;
-  c = new CmdAnnotate ();           all[c->keyword ()] = c;
-  c = new CmdAppend ();             all[c->keyword ()] = c;
-  c = new CmdBurndownDaily ();      all[c->keyword ()] = c;
-  c = new CmdBurndownMonthly ();    all[c->keyword ()] = c;
-  c = new CmdBurndownWeekly ();     all[c->keyword ()] = c;
-  c = new CmdCalc ();               all[c->keyword ()] = c;
-  c = new CmdCalendar ();           all[c->keyword ()] = c;
-  c = new CmdColor ();              all[c->keyword ()] = c;
-  c = new CmdColumns ();            all[c->keyword ()] = c;
-  c = new CmdCommands ();           all[c->keyword ()] = c;
-  c = new CmdCompletionAliases ();  all[c->keyword ()] = c;
-  c = new CmdCompletionColumns ();  all[c->keyword ()] = c;
-  c = new CmdCompletionCommands (); all[c->keyword ()] = c;
-  c = new CmdCompletionConfig ();   all[c->keyword ()] = c;
-  c = new CmdCompletionContext ();  all[c->keyword ()] = c;
-  c = new CmdCompletionIds ();      all[c->keyword ()] = c;
-  c = new CmdCompletionUDAs ();     all[c->keyword ()] = c;
-  c = new CmdCompletionUuids ();    all[c->keyword ()] = c;
-  c = new CmdCompletionProjects (); all[c->keyword ()] = c;
-  c = new CmdCompletionTags ();     all[c->keyword ()] = c;
-  c = new CmdCompletionVersion ();  all[c->keyword ()] = c;
-  c = new CmdConfig ();             all[c->keyword ()] = c;
-  c = new CmdContext ();            all[c->keyword ()] = c;
-  c = new CmdCount ();              all[c->keyword ()] = c;
-  c = new CmdDelete ();             all[c->keyword ()] = c;
-  c = new CmdDenotate ();           all[c->keyword ()] = c;
-  c = new CmdDiagnostics ();        all[c->keyword ()] = c;
-  c = new CmdDone ();               all[c->keyword ()] = c;
-  c = new CmdDuplicate ();          all[c->keyword ()] = c;
-  c = new CmdEdit ();               all[c->keyword ()] = c;
+  all.add (keyword, [keyword] () -> Command*
+  {
+    Command* c = new T ();
+    assert (c->keyword () == keyword);
+    return c;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Bulk command registration.  Commands are only constructed when first used.
+void Command::factory (Registry <Command>& all)
+{
+  Profiler::Span span ("Command::factory");
+
+  add <CmdAdd>                 (all, "add");
+  add <CmdAnnotate>            (all, "annotate");
+  add <CmdAppend>              (all, "append");
+  add <CmdBurndownDaily>       (all, "burndown.daily");
+  add <CmdBurndownMonthly>     (all, "burndown.monthly");
+  add <CmdBurndownWeekly>      (all, "burndown.weekly");
+  add <CmdCalc>                (all, "calc");
+  add <CmdCalendar>            (all, "calendar");
+  add <CmdColor>               (all, "colors");
+  add <CmdColumns>             (all, "columns");
+  add <CmdCommands>            (all, "commands");
+  add <CmdCompletionAliases>   (all, "_aliases");
+  add <CmdCompletionColumns>   (all, "_columns");
+  add <CmdCompletionCommands>  (all, "_commands");
+  add <CmdCompletionConfig>    (all, "_config");
+  add <CmdCompletionContext>   (all, "_context");
+  add <CmdCompletionIds>       (all, "_ids");
+  add <CmdCompletionUDAs>      (all, "_udas");
+  add <CmdCompletionUuids>     (all, "_uuids");
+  add <CmdCompletionProjects>  (all, "_projects");
+  add <CmdCompletionTags>      (all, "_tags");
+  add <CmdCompletionVersion>   (all, "_version");
+  add <CmdConfig>              (all, "config");
+  add <CmdContext>             (all, "context");
+  add <CmdCount>               (all, "count");
+  add <CmdDelete>              (all, "delete");
+  add <CmdDenotate>            (all, "denotate");
+  add <CmdDiagnostics>         (all, "diagnostics");
+  add <CmdDone>                (all, "done");
+  add <CmdDuplicate>           (all, "duplicate");
+  add <CmdEdit>                (all, "edit");
 #ifdef HAVE_EXECUTE
-  c = new CmdExec ();               all[c->keyword ()] = c;
+  add <CmdExec>                (all, "execute");
 #endif
-  c = new CmdExport ();             all[c->keyword ()] = c;
-  c = new CmdGet ();                all[c->keyword ()] = c;
-  c = new CmdGHistoryMonthly ();    all[c->keyword ()] = c;
-  c = new CmdGHistoryAnnual ();     all[c->keyword ()] = c;
-  c = new CmdHelp ();               all[c->keyword ()] = c;
-  c = new CmdHistoryMonthly ();     all[c->keyword ()] = c;
-  c = new CmdHistoryAnnual ();      all[c->keyword ()] = c;
-  c = new CmdIDs ();                all[c->keyword ()] = c;
-  c = new CmdImport ();             all[c->keyword ()] = c;
-  c = new CmdInfo ();               all[c->keyword ()] = c;
-  c = new CmdLog ();                all[c->keyword ()] = c;
-  c = new CmdLogo ();               all[c->keyword ()] = c;
-  c = new CmdModify ();             all[c->keyword ()] = c;
-  c = new CmdPrepend ();            all[c->keyword ()] = c;
-  c = new CmdProjects ();           all[c->keyword ()] = c;
-  c = new CmdReports ();            all[c->keyword ()] = c;
-  c = new CmdShow ();               all[c->keyword ()] = c;
-  c = new CmdShowRaw ();            all[c->keyword ()] = c;
-  c = new CmdStart ();              all[c->keyword ()] = c;
-  c = new CmdStats ();              all[c->keyword ()] = c;
-  c = new CmdStop ();               all[c->keyword ()] = c;
-  c = new CmdSummary ();            all[c->keyword ()] = c;
-  c = new CmdSync ();               all[c->keyword ()] = c;
-  c = new CmdTags ();               all[c->keyword ()] = c;
-  c = new CmdTimesheet ();          all[c->keyword ()] = c;
-  c = new CmdUDAs ();               all[c->keyword ()] = c;
-  c = new CmdUndo ();               all[c->keyword ()] = c;
-  c = new CmdUnique ();             all[c->keyword ()] = c;
-  c = new CmdUrgency ();            all[c->keyword ()] = c;
-  c = new CmdUUIDs ();              all[c->keyword ()] = c;
-  c = new CmdVersion ();            all[c->keyword ()] = c;
-  c = new CmdZshAttributes ();      all[c->keyword ()] = c;
-  c = new CmdZshCommands ();        all[c->keyword ()] = c;
-  c = new CmdZshCompletionIds ();   all[c->keyword ()] = c;
-  c = new CmdZshCompletionUuids (); all[c->keyword ()] = c;
-
-  // Instantiate a command object for each custom report.
+  add <CmdExport>              (all, "export");
+  add <CmdGet>                 (all, "_get");
+  add <CmdGHistoryMonthly>     (all, "ghistory.monthly");
+  add <CmdGHistoryAnnual>      (all, "ghistory.annual");
+  add <CmdHelp>                (all, "help");
+  add <CmdHistoryMonthly>      (all, "history.monthly");
+  add <CmdHistoryAnnual>       (all, "history.annual");
+  add <CmdIDs>                 (all, "ids");
+  add <CmdImport>              (all, "import");
+  add <CmdInfo>                (all, "information");
+  add <CmdLog>                 (all, "log");
+  add <CmdLogo>                (all, "logo");
+  add <CmdModify>              (all, "modify");
+  add <CmdPrepend>             (all, "prepend");
+  add <CmdProjects>            (all, "projects");
+  add <CmdReports>             (all, "reports");
+  add <CmdShow>                (all, "show");
+  add <CmdShowRaw>             (all, "_show");
+  add <CmdStart>               (all, "start");
+  add <CmdStats>               (all, "stats");
+  add <CmdStop>                (all, "stop");
+  add <CmdSummary>             (all, "summary");
+  add <CmdSync>                (all, "synchronize");
+  add <CmdTags>                (all, "tags");
+  add <CmdTimesheet>           (all, "timesheet");
+  add <CmdUDAs>                (all, "udas");
+  add <CmdUndo>                (all, "undo");
+  add <CmdUnique>              (all, "_unique");
+  add <CmdUrgency>             (all, "_urgency");
+  add <CmdUUIDs>               (all, "uuids");
+  add <CmdVersion>             (all, "version");
+  add <CmdZshAttributes>       (all, "_zshattributes");
+  add <CmdZshCommands>         (all, "_zshcommands");
+  add <CmdZshCompletionIds>    (all, "_zshids");
+  add <CmdZshCompletionUuids>  (all, "_zshuuids");
+
+  // Register a command for each custom report.
   std::vector <std::string> reports;
   for (auto &i : context.config)
   {
@@ -182,15 +197,16 @@ void Command::factory (std::map <std::string, Command*>& all)
   for (auto &report : reports)
   {
     // Make sure a custom report does not clash with a built-in command.
-    if (all.find (report) != all.end ())
+    if (all.has (report))
       throw format (STRING_CMD_CONFLICT, report);
 
-    c = new CmdCustom (
-              report,
-              "task <filter> " + report,
-              context.config.get ("report." + report + ".description"));
-
-    all[c->keyword ()] = c;
+    all.add (report, [report] () -> Command*
+    {
+      return new CmdCustom (
+                   report,
+                   "task <filter> " + report,
+                   context.config.get ("report." + report + ".description"));
+    });
   }
 }
 
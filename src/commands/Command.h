@@ -31,6 +31,7 @@
 #include <vector>
 #include <string>
 #include <Task.h>
+#include <Registry.h>
 
 class Command
 {
@@ -55,7 +56,7 @@ public:
   Command ();
   virtual ~Command ();
 
-  static void factory (std::map <std::string, Command*>&);
+  static void factory (Registry <Command>&);
 
   std::string keyword () const;
   std::string usage () const;
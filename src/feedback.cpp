@@ -262,7 +262,7 @@ std::string taskInfoDifferences (
 ////////////////////////////////////////////////////////////////////////////////
 std::string renderAttribute (const std::string& name, const std::string& value, const std::string& format /* = "" */)
 {
-  if (context.columns.find (name) != context.columns.end ())
+  if (context.columns.has (name))
   {
     Column* col = context.columns[name];
     if (col                    &&
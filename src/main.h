@@ -38,8 +38,7 @@
 
 // recur.cpp
 void handleRecurrence ();
-ISO8601d getNextRecurrence (ISO8601d&, std::string&);
-bool generateDueDates (Task&, std::vector <ISO8601d>&);
+bool generateDueDates (Task&, std::vector <ISO8601d>&, unsigned int = 0, time_t* = nullptr);
 void updateRecurrenceMask (Task&);
 bool nag (Task&);
 
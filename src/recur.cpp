@@ -37,96 +37,189 @@
 #include <stdlib.h>
 #include <pwd.h>
 #include <time.h>
+#include <algorithm>
 
 #include <Context.h>
+#include <FS.h>
 #include <Lexer.h>
 #include <ISO8601.h>
 #include <text.h>
 #include <util.h>
 #include <i18n.h>
+#include <Recurrence.h>
 #include <main.h>
 
 // Global context for use by all.
 extern Context context;
 
+////////////////////////////////////////////////////////////////////////////////
+// The recurrence watermark is the earliest time at which handleRecurrence can
+// next have anything to do, provided the pending tasks are unchanged.  It is
+// stored in the data directory, keyed by the size and modification time of
+// pending.data and by recurrence.limit.
+static std::string watermarkFile ()
+{
+  return context.data_dir._data + "/recurrence.data";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Identifies the pending tasks without reading them.  A change made within the
+// current second may be followed by another one with the same size and time,
+// so a file that recent has no key.
+static std::string watermarkKey (const ISO8601d& now)
+{
+  File pending (context.data_dir._data + "/pending.data");
+  if (! pending.exists () ||
+      pending.mtime () >= now.toEpoch ())
+    return "";
+
+  return std::to_string (pending.size ())  + ' ' +
+         std::to_string (pending.mtime ()) + ' ' +
+         std::to_string (context.config.getInteger ("recurrence.limit"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Reads the watermark recorded for 'key'.  A missing, stale or malformed
+// record is a miss, which makes the caller scan.
+static bool readWatermark (const std::string& key, time_t& watermark)
+{
+  std::string stamp;
+  if (! File::read (watermarkFile (), stamp) ||
+      stamp.compare (0, key.length () + 1, key + ' ') != 0)
+    return false;
+
+  const char* start = stamp.c_str () + key.length () + 1;
+  char* end;
+  long long value = strtoll (start, &end, 10);
+  if (end == start || *end != '\n')
+    return false;
+
+  watermark = (time_t) value;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Several processes may scan at once, so the record is renamed into place, and
+// a reader sees either the old or the new one.
+static void writeWatermark (const std::string& key, time_t watermark)
+{
+  std::string file = watermarkFile ();
+  std::string temporary = file + "." + format ((int) getpid ());
+  std::ofstream out (temporary.c_str (), std::ios::trunc);
+  if (out.good ())
+  {
+    out << key << ' ' << watermark << '\n';
+    out.close ();
+
+    if (out.good () &&
+        rename (temporary.c_str (), file.c_str ()) == 0)
+      return;
+  }
+
+  unlink (temporary.c_str ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static void earliest (time_t& watermark, time_t when)
+{
+  if (when && (watermark == 0 || when < watermark))
+    watermark = when;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Scans all tasks, and for any recurring tasks, determines whether any new
 // child tasks need to be generated to fill gaps.
 void handleRecurrence ()
 {
+  Profiler::Span span ("handleRecurrence");
+
   // Recurrence can be disabled.
   // Note: This is currently a workaround for TD-44, TW-1520.
   if (! context.config.getBoolean ("recurrence"))
     return;
 
+  // Nothing can have changed since the last scan if the pending tasks are the
+  // same, and the watermark has not been reached.  A zero watermark means
+  // there is nothing left to do at any time.  Instances are generated as of
+  // the same time, so the watermark agrees with them.
+  ISO8601d now (context.snapshot.now);
+  std::string key = watermarkKey (now);
+  time_t recorded;
+  if (key != "" &&
+      readWatermark (key, recorded) &&
+      (recorded == 0 || now.toEpoch () < recorded))
+    return;
+
   auto tasks = context.tdb2.pending.get_tasks ();
-  ISO8601d now;
+  bool modified = false;
+  time_t watermark = 0;
 
   // Look at all tasks and find any recurring ones.
   for (auto& t : tasks)
   {
     if (t.getStatus () == Task::recurring)
     {
-      // Generate a list of due dates for this recurring task, regardless of
-      // the mask.
+      // Get the mask from the parent task.
+      std::string mask = t.get ("mask");
+
+      // Generate a list of the due dates for this recurring task that are not
+      // yet covered by the mask.
       std::vector <ISO8601d> due;
-      if (!generateDueDates (t, due))
+      time_t next;
+      if (!generateDueDates (t, due, mask.length (), &next))
       {
         // Determine the end date.
+        modified = true;
         t.setStatus (Task::deleted);
         context.tdb2.modify (t);
         context.footnote (onExpiration (t));
         continue;
       }
 
-      // Get the mask from the parent task.
-      std::string mask = t.get ("mask");
+      earliest (watermark, next);
 
-      // Iterate over the due dates, and check each against the mask.
+      // Each generated due date is a new instance, with the next index.
       bool changed = false;
-      unsigned int i = 0;
+      unsigned int i = mask.length ();
       for (auto& d : due)
       {
-        if (mask.length () <= i)
+        changed = true;
+
+        Task rec (t);                          // Clone the parent.
+        rec.setStatus (Task::pending);         // Change the status.
+        rec.id = context.tdb2.next_id ();      // New ID.
+        rec.set ("uuid", uuid ());             // New UUID.
+        rec.set ("parent", t.get ("uuid"));    // Remember mom.
+        rec.setAsNow ("entry");                // New entry date.
+
+        char dueDate[16];
+        sprintf (dueDate, "%u", (unsigned int) d.toEpoch ());
+        rec.set ("due", dueDate);              // Store generated due date.
+
+        if (t.has ("wait"))
         {
-          changed = true;
-
-          Task rec (t);                          // Clone the parent.
-          rec.setStatus (Task::pending);         // Change the status.
-          rec.id = context.tdb2.next_id ();      // New ID.
-          rec.set ("uuid", uuid ());             // New UUID.
-          rec.set ("parent", t.get ("uuid"));    // Remember mom.
-          rec.setAsNow ("entry");                // New entry date.
-
-          char dueDate[16];
-          sprintf (dueDate, "%u", (unsigned int) d.toEpoch ());
-          rec.set ("due", dueDate);              // Store generated due date.
-
-          if (t.has ("wait"))
-          {
-            ISO8601d old_wait (t.get_date ("wait"));
-            ISO8601d old_due (t.get_date ("due"));
-            ISO8601d due (d);
-            sprintf (dueDate, "%u", (unsigned int) (due + (old_wait - old_due)).toEpoch ());
-            rec.set ("wait", dueDate);
-            rec.setStatus (Task::waiting);
-            mask += 'W';
-          }
-          else
-          {
-            mask += '-';
-            rec.setStatus (Task::pending);
-          }
-
-          char indexMask[12];
-          sprintf (indexMask, "%u", (unsigned int) i);
-          rec.set ("imask", indexMask);          // Store index into mask.
-
-          rec.remove ("mask");                   // Remove the mask of the parent.
-
-          // Add the new task to the DB.
-          context.tdb2.add (rec);
+          ISO8601d old_wait (t.get_date ("wait"));
+          ISO8601d old_due (t.get_date ("due"));
+          ISO8601d due (d);
+          sprintf (dueDate, "%u", (unsigned int) (due + (old_wait - old_due)).toEpoch ());
+          rec.set ("wait", dueDate);
+          rec.setStatus (Task::waiting);
+          mask += 'W';
         }
+        else
+        {
+          mask += '-';
+          rec.setStatus (Task::pending);
+        }
+
+        char indexMask[12];
+        sprintf (indexMask, "%u", (unsigned int) i);
+        rec.set ("imask", indexMask);          // Store index into mask.
+
+        rec.remove ("mask");                   // Remove the mask of the parent.
+
+        // Add the new task to the DB.
+        context.tdb2.add (rec);
 
         ++i;
       }
@@ -134,6 +227,7 @@ void handleRecurrence ()
       // Only modify the parent if necessary.
       if (changed)
       {
+        modified = true;
         t.set ("mask", mask);
         context.tdb2.modify (t);
 
@@ -143,32 +237,54 @@ void handleRecurrence ()
     }
 
     // Non-recurring tasks expire too.
-    else
+    else if (t.has ("until"))
     {
-      if (t.has ("until") &&
-          ISO8601d (t.get_date ("until")) < now)
+      ISO8601d until (t.get_date ("until"));
+      if (until < now)
       {
+        modified = true;
         t.setStatus (Task::deleted);
         context.tdb2.modify(t);
         context.footnote (onExpiration (t));
       }
+      else
+        earliest (watermark, until.toEpoch () + 1);
     }
   }
+
+  // Any changes are not yet written, so a watermark can only be recorded if
+  // there were none.
+  if (! modified        &&
+      key != ""         &&
+      ! context.tdb2.read_only ())
+    writeWatermark (key, watermark);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Determine a start date (due), an optional end date (until), and an increment
-// period (recur).  Then generate a set of corresponding dates.
+// period (recur).  Then generate the corresponding dates, starting with the
+// instance at index 'first', so that instances that already exist, as recorded
+// in the mask, need not be generated again.  Later instances are reached
+// directly, rather than by stepping through every earlier one.
 //
-// Returns false if the parent recurring task is depleted.
-bool generateDueDates (Task& parent, std::vector <ISO8601d>& allDue)
+// Returns false if the parent recurring task is depleted.  If 'next' is given,
+// it is set to the time at which a later call could first generate something
+// different, or zero if that depends only on changes to the parent.
+bool generateDueDates (
+  Task& parent,
+  std::vector <ISO8601d>& allDue,
+  unsigned int first /* = 0 */,
+  time_t* next /* = nullptr */)
 {
+  if (next)
+    *next = 0;
+
   // Determine due date, recur period and until date.
   ISO8601d due (parent.get_date ("due"));
   if (due._date == 0)
     return false;
 
-  std::string recur = parent.get ("recur");
+  Recurrence recur (parent.get ("recur"));
 
   bool specificEnd = false;
   ISO8601d until;
@@ -178,208 +294,59 @@ bool generateDueDates (Task& parent, std::vector <ISO8601d>& allDue)
     specificEnd = true;
   }
 
+  // The last instance is the one that brings the number of future instances up
+  // to the limit, or the first one after the end date, whichever comes first.
+  // A period that does not advance only ever has the one instance.
+  long last = 0;
   int recurrence_limit = context.config.getInteger ("recurrence.limit");
-  int recurrence_counter = 0;
-  ISO8601d now;
-  for (ISO8601d i = due; ; i = getNextRecurrence (i, recur))
-  {
-    allDue.push_back (i);
-
-    if (specificEnd && i > until)
-    {
-      // If i > until, it means there are no more tasks to generate, and if the
-      // parent mask contains all + or X, then there never will be another task
-      // to generate, and this parent task may be safely reaped.
-      std::string mask = parent.get ("mask");
-      if (mask.length () == allDue.size () &&
-          mask.find ('-') == std::string::npos)
-        return false;
-
-      return true;
-    }
-
-    if (i > now)
-      ++recurrence_counter;
-
-    if (recurrence_counter >= recurrence_limit)
-      return true;
-  }
-
-  return true;
-}
-
-////////////////////////////////////////////////////////////////////////////////
-ISO8601d getNextRecurrence (ISO8601d& current, std::string& period)
-{
-  int m = current.month ();
-  int d = current.day ();
-  int y = current.year ();
-  int ho = current.hour ();
-  int mi = current.minute ();
-  int se = current.second ();
-
-  // Some periods are difficult, because they can be vague.
-  if (period == "monthly" ||
-      period == "P1M")
-  {
-    if (++m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
-  }
-
-  else if (period == "weekdays")
-  {
-    int dow = current.dayOfWeek ();
-    int days;
-
-         if (dow == 5) days = 3;
-    else if (dow == 6) days = 2;
-    else               days = 1;
-
-    return current + (days * 86400);
-  }
-
-  else if (Lexer::isDigit (period[0]) &&
-           period[period.length () - 1] == 'm')
-  {
-    int increment = strtol (period.substr (0, period.length () - 1).c_str (), NULL, 10);
-
-    m += increment;
-    while (m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
-  }
-
-  else if (period[0] == 'P'                                            &&
-           Lexer::isAllDigits (period.substr (1, period.length () - 2)) &&
-           period[period.length () - 1] == 'M')
-  {
-    int increment = strtol (period.substr (0, period.length () - 1).c_str (), NULL, 10);
-
-    m += increment;
-    while (m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
+  if (recurrence_limit > 0 && recur.advances ())
+    last = recur.count (due, ISO8601d (context.snapshot.now)) + recurrence_limit - 1;
 
-    return ISO8601d (m, d, y);
-  }
-
-  else if (period == "quarterly" ||
-           period == "P3M")
+  bool expired = false;
+  if (specificEnd && recur.advance (due, last) > until)
   {
-    m += 3;
-    if (m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
+    expired = true;
+    if (recur.advances ())
+      last = recur.count (due, until);
   }
 
-  else if (Lexer::isDigit (period[0]) && period[period.length () - 1] == 'q')
+  if (expired)
   {
-    int increment = strtol (period.substr (0, period.length () - 1).c_str (), NULL, 10);
-
-    m += 3 * increment;
-    while (m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
-  }
-
-  else if (period == "semiannual" ||
-           period == "P6M")
-  {
-    m += 6;
-    if (m > 12)
-    {
-       m -= 12;
-       ++y;
-    }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
+    // If there are no more tasks to generate, and if the parent mask contains
+    // all + or X, then there never will be another task to generate, and this
+    // parent task may be safely reaped.
+    std::string mask = parent.get ("mask");
+    if (mask.length () == (size_t) last + 1 &&
+        mask.find ('-') == std::string::npos)
+      return false;
   }
 
-  else if (period == "bimonthly" ||
-           period == "P2M")
+  if ((long) first <= last)
   {
-    m += 2;
-    if (m > 12)
+    allDue.reserve (last - first + 1);
+    ISO8601d i = recur.advance (due, first);
+    allDue.push_back (i);
+    for (long n = first + 1; n <= last; ++n)
     {
-       m -= 12;
-       ++y;
+      i = recur.next (i);
+      allDue.push_back (i);
     }
-
-    while (! ISO8601d::valid (m, d, y))
-      --d;
-
-    return ISO8601d (m, d, y, ho, mi, se);
   }
 
-  else if (period == "biannual" ||
-           period == "biyearly" ||
-           period == "P2Y")
+  // Once the mask covers the generated instances, the next change comes when
+  // enough of them are past that the number of future ones drops below the
+  // limit.  An end date brings that forward, because the parent expires
+  // instead.  An expired parent stays expired.
+  if (next && ! expired && recurrence_limit > 0 && recur.advances ())
   {
-    y += 2;
+    long length = std::max ((long) first, last + 1);
+    if (specificEnd && length > last + 1)
+      length = std::min (length, recur.count (due, until));
 
-    return ISO8601d (m, d, y, ho, mi, se);
+    *next = recur.advance (due, length - recurrence_limit).toEpoch ();
   }
 
-  else if (period == "annual" ||
-           period == "yearly" ||
-           period == "P1Y")
-  {
-    y += 1;
-
-    // If the due data just happens to be 2/29 in a leap year, then simply
-    // incrementing y is going to create an invalid date.
-    if (m == 2 && d == 29)
-      d = 28;
-
-    return ISO8601d (m, d, y, ho, mi, se);
-  }
-
-  // Add the period to current, and we're done.
-  int secs = 0;
-  std::string::size_type idx = 0;
-  ISO8601p p;
-  if (! p.parse (period, idx))
-    throw std::string (format (STRING_TASK_VALID_RECUR, period));
-
-  secs = (time_t) p;
-  return current + secs;
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
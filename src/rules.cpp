@@ -27,7 +27,6 @@
 #include <cmake.h>
 #include <stdlib.h>
 #include <Context.h>
-#include <ISO8601.h>
 #include <text.h>
 #include <util.h>
 #include <main.h>
@@ -36,7 +35,10 @@ extern Context context;
 
 static std::map <std::string, Color> gsColor;
 static std::vector <std::string> gsPrecedence;
-static ISO8601d now;
+
+// Read once per task.
+static const Config::Key searchCaseSensitive = Config::key ("search.case.sensitive");
+static const Config::Key ruleColorMerge      = Config::key ("rule.color.merge");
 
 ////////////////////////////////////////////////////////////////////////////////
 void initializeColorRules ()
@@ -130,7 +132,7 @@ static void colorizeActive (Task& task, const Color& base, Color& c, bool merge)
 static void colorizeScheduled (Task& task, const Color& base, Color& c, bool merge)
 {
   if (task.has ("scheduled") &&
-      ISO8601d (task.get_date ("scheduled")) <= now)
+      task.get_date ("scheduled") <= context.snapshot.now)
     applyColor (base, c, merge);
 }
 
@@ -152,7 +154,7 @@ static void colorizeTag (Task& task, const std::string& rule, const Color& base,
 static void colorizeProject (Task& task, const std::string& rule, const Color& base, Color& c, bool merge)
 {
   // Observe the case sensitivity setting.
-  bool sensitive = context.config.getBoolean ("search.case.sensitive");
+  bool sensitive = context.config.getBoolean (searchCaseSensitive);
 
   std::string project = task.get ("project");
   std::string rule_trunc = rule.substr (14);
@@ -181,7 +183,7 @@ static void colorizeTagNone (Task& task, const Color& base, Color& c, bool merge
 static void colorizeKeyword (Task& task, const std::string& rule, const Color& base, Color& c, bool merge)
 {
   // Observe the case sensitivity setting.
-  bool sensitive = context.config.getBoolean ("search.case.sensitive");
+  bool sensitive = context.config.getBoolean (searchCaseSensitive);
 
   // The easiest thing to check is the description, because it is just one
   // attribute.
@@ -296,7 +298,7 @@ void autoColorize (Task& task, Color& c)
     return;
   }
 
-  bool merge = context.config.getBoolean ("rule.color.merge");
+  bool merge = context.config.getBoolean (ruleColorMerge);
 
   // Note: c already contains colors specifically assigned via command.
   // Note: These rules form a hierarchy - the last rule is King, hence the
@@ -48,6 +48,7 @@ void sort_tasks (
   const std::string& keys)
 {
   context.timer_sort.start ();
+  Profiler::Span span ("sort_tasks");
 
   global_data = &data;
 
@@ -178,17 +178,34 @@ int longestWord (const std::string& input)
   std::string::size_type i = 0;
   int character;
 
-  while ((character = utf8_next_char (input, i)))
+  while (1)
   {
-    if (character == ' ')
+    // Within a run of printable ASCII, words are delimited only by spaces,
+    // and every byte is one cell wide.
+    std::string::size_type end = i + utf8_ascii_run (input, i);
+    while (i < end)
     {
-      if (length > longest)
-        longest = length;
+      std::string::size_type space = input.find (' ', i);
+      if (space >= end)
+      {
+        length += end - i;
+        i = end;
+      }
+      else
+      {
+        length += space - i;
+        if (length > longest)
+          longest = length;
 
-      length = 0;
+        length = 0;
+        i = space + 1;
+      }
     }
-    else
-      length += mk_wcwidth (character);
+
+    if (! (character = utf8_next_char (input, i)))
+      break;
+
+    length += mk_wcwidth (character);
   }
 
   if (length > longest)
@@ -205,8 +222,16 @@ int longestLine (const std::string& input)
   std::string::size_type i = 0;
   int character;
 
-  while ((character = utf8_next_char (input, i)))
+  while (1)
   {
+    // Printable ASCII is one cell per byte, and contains no newlines.
+    unsigned int run = utf8_ascii_run (input, i);
+    length += run;
+    i += run;
+
+    if (! (character = utf8_next_char (input, i)))
+      break;
+
     if (character == '\n')
     {
       if (length > longest)
@@ -253,6 +278,18 @@ bool extractLine (
   if (offset >= text.length ())
     return false;
 
+  // Common case: the rest of the line is printable ASCII, and fits.
+  std::string::size_type run = utf8_ascii_run (text, offset);
+  std::string::size_type end = offset + run;
+  if (width >= 0 &&
+      run <= (std::string::size_type) width &&
+      (end == text.length () || text[end] == '\n'))
+  {
+    line = text.substr (offset, run);
+    offset = end == text.length () ? end : end + 1;
+    return true;
+  }
+
   std::string::size_type last_last_bytes = offset;
   std::string::size_type last_bytes = offset;
   std::string::size_type bytes = offset;
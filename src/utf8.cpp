@@ -27,6 +27,12 @@
 #include <cmake.h>
 #include <utf8.h>
 #include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 // Converts '0'     -> 0
@@ -68,6 +74,84 @@ unsigned int utf8_codepoint (const std::string& input)
   return codepoint;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Number of printable ASCII bytes (0x20 - 0x7E) in the run starting at offset.
+// Each of these is one character, one cell wide, so callers can skip the run
+// in bulk instead of decoding it.  Uses AVX2 or SSE2 when the compiler targets
+// them, 32 or 16 bytes at a time, with a scalar loop for the remainder.
+unsigned int utf8_ascii_run (const std::string& input, std::string::size_type offset)
+{
+  if (offset >= input.length ())
+    return 0;
+
+  const char* data = input.data () + offset;
+  std::string::size_type length = input.length () - offset;
+  std::string::size_type i = 0;
+
+  // Signed byte comparisons: bytes >= 0x80 are negative, so they fail the
+  // '> 0x1F' test along with the control characters.
+#ifdef __AVX2__
+  const __m256i low32  = _mm256_set1_epi8 (0x1F);
+  const __m256i high32 = _mm256_set1_epi8 (0x7F);
+  for (; i + 32 <= length; i += 32)
+  {
+    __m256i chunk = _mm256_loadu_si256 ((const __m256i*) (data + i));
+    __m256i printable = _mm256_and_si256 (_mm256_cmpgt_epi8 (chunk, low32),
+                                          _mm256_cmpgt_epi8 (high32, chunk));
+    unsigned int other = ~ (unsigned int) _mm256_movemask_epi8 (printable);
+    if (other)
+      return i + __builtin_ctz (other);
+  }
+#endif
+
+#ifdef __SSE2__
+  const __m128i low16  = _mm_set1_epi8 (0x1F);
+  const __m128i high16 = _mm_set1_epi8 (0x7F);
+  for (; i + 16 <= length; i += 16)
+  {
+    __m128i chunk = _mm_loadu_si128 ((const __m128i*) (data + i));
+    __m128i printable = _mm_and_si128 (_mm_cmpgt_epi8 (chunk, low16),
+                                       _mm_cmpgt_epi8 (high16, chunk));
+    unsigned int other = ~ (unsigned int) _mm_movemask_epi8 (printable) & 0xFFFF;
+    if (other)
+      return i + __builtin_ctz (other);
+  }
+#endif
+
+  for (; i < length; ++i)
+  {
+    unsigned char c = data[i];
+    if (c < 0x20 || c > 0x7E)
+      break;
+  }
+
+  return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Advances index by count characters, or to the end of the string.
+static void utf8_advance (
+  const std::string& input,
+  std::string::size_type& index,
+  unsigned int count)
+{
+  while (count)
+  {
+    std::string::size_type run = utf8_ascii_run (input, index);
+    if (run > count)
+      run = count;
+
+    index += run;
+    count -= run;
+
+    if (count)
+    {
+      utf8_next_char (input, index);
+      --count;
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Iterates along a UTF8 string.
 //   - argument i counts bytes advanced through the string
@@ -171,8 +255,20 @@ unsigned int utf8_length (const std::string& str)
   const char* data = str.data ();
 
   // Decrement the number of bytes for each byte that matches 0b10??????
-  // this way only the first byte of any utf8 sequence is counted.
-  for (int i = 0; i < byteLength; i++)
+  // this way only the first byte of any utf8 sequence is counted.  As signed
+  // bytes these are exactly the values below -64, which SSE2 counts 16 at a
+  // time.
+  int i = 0;
+#ifdef __SSE2__
+  const __m128i limit = _mm_set1_epi8 (-64);
+  for (; i + 16 <= byteLength; i += 16)
+  {
+    __m128i chunk = _mm_loadu_si128 ((const __m128i*) (data + i));
+    charLength -= __builtin_popcount (_mm_movemask_epi8 (_mm_cmpgt_epi8 (limit, chunk)));
+  }
+#endif
+
+  for (; i < byteLength; i++)
   {
     // Extract the first two bits and check whether they are 10
     if ((data[i] & 0xC0) == 0x80)
@@ -189,8 +285,16 @@ unsigned int utf8_width (const std::string& str)
   unsigned int length = 0;
   std::string::size_type i = 0;
   unsigned int c;
-  while ((c = utf8_next_char (str, i)))
+  while (1)
   {
+    // Printable ASCII is one cell per byte.
+    unsigned int run = utf8_ascii_run (str, i);
+    length += run;
+    i += run;
+
+    if (! (c = utf8_next_char (str, i)))
+      break;
+
     // Control characters, and more especially newline characters, make
     // mk_wcwidth() return -1.  Ignore that, thereby "adding zero" to length.
     // Since control characters are not displayed in reports, this is a valid
@@ -249,13 +353,24 @@ unsigned int utf8_text_width (const std::string& str)
   unsigned int length = 0;
   std::string::size_type i = 0;
   unsigned int c;
-  while ((c = utf8_next_char (str, i)))
+  while (1)
   {
+    // Printable ASCII outside a color sequence is one cell per byte.
+    if (! in_color)
+    {
+      unsigned int run = utf8_ascii_run (str, i);
+      length += run;
+      i += run;
+    }
+
+    if (! (c = utf8_next_char (str, i)))
+      break;
+
     if (in_color)
     {
       if (c == 'm')
         in_color = false;
-    }  
+    }
     else if (c == 033)
     {
       in_color = true;
@@ -275,15 +390,13 @@ const std::string utf8_substr (
 {
   // Find the starting index.
   std::string::size_type index_start = 0;
-  for (unsigned int i = 0; i < start; i++)
-    utf8_next_char (input, index_start);
+  utf8_advance (input, index_start, start);
 
   std::string result;
   if (length)
   {
     std::string::size_type index_end = index_start;
-    for (unsigned int i = 0; i < length; i++)
-      utf8_next_char (input, index_end);
+    utf8_advance (input, index_end, length);
 
     result = input.substr (index_start, index_end - index_start);
   }
@@ -30,6 +30,7 @@
 #include <string>
 
 unsigned int utf8_codepoint (const std::string&);
+unsigned int utf8_ascii_run (const std::string&, std::string::size_type);
 unsigned int utf8_next_char (const std::string&, std::string::size_type&);
 std::string utf8_character (unsigned int);
 int utf8_sequence (unsigned int);
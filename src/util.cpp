@@ -51,6 +51,8 @@
 #include <errno.h>
 #include <signal.h>
 #include <sys/select.h>
+#include <fcntl.h>
+#include <mutex>
 
 #include <Lexer.h>
 #include <text.h>
@@ -247,7 +249,83 @@ const std::string uuid ()
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
-// Run a binary with args, capturing output.
+static std::mutex execute_mutex;
+static int execute_running = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+// SIGPIPE is ignored while any execute call is running, and restored when the
+// last one finishes, however it finishes.
+class SigpipeGuard
+{
+public:
+  SigpipeGuard ()
+  {
+    std::lock_guard <std::mutex> lock (execute_mutex);
+    if (execute_running == 0 &&
+        signal (SIGPIPE, SIG_IGN) == SIG_ERR) // Handled locally with EPIPE.
+      throw std::string (std::strerror (errno));
+
+    ++execute_running;
+  }
+
+  ~SigpipeGuard ()
+  {
+    std::lock_guard <std::mutex> lock (execute_mutex);
+    if (--execute_running == 0)
+      signal (SIGPIPE, SIG_DFL);  // We're done, return to default.
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The parent's pipe ends, closed on every exit path.
+class PipeGuard
+{
+public:
+  PipeGuard ()
+  {
+    pin[0] = pin[1] = pout[0] = pout[1] = -1;
+  }
+
+  ~PipeGuard ()
+  {
+    release (pin[0]);
+    release (pin[1]);
+    release (pout[0]);
+    release (pout[1]);
+  }
+
+  static void release (int& fd)
+  {
+    if (fd != -1)
+    {
+      close (fd);
+      fd = -1;
+    }
+  }
+
+  int pin[2];
+  int pout[2];
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Creates a pipe whose ends are not inherited by any exec'd child.
+static int pipe_cloexec (int fds[2])
+{
+#ifdef HAVE_PIPE2
+  return pipe2 (fds, O_CLOEXEC);
+#else
+  if (pipe (fds) == -1)
+    return -1;
+
+  fcntl (fds[0], F_SETFD, FD_CLOEXEC);
+  fcntl (fds[1], F_SETFD, FD_CLOEXEC);
+  return 0;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Run a binary with args, capturing output.  Safe to call from several threads
+// at once.
 int execute (
   const std::string& executable,
   const std::vector <std::string>& args,
@@ -255,7 +333,6 @@ int execute (
   std::string& output)
 {
   pid_t pid;
-  int pin[2], pout[2];
   fd_set rfds, wfds;
   struct timeval tv;
   int select_retval, read_retval, write_retval;
@@ -263,17 +340,38 @@ int execute (
   unsigned int written;
   const char* input_cstr = input.c_str ();
 
-  if (signal (SIGPIPE, SIG_IGN) == SIG_ERR) // Handled locally with EPIPE.
-    throw std::string (std::strerror (errno));
+  // Add executable as argv[0] and NULL-terminate the array for execvp().
+  // This is built before forking, because the child may only make
+  // async-signal-safe calls when other threads are running.
+  std::vector <char*> argv;
+  argv.push_back ((char*) executable.c_str ());
+  for (auto& arg : args)
+    argv.push_back ((char*) arg.c_str ());
+  argv.push_back (NULL);
 
-  if (pipe (pin) == -1)
-    throw std::string (std::strerror (errno));
+  SigpipeGuard sigpipe;
+  PipeGuard pipes;
+  int* pin  = pipes.pin;
+  int* pout = pipes.pout;
 
-  if (pipe (pout) == -1)
-    throw std::string (std::strerror (errno));
+  {
+    // Several hook scripts may be launched concurrently.  The pipe ends are
+    // close-on-exec, so that no child inherits the pipes of another, which
+    // would delay its EOF.  Without pipe2 there is a window between creating
+    // a pipe and marking it, so creation and fork are serialized.
+#ifndef HAVE_PIPE2
+    std::lock_guard <std::mutex> lock (execute_mutex);
+#endif
 
-  if ((pid = fork ()) == -1)
-    throw std::string (std::strerror (errno));
+    if (pipe_cloexec (pin) == -1)
+      throw std::string (std::strerror (errno));
+
+    if (pipe_cloexec (pout) == -1)
+      throw std::string (std::strerror (errno));
+
+    if ((pid = fork ()) == -1)
+      throw std::string (std::strerror (errno));
+  }
 
   if (pid == 0)
   {
@@ -283,32 +381,25 @@ int execute (
 
     // Parent writes to pin[1]. Set read end pin[0] as STDIN for child.
     if (dup2 (pin[0], STDIN_FILENO) == -1)
-      throw std::string (std::strerror (errno));
+      _exit (127);
     close (pin[0]);
 
     // Parent reads from pout[0]. Set write end pout[1] as STDOUT for child.
     if (dup2 (pout[1], STDOUT_FILENO) == -1)
-      throw std::string (std::strerror (errno));
+      _exit (127);
     close (pout[1]);
 
-    // Add executable as argv[0] and NULL-terminate the array for execvp().
-    char** argv = new char* [args.size () + 2];
-    argv[0] = (char*) executable.c_str ();
-    for (unsigned int i = 0; i < args.size (); ++i)
-      argv[i+1] = (char*) args[i].c_str ();
-
-    argv[args.size () + 1] = NULL;
-    _exit (execvp (executable.c_str (), argv));
+    _exit (execvp (executable.c_str (), &argv[0]));
   }
 
   // This is only reached in the parent
-  close (pin[0]);   // Close the read end of the input pipe.
-  close (pout[1]);  // Close the write end of the output pipe.
+  PipeGuard::release (pin[0]);   // Close the read end of the input pipe.
+  PipeGuard::release (pout[1]);  // Close the write end of the output pipe.
 
   if (input.size () == 0)
   {
     // Nothing to send to the child, close the pipe early.
-    close (pin[1]);
+    PipeGuard::release (pin[1]);
   }
 
   output = "";
@@ -337,7 +428,7 @@ int execute (
       throw std::string (std::strerror (errno));
 
     // Write data to child's STDIN
-    if (FD_ISSET (pin[1], &wfds))
+    if (pin[1] != -1 && FD_ISSET (pin[1], &wfds))
     {
       write_retval = write (pin[1], input_cstr + written, input.size () - written);
       if (write_retval == -1)
@@ -358,7 +449,7 @@ int execute (
       if (written == input.size ())
       {
         // Let the child know that no more input is coming by closing the pipe.
-        close (pin[1]);
+        PipeGuard::release (pin[1]);
       }
     }
 
@@ -374,10 +465,10 @@ int execute (
     }
   }
 
-  close (pout[0]);  // Close the read end of the output pipe.
+  PipeGuard::release (pout[0]);  // Close the read end of the output pipe.
 
   int status = -1;
-  if (wait (&status) == -1)
+  if (waitpid (pid, &status, 0) == -1)
     throw std::string (std::strerror (errno));
 
   if (WIFEXITED (status))
@@ -389,9 +480,6 @@ int execute (
     throw std::string ("Error: Could not get Hook exit status!");
   }
 
-  if (signal (SIGPIPE, SIG_DFL) == SIG_ERR)  // We're done, return to default.
-    throw std::string (std::strerror (errno));
-
   return status;
 }
 
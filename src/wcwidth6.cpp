@@ -122,6 +122,10 @@ static int bisearch(wchar_t ucs, const struct interval *table, int max) {
 
 int mk_wcwidth(wchar_t ucs)
 {
+  /* fast path for printable ASCII, by far the most common case */
+  if (ucs >= 0x20 && ucs < 0x7f)
+    return 1;
+
   /* sorted list of non-overlapping intervals of non-spacing characters */
   /* generated by "uniset +cat=Me +cat=Mn +cat=Cf -00AD +1160-11FF +200B c" */
   static const struct interval combining[] = {
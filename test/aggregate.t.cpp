@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <cmake.h>
+#include <stdlib.h>
+#include <Context.h>
+#include <Aggregate.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (16);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  std::vector <Task> tasks;
+  tasks.push_back (Task ("[description:\"1\" project:\"a.b.c\" status:\"pending\" tags:\"x,y\" entry:\"10\"]"));
+  tasks.push_back (Task ("[description:\"2\" project:\"a.b\" status:\"completed\" tags:\"x\" entry:\"20\"]"));
+  tasks.push_back (Task ("[description:\"3\" project:\"a\" status:\"deleted\" entry:\"30\"]"));
+  tasks.push_back (Task ("[description:\"4\" status:\"waiting\" tags:\"y\" entry:\"40\"]"));
+
+  // Projects, with values.
+  Aggregate projects (Aggregate::project, [] (const Task& task, double& value)
+  {
+    value = task.get_date ("entry");
+    return true;
+  });
+  projects.add (tasks);
+
+  auto groups = projects.groups ();
+  t.is ((int) groups.size (), 4, "project: 4 groups before roll-up");
+  t.is (groups["a.b.c"]._pending, 1, "project: a.b.c 1 pending");
+  t.is (groups[""]._waiting, 1, "project: '' 1 waiting");
+
+  projects.rollUpProjects ();
+  groups = projects.groups ();
+  t.is ((int) groups.size (), 4, "project: 4 groups after roll-up");
+  t.is (groups["a"]._count, 3, "project: a counts a, a.b, a.b.c once each");
+  t.is (groups["a"]._deleted, 1, "project: a 1 deleted");
+  t.is (groups["a"]._completed, 1, "project: a 1 completed");
+  t.is (groups["a.b"]._count, 2, "project: a.b 2");
+  t.is (groups["a"]._sum, 60.0, "project: a sum 10+20+30");
+  t.is (groups["a"]._min, 10.0, "project: a min 10");
+  t.is (groups["a"]._max, 30.0, "project: a max 30");
+
+  // Tags, merged from two halves.
+  Aggregate first (Aggregate::tags);
+  Aggregate second (Aggregate::tags);
+  for (unsigned int i = 0; i < tasks.size (); ++i)
+    (i < 2 ? first : second).add (tasks[i]);
+
+  first.merge (second);
+  groups = first.groups ();
+  t.is ((int) groups.size (), 2, "tags: 2 groups");
+  t.is (groups["x"]._count, 2, "tags: x 2");
+  t.is (groups["y"]._count, 2, "tags: y 2");
+  t.is (groups["y"]._values, 0, "tags: no values");
+
+  // Large enough to be accumulated in parallel chunks.
+  std::vector <Task> many;
+  for (int i = 0; i < 25000; ++i)
+    many.push_back (tasks[i % 4]);
+
+  Aggregate parallel (Aggregate::tags);
+  parallel.add (many);
+  t.is (parallel.groups ()["x"]._count, 12500, "tags: parallel x 12500");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
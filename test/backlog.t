@@ -81,6 +81,55 @@ class Test1510(TestCase):
         self.t("add test4 project:random")
         self.assertNoEmptyValueInBacklog('project')
 
+
+class TestBacklogCompaction(TestCase):
+    def setUp(self):
+        self.t = Task()
+
+    def backlog(self):
+        backlog_path = os.path.join(self.t.datadir, 'backlog.data')
+        with open(backlog_path) as backlog:
+            return [line for line in backlog.readlines() if line.strip()]
+
+    def test_backlog_keeps_every_change_by_default(self):
+        """Without rc.backlog.compact, every change is recorded"""
+        self.t('add one')
+        self.t('add two')
+        self.t('1 mod +tag')
+        self.t('1 mod pri:H')
+        self.assertEqual(len(self.backlog()), 4)
+
+    def test_backlog_compacted_on_change(self):
+        """With rc.backlog.compact, only the latest version of a task is kept"""
+        self.t.config('backlog.compact', 'yes')
+        self.t('add one')
+        self.t('add two')
+        self.t('1 mod +tag')
+        self.t('1 mod pri:H')
+
+        lines = self.backlog()
+        self.assertEqual(len(lines), 2)
+        self.assertIn('"description":"two"', lines[0])
+        self.assertIn('"priority":"H"', lines[1])
+        self.assertIn('"tags":["tag"]', lines[1])
+
+    def test_backlog_compaction_keeps_sync_key(self):
+        """Compaction keeps the sync key line in place"""
+        self.t('add one')
+        backlog_path = os.path.join(self.t.datadir, 'backlog.data')
+        with open(backlog_path, 'w') as backlog:
+            backlog.write('dc4e8f2e-0000-4000-8000-000000000000\n')
+
+        self.t.config('backlog.compact', 'yes')
+        self.t('1 mod +tag')
+        self.t('1 mod pri:H')
+
+        lines = self.backlog()
+        self.assertEqual(len(lines), 2)
+        self.assertEqual(lines[0], 'dc4e8f2e-0000-4000-8000-000000000000\n')
+        self.assertIn('"priority":"H"', lines[1])
+
+
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
     unittest.main(testRunner=TAPTestRunner())
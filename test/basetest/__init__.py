@@ -2,6 +2,7 @@
 
 from .task import Task
 from .taskd import Taskd
+from .loopback import LoopbackTaskd
 from .testing import TestCase, ServerTestCase
 
 # flake8:noqa
@@ -0,0 +1,238 @@
+# -*- coding: utf-8 -*-
+
+from __future__ import division, print_function
+import os
+import socket
+import ssl
+import struct
+import threading
+import time
+import uuid
+import zlib
+from collections import OrderedDict
+from .utils import find_unused_port, release_port, DEFAULT_CERT_PATH
+
+
+class LoopbackTaskd(object):
+    """A minimal in-process stand-in for taskd
+
+    Speaks the sync protocol over TLS on a local port, so that `task sync` can
+    be exercised end to end without a taskd binary. Tasks are merged naively
+    (last upload wins), which is enough to move data between clients.
+
+    Every exchange is recorded in `exchanges`, with the bytes on the wire in
+    each direction, the uncompressed payload sizes and the time spent serving
+    the request, so that sync performance can be measured.
+
+    Compression is offered to clients that ask for it, unless `compression`
+    is False.
+    """
+    def __init__(self, certpath=None, address="localhost", compression=True):
+        if certpath is None:
+            certpath = DEFAULT_CERT_PATH
+        self.certpath = certpath
+
+        # Same names as Taskd, for Task.bind_taskd_server. There is no CA
+        # because the bundled test certificates can no longer be validated.
+        self.ca_cert = None
+        self.server_cert = os.path.join(self.certpath, "server.cert.pem")
+        self.server_key = os.path.join(self.certpath, "server.key.pem")
+
+        self.address = address
+        self.port = find_unused_port(self.address)
+        self.compression = compression
+
+        self.users = {}
+        self.exchanges = []
+        self.default_user = self.create_user()
+
+        self._context = ssl.SSLContext(ssl.PROTOCOL_SSLv23)
+        self._context.load_cert_chain(self.server_cert, self.server_key)
+
+        self._socket = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        self._socket.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        self._socket.bind((self.address, self.port))
+        self._socket.listen(5)
+
+        self._thread = threading.Thread(target=self._serve)
+        self._thread.daemon = True
+        self._thread.start()
+
+    def __repr__(self):
+        txt = super(LoopbackTaskd, self).__repr__()
+        return "{0} listening on {1}:{2}>".format(txt[:-1], self.address,
+                                                 self.port)
+
+    def create_user(self, user=None, group="default_group",
+                    org="default_org"):
+        """Create a user and return the credentials to use in a task client
+        """
+        if user is None:
+            user = "test_user_{0}".format(len(self.users))
+
+        userkey = str(uuid.uuid4())
+        self.users[(org, user, userkey)] = []
+        return user, group, org, userkey
+
+    def store(self, user, tasks):
+        """Store tasks on the server for the given credentials, as if another
+        client had uploaded them. `tasks` is a list of JSON strings.
+        """
+        user, group, org, userkey = user
+        log = self.users[(org, user, userkey)]
+        log.extend(tasks)
+        log.append(str(uuid.uuid4()))
+
+    def reset_stats(self):
+        """Forget all recorded exchanges"""
+        del self.exchanges[:]
+
+    def destroy(self):
+        """Stop listening and release the port"""
+        try:
+            self._socket.close()
+        except socket.error:
+            pass
+
+        release_port(self.port)
+
+    def _serve(self):
+        while True:
+            try:
+                conn, _ = self._socket.accept()
+            except (socket.error, OSError):
+                # Listening socket closed by destroy()
+                return
+
+            try:
+                tls = self._context.wrap_socket(conn, server_side=True)
+                self._exchange(tls)
+
+                # The client waits for close_notify before exiting.
+                tls.unwrap()
+                tls.close()
+            except (socket.error, ssl.SSLError, OSError):
+                conn.close()
+
+    def _exchange(self, tls):
+        start = time.time()
+
+        data = self._recv(tls)
+        header, payload = self._parse(data)
+        request_size = len(payload)
+
+        code, status, payload = self._sync(header, payload)
+
+        response = OrderedDict([("client", "taskd loopback"),
+                                ("code", code),
+                                ("status", status)])
+        if self.compression:
+            response["accept-compression"] = "zlib"
+            if "zlib" in header.get("accept-compression", "").split(","):
+                response["compression"] = "zlib"
+
+        message = self._serialize(response, payload)
+
+        # Recorded before replying, so it is visible once the client exits.
+        self.exchanges.append({
+            "bytes_in": len(data) + 4,
+            "bytes_out": len(message) + 4,
+            "request_payload": request_size,
+            "response_payload": len(payload),
+            "request_compressed": "compression" in header,
+            "response_compressed": "compression" in response,
+            "seconds": time.time() - start,
+        })
+
+        tls.sendall(struct.pack(">I", len(message) + 4) + message)
+
+    def _recv(self, tls):
+        data = b""
+        while len(data) < 4:
+            chunk = tls.recv(4 - len(data))
+            if not chunk:
+                raise socket.error("Connection closed")
+            data += chunk
+
+        expected = struct.unpack(">I", data)[0] - 4
+        chunks = []
+        received = 0
+        while received < expected:
+            chunk = tls.recv(min(65536, expected - received))
+            if not chunk:
+                break
+            chunks.append(chunk)
+            received += len(chunk)
+
+        return b"".join(chunks)
+
+    def _parse(self, data):
+        head, _, payload = data.partition(b"\n\n")
+
+        header = {}
+        for line in head.decode("utf-8").split("\n"):
+            name, _, value = line.partition(":")
+            header[name.strip()] = value.strip()
+
+        if header.get("compression") == "zlib":
+            # Ignores the newline that follows the compressed stream
+            payload = zlib.decompressobj().decompress(payload)
+
+        return header, payload.decode("utf-8")
+
+    def _serialize(self, header, payload):
+        payload = payload.encode("utf-8")
+        if header.get("compression") == "zlib":
+            payload = zlib.compress(payload)
+
+        head = "".join("{0}: {1}\n".format(k, v) for k, v in header.items())
+        return head.encode("utf-8") + b"\n" + payload + b"\n"
+
+    def _sync(self, header, payload):
+        credentials = (header.get("org"), header.get("user"),
+                       header.get("key"))
+        if credentials not in self.users:
+            return "430", "Access denied", ""
+
+        log = self.users[credentials]
+
+        tasks = []
+        sync_key = None
+        for line in payload.split("\n"):
+            if line.startswith("{"):
+                tasks.append(line)
+            elif line:
+                sync_key = line
+
+        # Everything after the client's sync key is news to the client.
+        position = 0
+        if sync_key is not None:
+            if sync_key not in log:
+                return "500", "Client sync key not found.", ""
+            position = log.index(sync_key) + 1
+
+        news = OrderedDict()
+        for line in log[position:]:
+            if line.startswith("{"):
+                news[self._uuid(line)] = line
+
+        # The client's own changes supersede what it has not yet seen.
+        for line in tasks:
+            news.pop(self._uuid(line), None)
+
+        if not tasks and not news:
+            return "201", "No change", ""
+
+        new_key = str(uuid.uuid4())
+        log.extend(tasks)
+        log.append(new_key)
+
+        lines = list(news.values()) + [new_key]
+        return "200", "Ok", "\n".join(lines) + "\n"
+
+    @staticmethod
+    def _uuid(line):
+        start = line.find('"uuid":"') + 8
+        return line[start:start + 36]
+
+# vim: ai sts=4 et sw=4
@@ -98,7 +98,10 @@ class Task(object):
         key = os.path.join(self.taskd.certpath, "test_client.key.pem")
         self.config("taskd.certificate", cert)
         self.config("taskd.key", key)
-        self.config("taskd.ca", self.taskd.ca_cert)
+        if self.taskd.ca_cert is not None:
+            self.config("taskd.ca", self.taskd.ca_cert)
+        else:
+            self.config("taskd.trust", "allow all")
 
         address = ":".join((self.taskd.address, str(self.taskd.port)))
         self.config("taskd.server", address)
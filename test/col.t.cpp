@@ -27,6 +27,7 @@
 #include <cmake.h>
 #include <stdlib.h>
 #include <columns/ColID.h>
+#include <columns/ColDue.h>
 #include <main.h>
 #include <test.h>
 
@@ -35,7 +36,7 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest test (12);
+  UnitTest test (20);
 
   // Ensure environment has no influence.
   unsetenv ("TASKDATA");
@@ -76,6 +77,43 @@ int main (int, char**)
   test.is ((int)minimum, 6, "id:333333 --> ColID::measure minimum 6");
   test.is ((int)maximum, 6, "id:333333 --> ColID::measure maximum 6");
 
+  // Formatted dates are cached per format, and shared by renders.
+  context.config.set ("dateformat", "Y-M-D");
+  ColumnDue columnDue;
+  columnDue.setStyle ("formatted");
+  Task t2;
+  t2.set ("due", "1451606400");  // 2016-01-01T00:00:00Z
+  Color color;
+  std::vector <std::string> lines;
+  columnDue.render (lines, t2, 10, color);
+  test.is (lines.size () ? lines[0] : "", ISO8601d (1451606400).toString ("Y-M-D"), "ColDue::render formatted");
+
+  unsigned int cells = ColumnTypeDate::cachedCells ();
+  lines.clear ();
+  columnDue.render (lines, t2, 10, color);
+  test.is (lines.size () ? lines[0] : "", ISO8601d (1451606400).toString ("Y-M-D"), "ColDue::render formatted again");
+  test.is ((int) ColumnTypeDate::cachedCells (), (int) cells, "ColDue::render reuses the cached cell");
+
+  // A different format is picked up, and cached separately.
+  context.config.set ("dateformat", "D/M/Y");
+  lines.clear ();
+  columnDue.render (lines, t2, 10, color);
+  test.is (lines.size () ? lines[0] : "", ISO8601d (1451606400).toString ("D/M/Y"), "ColDue::render picks up a changed dateformat");
+  test.is ((int) ColumnTypeDate::cachedCells (), (int) cells + 1, "ColDue::render caches the new format");
+
+  context.config.set ("dateformat", "Y-M-D");
+  lines.clear ();
+  columnDue.render (lines, t2, 10, color);
+  test.is ((int) ColumnTypeDate::cachedCells (), (int) cells + 1, "ColDue::render reuses the first format's cell");
+
+  // Elapsed time is measured from the command's time snapshot, and not cached.
+  context.snapshot.now = 1451606400 + 3 * 86400;
+  columnDue.setStyle ("age");
+  lines.clear ();
+  columnDue.render (lines, t2, 10, color);
+  test.is (lines.size () ? Lexer::trimRight (lines[0]) : "", ISO8601p (3 * 86400).formatVague (), "ColDue::render age from the snapshot");
+  test.is ((int) ColumnTypeDate::cachedCells (), (int) cells + 1, "ColDue::render age caches no cell");
+
   return 0;
 }
 
@@ -28,6 +28,7 @@
 #include <iostream>
 #include <stdlib.h>
 #include <Context.h>
+#include <FS.h>
 #include <test.h>
 
 Context context;
@@ -35,7 +36,7 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (11);
+  UnitTest t (26);
 
   // Ensure environment has no influence.
   unsetenv ("TASKDATA");
@@ -81,6 +82,21 @@ int main (int, char**)
   c.set ("bool1", true);
   t.is (c.getBoolean ("bool1"), true, "Config::set/get bool");
 
+  // Key key (const std::string&);
+  // int/double/bool getInteger/getReal/getBoolean (Key);
+  Config::Key int1 = Config::key ("int1");
+  t.ok (int1 == Config::key ("int1"), "Config::key interns");
+  t.is (c.getInteger (int1), 1, "Config::getInteger (Key)");
+
+  c.set ("int1", 7);
+  t.is (c.getInteger (int1), 7, "Config::getInteger (Key) after set");
+
+  Config::Key bool1 = Config::key ("bool1");
+  t.is (c.getBoolean (bool1), true, "Config::getBoolean (Key)");
+
+  Config::Key double3 = Config::key ("double3");
+  t.is (c.getReal (double3), -9.0, "Config::getReal (Key)");
+
   // void all (std::vector <std::string>&);
   std::vector <std::string> all;
   c.all (all);
@@ -89,6 +105,53 @@ int main (int, char**)
   // 22 default report setting created in Config::Config.
   t.ok (all.size () >= 8, "Config::all");
 
+  // void load (const std::string&, int nest = 1);
+  // No image is kept unless asked for.
+  File::write ("config.t.rc", "str2=two\n");
+  Config plain;
+  plain.load ("config.t.rc");
+  t.notok (File ("config.t.rc.cache").exists (), "Config::load writes no image by default");
+
+  // A parsed image is kept beside the file, and used while it is current.
+  File::write ("config.t.rc", "config.cache=on\nstr2=two\n");
+  Config cold;
+  cold.load ("config.t.rc");
+  t.ok (File ("config.t.rc.cache").exists (), "Config::load writes an image");
+
+  Config warm;
+  warm.load ("config.t.rc");
+  t.is (warm.get ("str2"), "two", "Config::load reads the image");
+  t.ok (warm.size () == cold.size (), "Config::load image holds the defaults");
+
+  File::write ("config.t.rc", "config.cache=on\nstr2=Two\n");
+  Config changed;
+  changed.load ("config.t.rc");
+  t.is (changed.get ("str2"), "Two", "Config::load ignores a stale image");
+
+  // Derived data is kept in the image, until the configuration changes.
+  std::vector <std::string> derived {"one", "two"};
+  changed.setDerived ("test", derived);
+  changed.saveDerived ();
+
+  Config reread;
+  reread.load ("config.t.rc");
+  std::vector <std::string> found;
+  t.ok (reread.getDerived ("test", found), "Config::getDerived from the image");
+  t.ok (found == derived,                  "Config::getDerived from the image, same data");
+  t.notok (reread.getDerived ("none", found), "Config::getDerived unknown --> false");
+
+  File::write ("config.t.rc", "config.cache=on\nstr2=two\n");
+  Config edited;
+  edited.load ("config.t.rc");
+  t.notok (edited.getDerived ("test", found), "Config::getDerived after a change --> false");
+
+  File::write ("config.t.rc", "config.cache=off\n");
+  Config off;
+  off.load ("config.t.rc");
+  t.notok (File ("config.t.rc.cache").exists (), "Config::load removes the image when off");
+
+  File ("config.t.rc").remove ();
+
   // TODO Test includes
   // TODO Test included nesting limit
   // TODO Test included absolute vs relative
@@ -28,6 +28,7 @@
 
 import sys
 import os
+import json
 import unittest
 import datetime
 # Ensure python finds the local simpletap module
@@ -741,6 +742,39 @@ class TestRange(TestCase):
         self.assertNotIn("three", out)
 
 
+class TestIDSelection(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Task()
+        for description in ("one", "two", "three", "four", "five"):
+            self.t("add " + description)
+
+    def descriptions(self, args):
+        code, out, err = self.t(args + " export")
+        return [task["description"] for task in json.loads(out)]
+
+    def test_ids_in_order(self):
+        """Verify overlapping IDs and ranges select each task once, in order"""
+        self.assertEqual(self.descriptions("4,2-1,2"), ["one", "two", "four"])
+
+    def test_id_range_beyond_latest(self):
+        """Verify an ID range may extend past the latest ID"""
+        self.assertEqual(self.descriptions("4-100"), ["four", "five"])
+
+    def test_ids_and_uuids(self):
+        """Verify IDs and UUIDs combine"""
+        code, out, err = self.t("_get 5.uuid")
+        uuid = out.strip()
+        self.assertEqual(self.descriptions("3 " + uuid), ["three", "five"])
+
+    def test_completed_uuid(self):
+        """Verify a UUID selects a completed task"""
+        code, out, err = self.t("_get 2.uuid")
+        uuid = out.strip()
+        self.t("2 done")
+        self.assertEqual(self.descriptions(uuid), ["two"])
+
+
 class TestHasHasnt(TestCase):
     def setUp(self):
         """Executed before each test in the class"""
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <Context.h>
+#include <Filter.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (7);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  try
+  {
+    File::write ("./filter.rc", "data.location=.\nhooks=off\n");
+
+    const char* argv[] = {"task", "rc:./filter.rc", "+foo", "count"};
+    context.initialize (4, argv);
+
+    std::vector <Task> input;
+    input.push_back (Task ("[description:\"one\" tags:\"foo\" uuid:\"aaaaaaaa-0000-4000-8000-000000000001\"]"));
+    input.push_back (Task ("[description:\"two\" tags:\"foo,bar\" uuid:\"aaaaaaaa-0000-4000-8000-000000000002\"]"));
+    input.push_back (Task ("[description:\"three\" uuid:\"aaaaaaaa-0000-4000-8000-000000000003\"]"));
+
+    // The filter is compiled on first use, and then reused by every pass.
+    Filter filter;
+    Eval* compiled = filter.compiled ();
+    t.ok (compiled != NULL,                       "Filter::compiled +foo --> compiled");
+    t.ok (filter.compiled () == compiled,         "Filter::compiled again --> reused");
+    t.ok (Filter ().compiled () == compiled,      "Filter::compiled by another Filter --> reused");
+
+    std::vector <Task> output;
+    filter.subset (input, output);
+    t.is ((int) output.size (), 2,                "Filter::subset +foo --> 2 tasks");
+    t.ok (filter.compiled () == compiled,         "Filter::subset --> reused");
+
+    // Adding a filter analyzes the command line again, which discards the
+    // compiled filter.
+    context.cli2.addFilter ("+bar");
+    t.notok (context.cli2._filter_compiled,       "CLI2::addFilter --> recompile");
+
+    output.clear ();
+    filter.subset (input, output);
+    t.is ((int) output.size (), 1,                "Filter::subset +foo +bar --> 1 task");
+  }
+
+  catch (const std::string& error)
+  {
+    t.diag (error);
+    return -1;
+  }
+
+  unlink ("./filter.rc");
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <cmake.h>
+#include <stdlib.h>
+#include <Context.h>
+#include <Histogram.h>
+#include <ISO8601.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (24);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  // Period numbering.
+  ISO8601d date (3, 15, 2016, 12, 30, 0);        // Tuesday
+  t.is (Histogram::period (date.toEpoch (), 'Y'), 2016,          "period Y 2016-03-15 --> 2016");
+  t.is (Histogram::period (date.toEpoch (), 'M'), 2016 * 12 + 2, "period M 2016-03-15 --> 2016*12+2");
+  t.is (Histogram::period (date.toEpoch (), 'D'), 16875,         "period D 2016-03-15 --> 16875");
+  t.is (Histogram::period (date.toEpoch (), 'W'), 2411,          "period W 2016-03-15 --> 2411");
+
+  t.is ((int) Histogram::epoch (2016, 'Y'),           (int) date.startOfYear ().toEpoch (),  "epoch Y == startOfYear");
+  t.is ((int) Histogram::epoch (2016 * 12 + 2, 'M'),  (int) date.startOfMonth ().toEpoch (), "epoch M == startOfMonth");
+  t.is ((int) Histogram::epoch (16875, 'D'),          (int) date.startOfDay ().toEpoch (),   "epoch D == startOfDay");
+  t.is ((int) Histogram::epoch (2411, 'W'),           (int) date.startOfWeek ().toEpoch (),  "epoch W == startOfWeek");
+
+  t.is (Histogram::period (ISO8601d (1, 1, 1969).toEpoch (), 'W'), -52, "period W 1969-01-01 --> -52");
+  t.is (Histogram::period (ISO8601d (12, 31, 1969).toEpoch (), 'D'), -1, "period D 1969-12-31 --> -1");
+
+  time_t midnight = date.startOfDay ().toEpoch ();
+  t.is (Histogram::ceiling (midnight, 'D'),     16875, "ceiling D midnight --> same day");
+  t.is (Histogram::ceiling (midnight + 1, 'D'), 16876, "ceiling D midnight+1 --> next day");
+
+  // Intervals and events.
+  Histogram h ('D', 10, 19);
+  h.add (12, 15, 1);
+  h.add (14, 30, 2);
+  h.add (0, 11, 1);
+  h.add (17);
+  h.add (25);
+  h.resolve ();
+
+  t.is (h[9],  0, "[9]  out of range --> 0");
+  t.is (h[10], 1, "[10] clipped interval --> 1");
+  t.is (h[11], 0, "[11] --> 0");
+  t.is (h[12], 1, "[12] --> 1");
+  t.is (h[13], 1, "[13] --> 1");
+  t.is (h[14], 3, "[14] overlap --> 3");
+  t.is (h[15], 2, "[15] --> 2");
+  t.is (h[17], 3, "[17] event --> 3");
+  t.is (h[19], 2, "[19] clipped interval --> 2");
+  t.is (h[20], 0, "[20] out of range --> 0");
+
+  Histogram empty ('M', 1, 0);
+  empty.add (1, 5, 1);
+  empty.resolve ();
+  t.is (empty[1], 0, "empty range --> 0");
+  t.ok (empty.last () < empty.first (), "empty range last < first");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
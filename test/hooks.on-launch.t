@@ -104,6 +104,37 @@ class TestHooksOnLaunch(TestCase):
         logs = hook.get_logs()
         self.assertEqual(logs["output"]["msgs"][0], "FEEDBACK")
 
+    def test_onlaunch_parallel_feedback_order(self):
+        """on-launch hooks run concurrently, feedback in script order."""
+        # The first script finishes last, but its feedback comes first.
+        self.t.hooks.add("on-launch-1", "#!/bin/sh\nsleep 1\necho 'FIRST'\nexit 0\n")
+        self.t.hooks.add("on-launch-2", "#!/bin/sh\necho 'SECOND'\nexit 0\n")
+        self.t.hooks.add("on-launch-3", "#!/bin/sh\necho 'THIRD'\nexit 0\n")
+
+        code, out, err = self.t("version")
+        self.assertIn("Taskwarrior", out)
+        self.assertRegexpMatches(err, "FIRST\nSECOND\nTHIRD")
+
+    def test_onlaunch_parallel_failure(self):
+        """on-launch hooks run concurrently, first failure terminates."""
+        self.t.hooks.add("on-launch-1", "#!/bin/sh\necho 'FIRST'\nexit 0\n")
+        self.t.hooks.add("on-launch-2", "#!/bin/sh\necho 'SECOND'\nexit 1\n")
+        self.t.hooks.add("on-launch-3", "#!/bin/sh\necho 'THIRD'\nexit 1\n")
+
+        code, out, err = self.t.runError("version")
+        self.assertNotIn("Taskwarrior", out)
+        self.assertIn("SECOND", err)
+        self.assertNotIn("THIRD", err)
+
+    def test_onlaunch_sequential(self):
+        """on-launch hooks run one at a time with rc.hooks.parallel=1."""
+        self.t.config("hooks.parallel", "1")
+        self.t.hooks.add("on-launch-1", "#!/bin/sh\necho 'FIRST'\nexit 0\n")
+        self.t.hooks.add("on-launch-2", "#!/bin/sh\necho 'SECOND'\nexit 0\n")
+
+        code, out, err = self.t("version")
+        self.assertRegexpMatches(err, "FIRST\nSECOND")
+
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
     unittest.main(testRunner=TAPTestRunner())
@@ -72,9 +72,9 @@ void testParse (
 int main (int, char**)
 {
 #ifdef PRODUCT_TASKWARRIOR
-  UnitTest t (1025);
+  UnitTest t (1031);
 #else
-  UnitTest t (996);
+  UnitTest t (1002);
 #endif
 
   ISO8601d iso;
@@ -220,6 +220,14 @@ int main (int, char**)
   testParse (t, "20131206T123456Z",          16, 2013, 12,  0, 0,   0,  6,   hms,     0,  true, utc6+hms  );
   testParse (t, "20131206T123456",           15, 2013, 12,  0, 0,   0,  6,   hms,     0, false, local6+hms);
 
+  // Epoch and compact UTC boundaries, recognized without the grammar.
+  t.is ((int) ISO8601d ("1234567890").toEpoch (),       1234567890, "ISO8601d (\"1234567890\") --> 1234567890");
+  t.is ((int) ISO8601d ("315532800").toEpoch (),         315532800, "ISO8601d (\"315532800\") --> 315532800");
+  t.is ((int) ISO8601d ("20160229T235959Z").toEpoch (), 1456790399, "ISO8601d (\"20160229T235959Z\") --> 1456790399");
+  t.is ((int) ISO8601d ("20131206T240000Z").toEpoch (), 1386374400, "ISO8601d (\"20131206T240000Z\") --> 1386374400");
+  t.notok (ISO8601d::valid ("20130229T000000Z"),                    "ISO8601d::valid (\"20130229T000000Z\") --> false");
+  t.notok (ISO8601d::valid ("20131206T126000Z"),                    "ISO8601d::valid (\"20131206T126000Z\") --> false");
+
   try
   {
     ISO8601d now;
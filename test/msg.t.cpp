@@ -27,6 +27,7 @@
 #include <cmake.h>
 #include <Context.h>
 #include <Msg.h>
+#include <text.h>
 #include <test.h>
 
 Context context;
@@ -34,7 +35,11 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (13);
+#ifdef HAVE_LIBZ
+  UnitTest t (25);
+#else
+  UnitTest t (18);
+#endif
 
   Msg m;
   t.is (m.serialize (), std::string ("client: ") + PACKAGE_STRING + "\n\n\n", "Msg::serialize '' --> '\\n\\n'");
@@ -64,6 +69,88 @@ int main (int, char**)
   m3.all (vars);
   t.ok (vars.size () == 2,                                "Msg::all --> 2 vars");
 
+  // Compression.
+  t.notok (Msg::supports ("lzma"),                        "Msg::supports lzma --> false");
+
+  try
+  {
+    Msg m4;
+    m4.parse ("compression: lzma\n\npayload\n");
+    t.fail ("Msg::parse unsupported compression --> error");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("Msg::parse unsupported compression --> error");
+  }
+
+  try
+  {
+    Msg m4;
+    m4.set ("compression", "lzma");
+    m4.serialize ();
+    t.fail ("Msg::serialize unsupported compression --> error");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("Msg::serialize unsupported compression --> error");
+  }
+
+  std::string large;
+  for (int i = 0; i < 1000; ++i)
+    large += "{\"description\":\"Task " + format (i) + "\",\"status\":\"pending\"}\n";
+
+  Msg m5;
+  m5.set ("compression", "zlib");
+  m5.setPayload (large);
+
+#ifdef HAVE_LIBZ
+  std::string wire = m5.serialize ();
+  t.ok (Msg::supports ("zlib"),                           "Msg::supports zlib --> true");
+  t.ok (wire.length () < large.length () / 4,             "Msg::serialize compresses payload");
+  t.ok (wire.find ("compression: zlib\n") != std::string::npos, "Msg::serialize marks compressed payload");
+
+  Msg m6;
+  t.ok (m6.parse (wire),                                  "Msg::parse compressed ok");
+  t.is (m6.get ("compression"), "zlib",                   "Msg::get compression");
+  t.ok (m6.getPayload () == large,                        "Msg::getPayload decompressed");
+
+  Msg m8;
+  t.ok (m8.parse (wire, large.length ()),                 "Msg::parse compressed within limit ok");
+
+  try
+  {
+    Msg m9;
+    m9.parse (wire, 1000);
+    t.fail ("Msg::parse compressed beyond limit --> error");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("Msg::parse compressed beyond limit --> error");
+  }
+
+  try
+  {
+    Msg m7;
+    m7.parse ("compression: zlib\n\nnot compressed\n");
+    t.fail ("Msg::parse corrupt payload --> error");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("Msg::parse corrupt payload --> error");
+  }
+#else
+  t.notok (Msg::supports ("zlib"),                        "Msg::supports zlib --> false");
+  try
+  {
+    m5.serialize ();
+    t.fail ("Msg::serialize zlib unsupported --> error");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("Msg::serialize zlib unsupported --> error");
+  }
+#endif
+
   return 0;
 }
 
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <thread>
+#include <Context.h>
+#include <JSON.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (12);
+
+  // static Format parse (const std::string&);
+  t.ok (Profiler::parse ("")      == Profiler::none,  "Profiler::parse '' --> none");
+  t.ok (Profiler::parse ("off")   == Profiler::none,  "Profiler::parse off --> none");
+  t.ok (Profiler::parse ("json")  == Profiler::json,  "Profiler::parse json --> json");
+  t.ok (Profiler::parse ("trace") == Profiler::trace, "Profiler::parse trace --> trace");
+  t.ok (Profiler::parse ("tree")  == Profiler::tree,  "Profiler::parse tree --> tree");
+
+  // Nothing is recorded while disabled.
+  {
+    Profiler::Span span ("disabled");
+  }
+  t.notok (Profiler::enabled (), "Profiler::enabled false by default");
+
+  // Nested spans of the same name are combined per parent.
+  Profiler::enable (Profiler::tree);
+  t.ok (Profiler::enabled (), "Profiler::enabled true after enable");
+  {
+    Profiler::Span outer ("outer");
+    for (int i = 0; i < 3; ++i)
+      Profiler::Span inner ("inner");
+  }
+
+  std::string tree = Profiler::render ();
+  t.ok (tree.find ("disabled") == std::string::npos, "Profiler::render omits spans from before enable");
+  t.ok (tree.find ("  outer") != std::string::npos, "Profiler::render tree has outer");
+  t.ok (tree.find ("    inner                                      3 x") != std::string::npos,
+        "Profiler::render tree nests and counts inner");
+
+  // Each thread gets its own tree.
+  Profiler::enable (Profiler::json);
+  {
+    Profiler::Span span ("main");
+    std::thread worker ([] () { Profiler::Span span ("worker"); });
+    worker.join ();
+  }
+
+  json::value* root = json::parse (Profiler::render ());
+  t.ok (root != NULL, "Profiler::render json parses");
+  t.ok (root && ((json::array*)((json::object*)root)->_data["threads"])->_data.size () == 2,
+        "Profiler::render json has two threads");
+  delete root;
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <cmake.h>
+#include <cmake.h>
+#include <stdlib.h>
+#include <Context.h>
+#include <Recurrence.h>
+#include <ISO8601.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// Stepping one instance at a time is the reference for every jump.
+static bool stepsMatch (const std::string& period, const ISO8601d& start, long steps)
+{
+  Recurrence r (period);
+  ISO8601d i = start;
+  for (long k = 1; k <= steps; ++k)
+  {
+    i = r.next (i);
+    if (r.advance (start, k).toEpoch () != i.toEpoch () ||
+        r.count (start, i) != k + 1)
+      return false;
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (27);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  // Months are clamped to fit, and the clamped day carries forward.
+  ISO8601d jan31 (1, 31, 2016, 12, 30, 0);
+  Recurrence monthly ("monthly");
+  t.is (monthly.next (jan31).toISOLocalExtended (),       "2016-02-29T12:30:00", "monthly 2016-01-31 --> 2016-02-29");
+  t.is (monthly.advance (jan31, 3).toISOLocalExtended (), "2016-04-29T12:30:00", "monthly 2016-01-31 +3 --> 2016-04-29");
+  t.is (Recurrence ("5m").advance (jan31, 3).toISOLocalExtended (), "2017-04-30T12:30:00", "5m 2016-01-31 +3 --> 2017-04-30");
+  t.is (Recurrence ("P3M").next (jan31).toISOLocalExtended (),      "2016-04-30T12:30:00", "P3M 2016-01-31 --> 2016-04-30");
+  t.is (Recurrence ("P4M").next (jan31).toISOLocalExtended (),      "2016-05-31T12:30:00", "P4M 2016-01-31 --> 2016-05-31");
+  t.is (Recurrence ("2q").next (jan31).toISOLocalExtended (),       "2016-07-31T12:30:00", "2q 2016-01-31 --> 2016-07-31");
+
+  // Years, from a leap day.
+  ISO8601d feb29 (2, 29, 2016, 9, 0, 0);
+  t.is (Recurrence ("annual").next (feb29).toISOLocalExtended (),       "2017-02-28T09:00:00", "annual 2016-02-29 --> 2017-02-28");
+  t.is (Recurrence ("annual").advance (feb29, 4).toISOLocalExtended (), "2020-02-28T09:00:00", "annual 2016-02-29 +4 --> 2020-02-28");
+  t.is (Recurrence ("biannual").next (feb29).toISOLocalExtended (),     "2018-03-01T09:00:00", "biannual 2016-02-29 --> 2018-03-01");
+  t.is (Recurrence ("P2Y").advance (feb29, 3).toISOLocalExtended (),    "2022-03-01T09:00:00", "P2Y 2016-02-29 +3 --> 2022-03-01");
+
+  // Weekdays skip the weekend.
+  ISO8601d friday (3, 18, 2016, 10, 0, 0);
+  ISO8601d wednesday (3, 16, 2016, 10, 0, 0);
+  Recurrence weekdays ("weekdays");
+  t.is (weekdays.next (friday).toISOLocalExtended (),         "2016-03-21T10:00:00", "weekdays Fri --> Mon");
+  t.is (weekdays.advance (wednesday, 7).toISOLocalExtended (), "2016-03-25T10:00:00", "weekdays Wed +7 --> Fri");
+  t.is (weekdays.advance (friday, 10).toISOLocalExtended (),   "2016-04-01T10:00:00", "weekdays Fri +10 --> Fri");
+
+  // Counting instances.
+  ISO8601d start (1, 1, 2016, 12, 0, 0);
+  Recurrence daily ("daily");
+  t.is ((int) daily.count (start, ISO8601d (1, 10, 2016, 12, 0, 0)), 10, "daily count to the 10th instance --> 10");
+  t.is ((int) daily.count (start, ISO8601d (1, 10, 2016, 11, 0, 0)),  9, "daily count to just before the 10th instance --> 9");
+  t.is ((int) daily.count (start, ISO8601d (12, 31, 2015)),           0, "daily count before start --> 0");
+  t.is ((int) monthly.count (start, ISO8601d (1, 1, 2116, 12, 0, 0)), 1201, "monthly count over a century --> 1201");
+
+  // Degenerate periods.
+  t.ok    (daily.advances (),              "daily advances");
+  t.notok (Recurrence ("0d").advances (),  "0d does not advance");
+  t.notok (Recurrence ("0m").advances (),  "0m does not advance");
+
+  try
+  {
+    Recurrence ("foo").next (start);
+    t.fail ("foo --> error");
+  }
+  catch (...)
+  {
+    t.pass ("foo --> error");
+  }
+
+  // Jumps agree with steps.
+  t.ok (stepsMatch ("monthly",  jan31,     600), "monthly advance == next^k");
+  t.ok (stepsMatch ("7m",       jan31,     600), "7m advance == next^k");
+  t.ok (stepsMatch ("annual",   feb29,     200), "annual advance == next^k");
+  t.ok (stepsMatch ("biannual", feb29,     200), "biannual advance == next^k");
+  t.ok (stepsMatch ("weekdays", wednesday, 600), "weekdays advance == next^k");
+  t.ok (stepsMatch ("3d",       start,     600), "3d advance == next^k");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
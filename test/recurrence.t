@@ -29,6 +29,7 @@
 import sys
 import os
 import re
+import time
 import unittest
 # Ensure python finds the local simpletap module
 sys.path.append(os.path.dirname(os.path.abspath(__file__)))
@@ -650,6 +651,45 @@ class TestBugAnnual(TestCase):
         self.assertIn("17 20150101", out)
 
 
+class TestRecurrenceWatermark(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Task()
+        self.t.config("recurrence.limit", "1")
+        self.t("add foo due:tomorrow recur:daily")
+
+    def age(self):
+        """Backdate the data files, as if the last change were a while ago"""
+        past = time.time() - 60
+        for name in os.listdir(self.t.datadir):
+            os.utime(os.path.join(self.t.datadir, name), (past, past))
+
+    def settle(self):
+        """Generate the instances, then scan again with nothing to do"""
+        self.age()
+        self.t("list")
+        self.age()
+        self.t("list")
+
+    def test_watermark_recorded(self):
+        """A scan that changes nothing records when the next one is due"""
+        self.settle()
+        with open(os.path.join(self.t.datadir, "recurrence.data")) as f:
+            watermark = int(f.read().split()[-1])
+
+        self.assertGreater(watermark, time.time())
+
+    def test_watermark_recurrence_limit(self):
+        """A watermark does not apply to a different recurrence.limit"""
+        self.settle()
+        code, out, err = self.t("count status:pending")
+        self.assertEqual("1\n", out)
+
+        self.t("rc.recurrence.limit:3 list")
+        code, out, err = self.t("count status:pending")
+        self.assertEqual("3\n", out)
+
+
 # TODO Wait a recurring task
 # TODO Downgrade a recurring task to a regular task
 # TODO Duplicate a recurring child task
@@ -0,0 +1,106 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <iostream>
+#include <stdlib.h>
+#include <Context.h>
+#include <Command.h>
+#include <Column.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+// Commands and columns are registered under names and types given separately
+// from their constructors.  Every registration must agree with the object it
+// builds, or parsing and completion go wrong before the object is ever used.
+int main (int, char**)
+{
+  UnitTest t (6);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  try
+  {
+    context.config.setDefaults ();
+    context.config.set ("uda.estimate.type", "duration");
+    context.config.set ("uda.estimate.label", "Est");
+
+    // Iterating a registry constructs every registered object.
+    Registry <Command> commands;
+    Command::factory (commands);
+    int mismatches = 0;
+    for (auto i = commands.begin (); i != commands.end (); ++i)
+    {
+      if (i->second->keyword () != i->first)
+      {
+        t.diag ("Command '" + i->first + "' has keyword '" + i->second->keyword () + "'");
+        ++mismatches;
+      }
+    }
+
+    t.ok (commands.size () > 0,                            "Command::factory registers commands");
+    t.is (mismatches, 0,                                   "Command::factory names match keywords");
+
+    Registry <Column> columns;
+    std::map <std::string, std::string> types;
+    Column::factory (columns, types);
+    int badNames = 0;
+    int badTypes = 0;
+    for (auto i = columns.begin (); i != columns.end (); ++i)
+    {
+      if (i->second->name () != i->first)
+      {
+        t.diag ("Column '" + i->first + "' has name '" + i->second->name () + "'");
+        ++badNames;
+      }
+
+      if (i->second->type () != types[i->first])
+      {
+        t.diag ("Column '" + i->first + "' has type '" + i->second->type () + "', registered as '" + types[i->first] + "'");
+        ++badTypes;
+      }
+    }
+
+    t.ok (types.size () == columns.size (),                "Column::factory records a type for every column");
+    t.is (badNames, 0,                                     "Column::factory names match columns");
+    t.is (badTypes, 0,                                     "Column::factory types match columns");
+    t.is (types["estimate"], "duration",                   "Column::factory registers UDA types");
+  }
+
+  catch (const std::string& error)
+  {
+    t.diag (error);
+    return -1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
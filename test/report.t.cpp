@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <Context.h>
+#include <FS.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (6);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  try
+  {
+    Directory ("./report.t.d").create ();
+    File::write ("./report.t.rc", "data.location=./report.t.d\n"
+                                  "hooks=off\n"
+                                  "gc=off\n"
+                                  "config.cache=on\n"
+                                  "report.mine.columns=id,description\n"
+                                  "report.mine.labels=ID,Desc\n"
+                                  "report.mine.sort=description+/\n"
+                                  "report.mine.filter=status:pending +foo\n");
+
+    const char* argv[] = {"task", "rc:./report.t.rc", "mine"};
+    context.initialize (3, argv);
+
+    // The compiled report is recorded with the configuration it came from.
+    Command* mine = context.commands["mine"];
+    std::string output;
+    mine->execute (output);
+
+    std::vector <std::string> compiled;
+    t.ok (context.config.getDerived ("report.mine", compiled), "CmdCustom::execute compiles the report");
+    t.ok (compiled.size () > 4          &&
+          compiled[0] == "id,description" &&
+          compiled[3] == "status:pending +foo",               "CmdCustom::execute compiles the current definition");
+
+    // It is kept in the configuration image, for later commands.
+    context.config.saveDerived ();
+    Config later;
+    later.load ("./report.t.rc");
+    std::vector <std::string> kept;
+    t.ok (later.getDerived ("report.mine", kept) && kept == compiled,
+                                                              "CmdCustom::execute report kept in the image");
+
+    // A changed definition is compiled again.
+    context.config.set ("report.mine.columns", "id,description.count");
+    mine->execute (output);
+    context.config.getDerived ("report.mine", compiled);
+    t.is (compiled.size () ? compiled[0] : "", "id,description.count",
+                                                              "CmdCustom::execute recompiles a changed report");
+
+    // And still validated.
+    context.config.set ("report.mine.labels", "ID");
+    try
+    {
+      mine->execute (output);
+      t.fail ("CmdCustom::execute mismatched labels --> error");
+    }
+    catch (const std::string&)
+    {
+      t.pass ("CmdCustom::execute mismatched labels --> error");
+    }
+
+    context.config.set ("report.mine.labels", "ID,Desc");
+    mine->execute (output);
+    context.config.getDerived ("report.mine", compiled);
+    t.is (compiled.size () > 1 ? compiled[1] : "", "ID,Desc",   "CmdCustom::execute recompiles a corrected report");
+  }
+
+  catch (const std::string& error)
+  {
+    t.diag (error);
+  }
+
+  unlink ("./report.t.rc");
+  unlink ("./report.t.rc.cache");
+  Directory ("./report.t.d").remove ();
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,166 @@
+#!/usr/bin/env python2.7
+# -*- coding: utf-8 -*-
+###############################################################################
+#
+# Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# http://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+
+import sys
+import os
+import json
+import unittest
+import uuid
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Task, LoopbackTaskd, TestCase
+
+
+def make_tasks(count, uuids=None, description="Synchronized task"):
+    """JSON for `count` pending tasks, suitable for `task import`"""
+    if uuids is None:
+        uuids = [str(uuid.uuid4()) for i in range(count)]
+
+    return json.dumps([{"uuid": uuids[i],
+                        "description": "{0} {1}".format(description, i),
+                        "project": "Sync.Project{0}".format(i % 10),
+                        "tags": ["one", "two"],
+                        "status": "pending",
+                        "entry": "20160101T000000Z"} for i in range(count)])
+
+
+class TestLoopbackSync(TestCase):
+    """Sync between two clients through the loopback taskd stand-in"""
+    @classmethod
+    def setUpClass(cls):
+        cls.taskd = LoopbackTaskd()
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.taskd.destroy()
+
+    def setUp(self):
+        # A fresh account per test, shared by both clients.
+        self.user = self.taskd.create_user()
+        self.t1 = Task(taskd=self.taskd)
+        self.t1.set_taskd_user(self.user)
+        self.t2 = Task(taskd=self.taskd)
+        self.t2.set_taskd_user(self.user)
+        self.taskd.reset_stats()
+
+    def test_sync_between_clients(self):
+        """Tasks and modifications travel between clients"""
+        self.t1("add one")
+        self.t1("sync")
+        self.t2("sync")
+
+        code, out, err = self.t2("_get 1.description")
+        self.assertEqual("one\n", out)
+
+        self.t2("1 modify +foo")
+        self.t2("sync")
+        self.t1("sync")
+
+        code, out, err = self.t1("_get 1.tags")
+        self.assertEqual("foo\n", out)
+
+    def test_sync_no_change(self):
+        """A sync with nothing to exchange changes nothing"""
+        self.t1("add one")
+        self.t1("sync")
+        code, out, err = self.t1("sync")
+        self.assertIn("No changes", err)
+
+    def test_large_merge(self):
+        """Large batches of additions and modifications are merged"""
+        uuids = [str(uuid.uuid4()) for i in range(2500)]
+        self.t1("import", input=make_tasks(2500, uuids))
+        self.t1("sync")
+
+        modified = json.loads(make_tasks(2500, uuids, "Modified task"))
+        self.taskd.store(self.user, [json.dumps(task, separators=(",", ":"))
+                                     for task in modified])
+
+        code, out, err = self.t1("sync")
+        self.assertIn("2500 changes", err)
+
+        code, out, err = self.t1("count description.startswith:Modified")
+        self.assertEqual("2500\n", out)
+        code, out, err = self.t1("count")
+        self.assertEqual("2500\n", out)
+
+        # A fresh client receives only the latest version of each task.
+        self.t2("sync")
+        code, out, err = self.t2("count description.startswith:Modified")
+        self.assertEqual("2500\n", out)
+
+    def test_compressed_response(self):
+        """Large downloads are compressed on request"""
+        self.t1("import", input=make_tasks(2000))
+        self.t1("sync")
+        self.t2("sync")
+
+        exchange = self.taskd.exchanges[-1]
+        self.assertTrue(exchange["response_compressed"])
+        self.assertLess(exchange["bytes_out"], exchange["response_payload"] / 4)
+
+        code, out, err = self.t2("count")
+        self.assertEqual("2000\n", out)
+
+    def test_uncompressed_response(self):
+        """Compression is not used when disabled"""
+        self.t2.config("taskd.compression", "no")
+        self.t1("import", input=make_tasks(100))
+        self.t1("sync")
+        self.t2("sync")
+
+        exchange = self.taskd.exchanges[-1]
+        self.assertFalse(exchange["response_compressed"])
+        self.assertGreater(exchange["bytes_out"], exchange["response_payload"])
+
+        code, out, err = self.t2("count")
+        self.assertEqual("100\n", out)
+
+    def test_compressed_upload(self):
+        """Uploads are compressed when configured"""
+        self.t1.config("taskd.compression.upload", "yes")
+        self.t1("import", input=make_tasks(2000))
+        self.t1("sync")
+
+        exchange = self.taskd.exchanges[-1]
+        self.assertTrue(exchange["request_compressed"])
+        self.assertLess(exchange["bytes_in"], exchange["request_payload"] / 4)
+
+        self.t2("sync")
+        code, out, err = self.t2("count")
+        self.assertEqual("2000\n", out)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+    unittest.main(testRunner=TAPTestRunner())
+
+# vim: ai sts=4 et sw=4
@@ -34,7 +34,7 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest test (49);
+  UnitTest test (66);
 
   // Ensure environment has no influence.
   unsetenv ("TASKDATA");
@@ -252,6 +252,46 @@ TODO Task::decode
   test.is (t7.composeF4 (), "[description:\"DESC\" entry:\"1370212800\" tags:\"tag1,tag2\"]", "F4 good");
   test.is (t7.composeJSON (), "{\"description\":\"DESC\",\"entry\":\"20130602T224000Z\",\"tags\":[\"tag1\",\"tag2\"]}", "JSON good");
 
+  // Concrete tags are split once, and again after a change.
+  Task t8;
+  t8.set ("tags", "tag1,tag2");
+  test.ok    (t8.hasTag ("tag1"),      "hasTag tag1 --> true");
+  test.notok (t8.hasTag ("tag3"),      "hasTag tag3 --> false");
+  test.is    (t8.getTagCount (), 2,    "getTagCount --> 2");
+
+  t8.removeTag ("tag1");
+  test.notok (t8.hasTag ("tag1"),      "removeTag tag1, hasTag tag1 --> false");
+  t8.addTag ("tag3");
+  test.ok    (t8.hasTag ("tag3"),      "addTag tag3, hasTag tag3 --> true");
+  test.is    (t8.getTagCount (), 2,    "addTag tag3, getTagCount --> 2");
+
+  // Virtual tags are cached, and forgotten when the task changes.
+  t8.setStatus (Task::pending);
+  t8.set ("due", "1000000000");
+  test.ok    (t8.hasTag ("PENDING"),   "hasTag PENDING --> true");
+  test.ok    (t8.hasTag ("OVERDUE"),   "hasTag OVERDUE --> true");
+  test.notok (t8.hasTag ("COMPLETED"), "hasTag COMPLETED --> false");
+
+  t8.setStatus (Task::completed);
+  test.notok (t8.hasTag ("PENDING"),   "setStatus completed, hasTag PENDING --> false");
+  test.ok    (t8.hasTag ("COMPLETED"), "setStatus completed, hasTag COMPLETED --> true");
+
+  // READY depends on whether other tasks block this one, so it is not cached.
+  Task t9;
+  t9.setStatus (Task::pending);
+  test.ok    (t9.hasTag ("READY"),     "hasTag READY --> true");
+  t9.is_blocked = true;
+  test.notok (t9.hasTag ("READY"),     "blocked, hasTag READY --> false");
+  test.ok    (t9.hasTag ("BLOCKED"),   "blocked, hasTag BLOCKED --> true");
+  t9.is_blocked = false;
+  test.ok    (t9.hasTag ("READY"),     "unblocked, hasTag READY --> true");
+
+  // A copy holds its own split tags.
+  Task t10 (t8);
+  t10.removeTag ("tag3");
+  test.notok (t10.hasTag ("tag3"),      "copy, removeTag tag3, hasTag tag3 --> false");
+  test.ok    (t8.hasTag ("tag3"),       "original, hasTag tag3 --> true");
+
   return 0;
 }
 
@@ -36,7 +36,7 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (12);
+  UnitTest t (17);
 
   // Ensure environment has no influence.
   unsetenv ("TASKDATA");
@@ -101,6 +101,22 @@ int main (int, char**)
     context.tdb2.clear ();
     context.tdb2.set_location (".");
 
+    // Compacting the backlog keeps the latest entry for each task, in order,
+    // and every line that is not a task.
+    std::string first  = "{\"description\":\"one\",\"uuid\":\"aaaaaaaa-0000-4000-8000-000000000001\"}";
+    std::string other  = "{\"description\":\"two\",\"uuid\":\"aaaaaaaa-0000-4000-8000-000000000002\"}";
+    std::string key    = "bbbbbbbb-0000-4000-8000-000000000003";
+    std::string latest = "{\"description\":\"three\",\"uuid\":\"aaaaaaaa-0000-4000-8000-000000000001\"}";
+    File::write ("./backlog.data", first + "\n" + key + "\n" + other + "\n" + latest + "\n");
+
+    t.is (context.tdb2.compact_backlog (), 1, "TDB2::compact_backlog removed 1 entry");
+
+    File::read ("./backlog.data", backlog);
+    t.is ((int) backlog.size (), 3, "TDB2::compact_backlog kept 3 lines");
+    t.is (backlog.size () > 0 ? backlog[0] : "", key,    "TDB2::compact_backlog kept the key line");
+    t.is (backlog.size () > 1 ? backlog[1] : "", other,  "TDB2::compact_backlog kept the other task");
+    t.is (backlog.size () > 2 ? backlog[2] : "", latest, "TDB2::compact_backlog kept the latest entry");
+
     // TODO commit
     // TODO complete a task
     // TODO gc
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <stdlib.h>
+#include <time.h>
+#include <Context.h>
+#include <TimeSnapshot.h>
+#include <ISO8601.h>
+#include <Task.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (22);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  try
+  {
+    context.config.setDefaults ();
+    context.config.set ("due", 4);
+
+    TimeSnapshot& snapshot = context.snapshot;
+    int revision = snapshot.revision;
+    snapshot.take (context.config.getInteger ("due"));
+    t.is (snapshot.revision, revision + 1,                  "TimeSnapshot::take increments revision");
+    t.ok (snapshot.now <= time (NULL),                      "TimeSnapshot::take now");
+
+    // The local time agrees with the C library.
+    struct tm expected;
+    localtime_r (&snapshot.now, &expected);
+    t.ok (snapshot.local.tm_year == expected.tm_year &&
+          snapshot.local.tm_yday == expected.tm_yday &&
+          snapshot.local.tm_wday == expected.tm_wday,        "TimeSnapshot::take local date");
+    t.ok (snapshot.local.tm_hour == expected.tm_hour &&
+          snapshot.local.tm_min  == expected.tm_min  &&
+          snapshot.local.tm_sec  == expected.tm_sec,         "TimeSnapshot::take local time");
+    t.is (snapshot.year, expected.tm_year + 1900,           "TimeSnapshot::take year");
+
+    // Today starts at local midnight.
+    struct tm midnight = expected;
+    midnight.tm_hour = midnight.tm_min = midnight.tm_sec = 0;
+    midnight.tm_isdst = -1;
+    t.ok (snapshot.today.toEpoch () == mktime (&midnight),  "TimeSnapshot::take today is local midnight");
+
+    // The named dates match their parsed equivalents.
+    t.ok (snapshot.today     == ISO8601d ("today"),         "TimeSnapshot::take today == 'today'");
+    t.ok (snapshot.yesterday == ISO8601d ("yesterday"),     "TimeSnapshot::take yesterday == 'yesterday'");
+    t.ok (snapshot.tomorrow  == ISO8601d ("tomorrow"),      "TimeSnapshot::take tomorrow == 'tomorrow'");
+    t.ok (snapshot.socw      == ISO8601d ("socw"),          "TimeSnapshot::take socw == 'socw'");
+    t.ok (snapshot.eocw      == ISO8601d ("eocw"),          "TimeSnapshot::take eocw == 'eocw'");
+    t.ok (snapshot.socm      == ISO8601d ("socm"),          "TimeSnapshot::take socm == 'socm'");
+    t.ok (snapshot.eocm      == ISO8601d ("eocm"),          "TimeSnapshot::take eocm == 'eocm'");
+    t.ok (ISO8601d ("now").toEpoch () == snapshot.now,     "TimeSnapshot::take now == 'now'");
+
+    // The imminent period is rc.due days from the start of today.
+    t.is (snapshot.imminent, 4,                             "TimeSnapshot::take imminent == rc.due");
+    t.ok (snapshot.imminentDay == ISO8601d ("today") + 4 * 86400,
+                                                            "TimeSnapshot::take imminentDay == today + rc.due");
+
+    // Task date states are judged against the snapshot.
+    Task task;
+    task.set ("due", (int) snapshot.imminentDay.toEpoch () - 60);
+    t.ok (task.getDateState ("due") == Task::dateAfterToday, "Task::getDateState before imminentDay --> dateAfterToday");
+
+    task.set ("due", (int) snapshot.imminentDay.toEpoch () + 60);
+    t.ok (task.getDateState ("due") == Task::dateNotDue,     "Task::getDateState after imminentDay --> dateNotDue");
+
+    task.set ("due", (int) snapshot.today.toEpoch () - 60);
+    t.ok (task.getDateState ("due") == Task::dateBeforeToday, "Task::getDateState before today --> dateBeforeToday");
+
+    // A new snapshot picks up a changed period.
+    context.config.set ("due", 0);
+    snapshot.take (context.config.getInteger ("due"));
+    t.is (snapshot.revision, revision + 2,                  "TimeSnapshot::take again increments revision");
+    t.ok (snapshot.imminentDay == snapshot.today,           "TimeSnapshot::take rc.due=0 --> imminentDay == today");
+
+    task.set ("due", (int) snapshot.tomorrow.toEpoch () + 60);
+    t.ok (task.getDateState ("due") == Task::dateAfterToday, "Task::getDateState rc.due=0 --> dateAfterToday");
+  }
+
+  catch (const std::string& error)
+  {
+    t.diag (error);
+    return -1;
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2006 - 2016, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// http://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+#include <cmake.h>
+#include <stdlib.h>
+#include <time.h>
+#include <Context.h>
+#include <TimeZone.h>
+#include <ISO8601.h>
+#include <test.h>
+
+Context context;
+
+////////////////////////////////////////////////////////////////////////////////
+static bool same (const struct tm& left, const struct tm& right)
+{
+  return left.tm_year  == right.tm_year  &&
+         left.tm_mon   == right.tm_mon   &&
+         left.tm_mday  == right.tm_mday  &&
+         left.tm_hour  == right.tm_hour  &&
+         left.tm_min   == right.tm_min   &&
+         left.tm_sec   == right.tm_sec   &&
+         left.tm_wday  == right.tm_wday  &&
+         left.tm_yday  == right.tm_yday  &&
+         left.tm_isdst == right.tm_isdst;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static time_t reference (int y, int m, int d, int hour, int minute, int second)
+{
+  struct tm t {};
+  t.tm_isdst = -1;
+  t.tm_year  = y - 1900;
+  t.tm_mon   = m - 1;
+  t.tm_mday  = d;
+  t.tm_hour  = hour;
+  t.tm_min   = minute;
+  t.tm_sec   = second;
+  return mktime (&t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (16);
+
+  // Ensure environment has no influence.
+  unsetenv ("TASKDATA");
+  unsetenv ("TASKRC");
+
+  // A zone with summer time, that does not depend on installed zoneinfo.
+  // 2016-03-13 02:00 is skipped and 2016-11-06 01:00-01:59 is repeated.
+  setenv ("TZ", "EST5EDT,M3.2.0,M11.1.0", 1);
+  tzset ();
+
+  // Every quarter hour of 2016, and a stretch before the epoch.
+  int mismatches = 0;
+  for (time_t when = 1451606400; when < 1483228800; when += 900)
+  {
+    struct tm expected;
+    struct tm actual;
+    localtime_r (&when, &expected);
+    TimeZone::toLocal (when, actual);
+    if (! same (expected, actual))
+      ++mismatches;
+  }
+  t.is (mismatches, 0, "toLocal == localtime_r, 2016 every 15 minutes");
+
+  mismatches = 0;
+  for (time_t when = -86400 * 400; when < 0; when += 3599)
+  {
+    struct tm expected;
+    struct tm actual;
+    localtime_r (&when, &expected);
+    TimeZone::toLocal (when, actual);
+    if (! same (expected, actual))
+      ++mismatches;
+  }
+  t.is (mismatches, 0, "toLocal == localtime_r, 1968-1969");
+
+  // Transitions, to the second.
+  struct tm local;
+  TimeZone::toLocal (1457852399, local);
+  t.is (local.tm_hour, 1, "toLocal 2016-03-13 06:59:59Z --> 01:59:59 EST");
+  TimeZone::toLocal (1457852400, local);
+  t.is (local.tm_hour, 3, "toLocal 2016-03-13 07:00:00Z --> 03:00:00 EDT");
+  t.is (local.tm_isdst, 1, "toLocal 2016-03-13 07:00:00Z --> isdst");
+  TimeZone::toLocal (1478411999, local);
+  t.is (local.tm_hour, 1, "toLocal 2016-11-06 05:59:59Z --> 01:59:59 EDT");
+  TimeZone::toLocal (1478412000, local);
+  t.is (local.tm_hour, 1, "toLocal 2016-11-06 06:00:00Z --> 01:00:00 EST");
+  t.is (local.tm_isdst, 0, "toLocal 2016-11-06 06:00:00Z --> !isdst");
+
+  // Every local half hour of 2016 that exists exactly once.
+  mismatches = 0;
+  for (int day = 0; day < 366; ++day)
+    for (int minutes = 0; minutes < 1440; minutes += 30)
+      if (! (day == 310 && minutes >= 60 && minutes < 120))
+        if (TimeZone::fromLocal (2016, 1, day + 1, minutes / 60, minutes % 60, 0) !=
+            reference (2016, 1, day + 1, minutes / 60, minutes % 60, 0))
+          ++mismatches;
+  t.is (mismatches, 0, "fromLocal == mktime, 2016 every 30 minutes");
+
+  t.is ((int) TimeZone::fromLocal (2016, 3, 13, 3, 0, 0), 1457852400, "fromLocal 2016-03-13 03:00 --> 07:00Z");
+  t.is ((int) TimeZone::fromLocal (2016, 3, 13, 1, 59, 59), 1457852399, "fromLocal 2016-03-13 01:59:59 --> 06:59:59Z");
+
+  // Normalization, as mktime.
+  t.is ((int) TimeZone::fromLocal (2016, 14, 1, 0, 0, 0),  (int) reference (2017, 2, 1, 0, 0, 0),   "fromLocal 2016-14-01 --> 2017-02-01");
+  t.is ((int) TimeZone::fromLocal (2016, 0, 31, 0, 0, 0),  (int) reference (2015, 12, 31, 0, 0, 0), "fromLocal 2016-00-31 --> 2015-12-31");
+  t.is ((int) TimeZone::fromLocal (2016, 2, 30, 25, 0, 0), (int) reference (2016, 3, 2, 1, 0, 0),   "fromLocal 2016-02-30 25:00 --> 2016-03-02 01:00");
+
+  // The civil calendar.
+  t.is (TimeZone::daysFromCivil (1970, 1, 1), 0, "daysFromCivil 1970-01-01 --> 0");
+  t.is (TimeZone::daysFromCivil (2016, 3, 15), 16875, "daysFromCivil 2016-03-15 --> 16875");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
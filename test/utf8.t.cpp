@@ -31,7 +31,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (33);
+  UnitTest t (41);
 
   std::string ascii_text            = "This is a test";
   std::string utf8_text             = "más sábado miércoles";
@@ -41,6 +41,9 @@ int main (int, char**)
   std::string utf8_text_color       = "más [1msábado[0m miércoles";
   std::string utf8_wide_text_color  = "改[1m变各种[0m颜色";
 
+  // Long enough to cross the 16 and 32 byte boundaries of the bulk ASCII scan.
+  std::string long_text             = "Review the quarterly budget with the team, then más detalles 改变 and\ttabs";
+
   // unsigned int utf8_codepoint (const std::string&);
   t.is ((int) utf8_codepoint ("\\u0020"),              32, "\\u0020 --> ' '");
   t.is ((int) utf8_codepoint ("U+0020"),               32, "U+0020 --> ' '");
@@ -49,15 +52,22 @@ int main (int, char**)
   // TODO std::string utf8_character (unsigned int);
   // TODO int utf8_sequence (unsigned int);
 
+  // unsigned int utf8_ascii_run (const std::string&, std::string::size_type);
+  t.is ((int) utf8_ascii_run (long_text, 0),            49, "utf8_ascii_run stops at first non-ASCII");
+  t.is ((int) utf8_ascii_run (long_text, 51),           11, "utf8_ascii_run from offset");
+  t.is ((int) utf8_ascii_run (long_text, 200),           0, "utf8_ascii_run beyond end");
+
   // unsigned int utf8_length (const std::string&);
   t.is ((int) utf8_length (ascii_text),                14, "ASCII utf8_length");
   t.is ((int) utf8_length (utf8_text),                 20, "UTF8 utf8_length");
   t.is ((int) utf8_length (utf8_wide_text),             6, "UTF8 wide utf8_length");
+  t.is ((int) utf8_length (long_text),                 72, "Long utf8_length");
 
   // unsigned int utf8_width (const std::string&);
   t.is ((int) utf8_width (ascii_text),                 14, "ASCII utf8_width");
   t.is ((int) utf8_width (utf8_text),                  20, "UTF8 utf8_width");
   t.is ((int) utf8_width (utf8_wide_text),             12, "UTF8 wide utf8_width");
+  t.is ((int) utf8_width (long_text),                  73, "Long utf8_width");
 
   // unsigned int utf8_text_length (const std::string&);
   t.is ((int) utf8_text_length (ascii_text_color),     14, "ASCII utf8_text_length");
@@ -73,6 +83,9 @@ int main (int, char**)
   t.is (utf8_substr (ascii_text, 0, 2),                    "Th", "ASCII utf8_substr");
   t.is (utf8_substr (utf8_text, 0, 2),                     "má", "UTF8 utf8_substr");
   t.is (utf8_substr (utf8_wide_text, 0, 2),                "改变", "UTF8 wide utf8_substr");
+  t.is (utf8_substr (long_text, 48, 4),                    "más ", "Long utf8_substr");
+  t.is (utf8_substr (long_text, 61, 4),                    "改变 a", "Long utf8_substr wide");
+  t.is (utf8_substr (long_text, 67),                       "\ttabs", "Long utf8_substr to end");
 
   // int mk_wcwidth (wchar_t);
   t.is (mk_wcwidth ('a'),                               1, "mk_wcwidth U+0061 --> 1");
@@ -37,7 +37,7 @@ Context context;
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (81);
+  UnitTest t (103);
 
   try
   {
@@ -244,6 +244,72 @@ int main (int, char**)
     v55.cast (Variant::type_duration);
     t.ok (v55.type () == Variant::type_duration, "cast duration --> duration");
     t.ok (v55.get_duration () == 12345,          "cast duration --> duration");
+
+    // Precast strings remain strings, but cast to the precast result.
+    Variant v60 ("2015-01-01");
+    v60.precast (Variant::type_date);
+    t.ok (v60.type () == Variant::type_string,  "precast string --> date remains string");
+    Variant v61 (v60);
+    v61.cast (Variant::type_date);
+    t.ok (v61.type () == Variant::type_date,    "precast string --> date");
+    Variant v62 ("2015-01-01");
+    v62.cast (Variant::type_date);
+    t.ok (v61.get_date () == v62.get_date (),   "precast string --> date");
+    t.ok (v60 == Variant ("2015-01-01"),        "precast string == string");
+
+    Variant v63 ("P1D");
+    v63.precast (Variant::type_duration);
+    v63.cast (Variant::type_duration);
+    t.ok (v63.type () == Variant::type_duration, "precast string --> duration");
+    t.ok (v63.get_duration () == 86400,          "precast string --> duration");
+
+    // Modifying a precast string discards the precast result.
+    Variant v64 ("P1D");
+    v64.precast (Variant::type_duration);
+    v64 += Variant ("x");
+    v64.cast (Variant::type_duration);
+    t.ok (v64.get_duration () == 0,              "precast string modified --> duration");
+
+    // Precasting a non-string does nothing.
+    Variant v65 (42);
+    v65.precast (Variant::type_date);
+    t.ok (v65.type () == Variant::type_integer,  "precast integer --> integer");
+
+    // Comparing against a precast string agrees with comparing against the
+    // same string uncast, in either order.
+    Variant v66 ("2015-01-01");
+    Variant v67 ("2015-01-01");
+    v67.precast (Variant::type_date);
+    Variant v68 ((time_t) 1400000000, Variant::type_date);
+    t.ok ((v68 < v67)  == (v68 < v66),           "date < precast string");
+    t.ok ((v67 > v68)  == (v66 > v68),           "precast string > date");
+    t.ok ((v68 <= v67) == (v68 <= v66),          "date <= precast string");
+    t.ok ((v67 >= v68) == (v66 >= v68),          "precast string >= date");
+    t.ok ((v68 == v67) == (v68 == v66),          "date == precast string");
+    t.ok (v62 == v67 && v67 == v62,              "date == precast string, same value");
+
+    // A trivial date compares false, as it does against an uncast string.
+    Variant v69 ((time_t) 0, Variant::type_date);
+    t.notok (v69 < v67,                          "trivial date < precast string --> false");
+    t.notok (v67 > v69,                          "precast string > trivial date --> false");
+    t.notok (v69 == v67,                         "trivial date == precast string --> false");
+
+    // A trivial duration still compares equal, but not less or greater.
+    Variant v70 ("PT0S");
+    v70.precast (Variant::type_duration);
+    Variant v71 ((time_t) 0, Variant::type_duration);
+    Variant v73 ("P1D");
+    v73.precast (Variant::type_duration);
+    Variant v74 ((time_t) 3600, Variant::type_duration);
+    t.ok (v71 == v70,                            "trivial duration == precast string --> true");
+    t.notok (v71 < v73,                          "trivial duration < precast string --> false");
+    t.ok (v74 < v73,                             "duration < precast string");
+
+    // An empty string is not precast, and so stays trivial.
+    Variant v72 ("''");
+    v72.precast (Variant::type_date);
+    t.notok (v68 < v72,                          "date < empty string --> false");
+    t.notok (v72 == v68,                         "empty string == date --> false");
   }
 
   catch (const std::string& e)